@@ -0,0 +1,402 @@
+/**
+ * @file bench_ipc.cpp
+ * @brief Shell ↔ Module IPC 벤치마크 (헤드리스, 개발 PC용)
+ *
+ * 1) 코덱 처리량: encodeFrame / decodeFrame / FrameReader / 타입 encode<Msg>
+ * 2) 왕복 지연: ModuleBridge → QLocalSocket → ShellClient(별도 스레드) → ModuleBridge
+ *      ping  : ModuleBridge::sendGearState        (Shell → Module, 1 byte)
+ *      reply : ShellClient::requestGearChange     (payload 0)
+ *              ShellClient::sendSettingsChanged   (레지스트리 외 키, payload N bytes 패딩)
+ *    메시지 속도(100 Hz ~ 10 kHz) × reply payload 크기마다 p50/p99/p99.9 와
+ *    log2 히스토그램을 출력하고 TC-PERF-002 예산(기본 50 ms)과 비교한다.
+ * 3) 전송 비교: 같은 왕복 측정을 스트림 소켓과 SOCK_SEQPACKET(recvmmsg/sendmmsg)으로
+ *    각각 돌리고 마지막에 나란히 요약한다.
+ *
+ * 사용법:
+ *   hu_bench_ipc [--rates 100,1000,5000,10000] [--sizes 0,64,1024,16384]
+ *                [--duration-ms 2000] [--budget-ms 50] [--quick]
+ *                [--transports stream,seqpacket]
+ * 종료 코드: 예산 초과 또는 응답 유실이 있으면 1
+ */
+
+#include "ModuleBridge.h"
+#include "ShellClient.h"
+#include "ShellProtocol.h"
+#include "FrameReader.h"
+
+#include <QBuffer>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QThread>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+qint64 nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        Clock::now().time_since_epoch()).count();
+}
+
+volatile quint64 g_sink = 0; // 최적화로 루프가 사라지지 않도록
+
+// ── 지연 샘플 ─────────────────────────────────────────────────────────
+
+struct LatencySamples {
+    std::vector<qint64> ns;
+
+    void sort() { std::sort(ns.begin(), ns.end()); }
+
+    double percentileUs(double p) const
+    {
+        if (ns.empty()) return 0.0;
+        const size_t idx = std::min(ns.size() - 1, static_cast<size_t>(p * (ns.size() - 1) + 0.5));
+        return ns[idx] / 1000.0;
+    }
+
+    double maxUs() const { return ns.empty() ? 0.0 : ns.back() / 1000.0; }
+
+    /** 8 µs부터 2배씩 커지는 버킷으로 분포 출력 */
+    void printHistogram() const
+    {
+        constexpr int kBuckets = 14; // 8 µs … 33 ms, 마지막 버킷은 그 이상
+        int counts[kBuckets] = {};
+        for (qint64 v : ns) {
+            int b = 0;
+            qint64 edge = 8000;
+            while (b < kBuckets - 1 && v >= edge) {
+                edge <<= 1;
+                ++b;
+            }
+            ++counts[b];
+        }
+        qint64 edge = 8000;
+        for (int b = 0; b < kBuckets; ++b, edge <<= 1) {
+            if (!counts[b]) continue;
+            const int bar = static_cast<int>(40.0 * counts[b] / ns.size() + 0.5);
+            if (b == kBuckets - 1)
+                std::printf("      >= %7.0f us %8d %s\n", (edge >> 1) / 1000.0, counts[b],
+                            std::string(bar, '#').c_str());
+            else
+                std::printf("      <  %7.0f us %8d %s\n", edge / 1000.0, counts[b],
+                            std::string(bar, '#').c_str());
+        }
+    }
+};
+
+// ── 1) 코덱 처리량 ────────────────────────────────────────────────────
+
+void printRate(const char *what, int payload, int iterations, qint64 elapsedNs)
+{
+    const double perFrameNs = double(elapsedNs) / iterations;
+    const double mbPerSec   = (double(payload + HuProtocol::HEADER_SIZE) * iterations)
+                              / (elapsedNs / 1e9) / (1024.0 * 1024.0);
+    std::printf("  %-22s %7d B  %10.1f ns/frame  %10.1f MiB/s\n",
+                what, payload, perFrameNs, mbPerSec);
+}
+
+void benchCodec(int payload)
+{
+    const int iterations = qBound(1000, (64 * 1024 * 1024) / (payload + HuProtocol::HEADER_SIZE), 200000);
+    const QByteArray body(payload, 'x');
+
+    // encodeFrame — 프레임마다 QByteArray + QDataStream
+    QByteArray stream;
+    stream.reserve((payload + HuProtocol::HEADER_SIZE) * iterations);
+    qint64 t0 = nowNs();
+    for (int i = 0; i < iterations; ++i)
+        stream.append(HuProtocol::encodeFrame(HuProtocol::MsgType::SettingsChanged, body));
+    printRate("encodeFrame", payload, iterations, nowNs() - t0);
+
+    // decodeFrame — 같은 프레임을 반복 파싱 (payload 복사 포함)
+    const QByteArray one = HuProtocol::encodeFrame(HuProtocol::MsgType::SettingsChanged, body);
+    HuProtocol::MsgType type;
+    QByteArray out;
+    int consumed = 0;
+    t0 = nowNs();
+    for (int i = 0; i < iterations; ++i) {
+        HuProtocol::decodeFrame(one, type, out, consumed);
+        g_sink += static_cast<quint64>(out.size() + consumed);
+    }
+    printRate("decodeFrame", payload, iterations, nowNs() - t0);
+
+    // FrameReader — 실제 수신 경로 (QIODevice → 링버퍼 → FrameView)
+    QBuffer device(&stream);
+    device.open(QIODevice::ReadOnly);
+    HuProtocol::FrameReader reader;
+    int frames = 0;
+    t0 = nowNs();
+    while (reader.readFrom(&device) > 0) {
+        HuProtocol::FrameView f;
+        while (reader.next(f)) {
+            g_sink += static_cast<quint64>(f.size);
+            ++frames;
+        }
+    }
+    printRate("FrameReader::next", payload, qMax(frames, 1), nowNs() - t0);
+}
+
+template <typename Msg>
+void benchTyped(const char *what, const Msg &msg)
+{
+    constexpr int iterations = 1000000;
+    qint64 t0 = nowNs();
+    for (int i = 0; i < iterations; ++i) {
+        const auto frame = HuProtocol::encode(msg);
+        g_sink += static_cast<quint8>(frame.data()[frame.size() - 1]);
+    }
+    printRate(what, static_cast<int>(Msg::kWireSize), iterations, nowNs() - t0);
+
+    const auto frame = HuProtocol::encode(msg);
+    HuProtocol::FrameView view;
+    view.type = Msg::kType;
+    view.data = frame.data() + HuProtocol::HEADER_SIZE;
+    view.size = static_cast<int>(Msg::kWireSize);
+    Msg decoded;
+    t0 = nowNs();
+    for (int i = 0; i < iterations; ++i) {
+        HuProtocol::decode(view, decoded);
+        g_sink += reinterpret_cast<const quint8 *>(&decoded)[0];
+    }
+    printRate("  decode", static_cast<int>(Msg::kWireSize), iterations, nowNs() - t0);
+}
+
+// ── 2) 왕복 지연 ──────────────────────────────────────────────────────
+
+struct RoundTripResult {
+    LatencySamples samples;
+    int sent = 0;
+    int lost = 0;
+};
+
+class RoundTripBench
+{
+public:
+    RoundTripBench(const QString &socketPath, HuProtocol::Transport transport)
+        : m_bridge(socketPath)
+        , m_client(new ShellClient(socketPath))
+        , m_transport(transport)
+    {
+        m_bridge.setHiddenPolicy(ModuleBridge::DeliveryPolicy::Immediate);
+        m_client->setTransport(transport);
+
+        // 모듈 측 echo — ShellClient 스레드에서 실행된다
+        QObject::connect(m_client, &ShellClient::gearStateUpdated, m_client, [this](GearState g) {
+            const int size = m_replySize.load();
+            if (size == 0)
+                m_client->requestGearChange(g, QStringLiteral("touch"));
+            else
+                m_client->sendSettingsChanged({{QStringLiteral("pad"), QByteArray(size, 'p')}});
+        });
+
+        QObject::connect(&m_bridge, &ModuleBridge::gearChangeRequested,
+                         [this](GearState, const QString &) { onReply(); });
+        QObject::connect(&m_bridge, &ModuleBridge::extensionSettingsChanged,
+                         [this](const QVariantMap &) { onReply(); });
+
+        m_client->moveToThread(&m_clientThread);
+        QObject::connect(&m_clientThread, &QThread::finished, m_client, &QObject::deleteLater);
+    }
+
+    ~RoundTripBench()
+    {
+        m_clientThread.quit();
+        m_clientThread.wait();
+    }
+
+    bool start()
+    {
+        if (!m_bridge.listen(m_transport))
+            return false;
+        m_clientThread.start();
+        QMetaObject::invokeMethod(m_client, [this] { m_client->connectToShell(); });
+
+        const qint64 deadline = nowNs() + 3000000000LL;
+        while (!m_bridge.isModuleConnected() && nowNs() < deadline)
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+        if (!m_bridge.isModuleConnected() || m_bridge.activeTransport() != m_transport)
+            return false;
+        m_bridge.sendShow(QRect(0, 0, 1, 1)); // 표시 상태 — 텔레메트리 즉시 전송
+        return true;
+    }
+
+    RoundTripResult run(int rateHz, int replySize, int durationMs)
+    {
+        m_replySize = replySize;
+        m_inFlight.clear();
+        m_result = RoundTripResult();
+
+        const qint64 periodNs  = 1000000000LL / rateHz;
+        const qint64 begin     = nowNs();
+        const qint64 warmupEnd = begin + qMin<qint64>(200, durationMs / 5) * 1000000LL;
+        const qint64 end       = begin + qint64(durationMs) * 1000000LL;
+        m_warmupEnd = warmupEnd;
+
+        // 고정 스케줄로 송신 — 지연이 생겨도 다음 송신 시각은 밀리지 않는다 (open loop)
+        qint64 next = begin;
+        while (nowNs() < end) {
+            while (nowNs() >= next && next < end) {
+                m_inFlight.push_back(nowNs());
+                m_bridge.sendGearState(static_cast<GearState>(m_result.sent % 4));
+                ++m_result.sent;
+                next += periodNs;
+            }
+            QCoreApplication::processEvents(QEventLoop::AllEvents);
+        }
+
+        const qint64 drainDeadline = nowNs() + 1000000000LL;
+        while (!m_inFlight.empty() && nowNs() < drainDeadline)
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+
+        m_result.lost = static_cast<int>(m_inFlight.size());
+        m_result.samples.sort();
+        return m_result;
+    }
+
+private:
+    void onReply()
+    {
+        // 소켓 양방향 모두 순서가 보장되므로 응답은 송신 순서대로 도착한다
+        if (m_inFlight.empty()) return;
+        const qint64 sentAt = m_inFlight.front();
+        m_inFlight.pop_front();
+        if (sentAt >= m_warmupEnd)
+            m_result.samples.ns.push_back(nowNs() - sentAt);
+    }
+
+    ModuleBridge          m_bridge;
+    ShellClient          *m_client;
+    HuProtocol::Transport m_transport;
+    QThread               m_clientThread;
+    std::atomic<int>    m_replySize{0};
+    std::deque<qint64>  m_inFlight;
+    qint64              m_warmupEnd = 0;
+    RoundTripResult     m_result;
+};
+
+struct SummaryRow {
+    int    rate = 0;
+    int    size = 0;
+    double p50  = 0.0;
+    double p99  = 0.0;
+};
+
+const char *transportName(HuProtocol::Transport t)
+{
+    return t == HuProtocol::Transport::SeqPacket ? "seqpacket" : "stream";
+}
+
+QList<int> parseIntList(const QString &text)
+{
+    QList<int> values;
+    for (const QString &part : text.split(',')) {
+        bool ok = false;
+        const int v = part.trimmed().toInt(&ok);
+        if (ok && v >= 0) values << v;
+    }
+    return values;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("hu_bench_ipc");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Shell <-> Module IPC benchmark (codec throughput + round-trip latency)");
+    parser.addHelpOption();
+    QCommandLineOption ratesOpt("rates", "Message rates in Hz (comma separated).", "list", "100,1000,5000,10000");
+    QCommandLineOption sizesOpt("sizes", "Reply payload sizes in bytes (comma separated).", "list", "0,64,1024,16384");
+    QCommandLineOption durationOpt("duration-ms", "Measurement time per rate/size pair.", "ms", "2000");
+    QCommandLineOption budgetOpt("budget-ms", "Round-trip budget (TC-PERF-002).", "ms", "50");
+    QCommandLineOption quickOpt("quick", "Short run: 300 ms per pair, codec sizes 0/1024 only.");
+    QCommandLineOption transportsOpt("transports", "Transports to compare (stream, seqpacket).", "list", "stream,seqpacket");
+    parser.addOptions({ratesOpt, sizesOpt, durationOpt, budgetOpt, quickOpt, transportsOpt});
+    parser.process(app);
+
+    const bool quick        = parser.isSet(quickOpt);
+    const QList<int> rates  = parseIntList(parser.value(ratesOpt));
+    const QList<int> sizes  = parseIntList(parser.value(sizesOpt));
+    const int durationMs    = quick ? 300 : qMax(100, parser.value(durationOpt).toInt());
+    const double budgetUs   = parser.value(budgetOpt).toDouble() * 1000.0;
+
+    std::printf("== codec throughput ==\n");
+    const QList<int> codecSizes = quick ? QList<int>{0, 1024}
+                                        : QList<int>{0, 16, 256, 4096, 65536};
+    for (int size : codecSizes)
+        benchCodec(size);
+    benchTyped("encode<GearStateUpdate>", HuProtocol::GearStateUpdateMsg{ 3 });
+    benchTyped("encode<BatteryUpdate>",   HuProtocol::BatteryUpdateMsg{ 12.1f, 87.5f });
+    benchTyped("encode<ShowModule>",      HuProtocol::ShowModuleMsg{ 0, 60, 1024, 480 });
+
+    QList<HuProtocol::Transport> transports;
+    for (const QString &name : parser.value(transportsOpt).split(',')) {
+        const QString t = name.trimmed().toLower();
+        if (t == QStringLiteral("stream"))    transports << HuProtocol::Transport::Stream;
+        if (t == QStringLiteral("seqpacket")) transports << HuProtocol::Transport::SeqPacket;
+    }
+
+    bool withinBudget = true;
+    QList<QList<SummaryRow>> summary;
+    for (HuProtocol::Transport transport : transports) {
+        std::printf("\n== round trip ModuleBridge -> ShellClient -> ModuleBridge (%s) ==\n",
+                    transportName(transport));
+        const QString socketPath = QDir::temp().filePath(
+            QStringLiteral("hu_bench_ipc_%1_%2.sock")
+                .arg(QCoreApplication::applicationPid()).arg(transportName(transport)));
+        RoundTripBench bench(socketPath, transport);
+        if (!bench.start()) {
+            std::fprintf(stderr, "failed to connect ShellClient to ModuleBridge on %s (%s)\n",
+                         qPrintable(socketPath), transportName(transport));
+            return 2;
+        }
+
+        QList<SummaryRow> rows;
+        for (int size : sizes) {
+            for (int rate : rates) {
+                if (rate <= 0) continue;
+                const RoundTripResult r = bench.run(rate, size, durationMs);
+                const double p999 = r.samples.percentileUs(0.999);
+                const bool pass = r.lost == 0 && !r.samples.ns.empty() && p999 <= budgetUs;
+                withinBudget = withinBudget && pass;
+                std::printf("  rate %5d Hz  reply %6d B  n=%-6zu lost=%-4d "
+                            "p50 %8.1f us  p99 %8.1f us  p99.9 %8.1f us  max %8.1f us  %s\n",
+                            rate, size, r.samples.ns.size(), r.lost,
+                            r.samples.percentileUs(0.50), r.samples.percentileUs(0.99),
+                            p999, r.samples.maxUs(), pass ? "PASS" : "FAIL");
+                r.samples.printHistogram();
+                rows << SummaryRow{ rate, size, r.samples.percentileUs(0.50),
+                                    r.samples.percentileUs(0.99) };
+            }
+        }
+        summary << rows;
+    }
+
+    if (summary.size() == 2) {
+        std::printf("\n== transport comparison (p50 / p99, us) ==\n");
+        std::printf("  %7s %8s   %21s   %21s\n", "rate", "reply",
+                    transportName(transports[0]), transportName(transports[1]));
+        for (int i = 0; i < summary[0].size() && i < summary[1].size(); ++i) {
+            const SummaryRow &a = summary[0][i];
+            const SummaryRow &b = summary[1][i];
+            std::printf("  %5d Hz %6d B   %9.1f / %9.1f   %9.1f / %9.1f\n",
+                        a.rate, a.size, a.p50, a.p99, b.p50, b.p99);
+        }
+    }
+
+    std::printf("\nTC-PERF-002 (p99.9 <= %.0f ms, no lost replies): %s\n",
+                budgetUs / 1000.0, withinBudget ? "PASS" : "FAIL");
+    return withinBudget ? 0 : 1;
+}
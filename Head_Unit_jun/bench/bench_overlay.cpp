@@ -0,0 +1,204 @@
+/**
+ * @file bench_overlay.cpp
+ * @brief PDC overlay 렌더링 벤치마크 — 캐시 없는 전체 그리기 / layer 캐시 전체 그리기 / dirty rect
+ *
+ * ReverseCameraWindow::paintEvent와 같은 순서로 오프스크린 QImage(640x400)에 그린다:
+ *   배경(카메라 frame 대신 placeholder 이미지) → PdcOverlayPainter::paint
+ * 세 모드를 같은 상태 열(센서 4개가 다가왔다 멀어지는 합성 패턴 + stale / fault 구간)로 돌린다.
+ *   full-uncached  매번 전체 영역, 가이드 라인을 QPainterPath로 직접 그림 (이전 방식)
+ *   full-cached    매번 전체 영역, 가이드 라인은 tint별 layer blit
+ *   dirty          changedRects()의 사각형마다 clip해서 배경 + overlay를 다시 그림 (update(rect) 경로)
+ * dirty 모드의 결과는 주기적으로 같은 상태의 전체 그리기와 픽셀 단위로 비교한다.
+ *
+ * 사용법:
+ *   hu_bench_overlay [--frames 5000] [--width 640] [--height 400]
+ * 종료 코드: dirty rect 결과가 전체 그리기와 한 픽셀이라도 다르면 1
+ */
+
+#include "PdcOverlayPainter.h"
+#include "PdcWarning.h"
+#include "LatencyHistogram.h"
+
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QImage>
+#include <QLinearGradient>
+#include <QPainter>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+/** 20 ms 주기 CAN 프레임을 흉내 낸 상태 열 — 거리는 1 cm 단위로 양자화 */
+std::vector<PdcState> makeStates(int count)
+{
+    std::vector<PdcState> states;
+    states.reserve(static_cast<size_t>(count));
+    quint32 rng = 2024;
+    for (int n = 0; n < count; ++n) {
+        PdcState state;
+        state.active = true;
+        state.stale = (n % 500) >= 480;   // 10 s마다 0.4 s 끊김
+        if (!state.stale) {
+            for (int i = 0; i < kPdcSensorCount; ++i) {
+                rng = rng * 1664525u + 1013904223u;
+                const double phase = n * 0.004 + i * 0.7;
+                const float noise = static_cast<float>((rng >> 16) % 5) - 2.0f;
+                state.rear.distanceCm[i] = std::round(110.0f + 95.0f * static_cast<float>(std::sin(phase)) + noise);
+                state.rear.setValid(i, state.rear.distanceCm[i] >= 0.0f && !(i == 3 && n % 1200 < 100));
+            }
+            state.nearestDistanceCm = PdcWarning::nearestCm(state.rear);
+            state.warningLevel = PdcWarning::levelForDistance(state.nearestDistanceCm);
+        }
+        if (n % 1200 < 100)
+            std::strncpy(state.fault.data(), "rear_right: no echo", state.fault.size() - 1);
+        states.push_back(state);
+    }
+    return states;
+}
+
+QImage makeBackground(const QSize &size)
+{
+    QImage image(size, QImage::Format_RGB32);
+    QPainter p(&image);
+    QLinearGradient grad(0, 0, size.width(), size.height());
+    grad.setColorAt(0, QColor(15, 18, 22));
+    grad.setColorAt(0.5, QColor(25, 30, 35));
+    grad.setColorAt(1, QColor(12, 15, 18));
+    p.fillRect(image.rect(), grad);
+    p.setPen(Qt::NoPen);
+    p.setBrush(QColor(40, 45, 50));
+    p.drawRect(0, size.height() - 60, size.width(), 60);
+    return image;
+}
+
+void paintFull(QImage *canvas, const QImage &background, PdcOverlayPainter *overlay, const PdcState &state)
+{
+    QPainter p(canvas);
+    p.drawImage(0, 0, background);
+    overlay->paint(&p, canvas->rect(), state);
+}
+
+/** ReverseCameraWindow::setPdcState → paintEvent와 같다 — 사각형마다 clip, 배경 복사 후 overlay (QRegion 없음) */
+void paintRects(QImage *canvas, const QImage &background, PdcOverlayPainter *overlay,
+                const PdcState &state, const PdcOverlayPainter::ChangedRects &rects, int count)
+{
+    QPainter p(canvas);
+    for (int i = 0; i < count; ++i) {
+        const QRect &r = rects[i];
+        p.setClipRect(r);
+        p.drawImage(r, background, r);
+        overlay->paint(&p, canvas->rect(), state, r);
+    }
+}
+
+void printResult(const char *name, const HuProtocol::LatencyHistogram &hist, quint64 frames)
+{
+    std::printf("  %-14s painted %6llu / %llu, mean %7.1f us, p50 <= %5llu us, p99 <= %5llu us, max %7.1f us\n",
+                name, static_cast<unsigned long long>(hist.count()), static_cast<unsigned long long>(frames),
+                hist.meanUs(), static_cast<unsigned long long>(hist.percentileUs(0.5)),
+                static_cast<unsigned long long>(hist.percentileUs(0.99)), hist.maxNs() / 1e3);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    // 디스플레이 없이 — QPixmap / 글꼴은 offscreen 플랫폼으로
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QGuiApplication app(argc, argv);
+    app.setApplicationName("hu_bench_overlay");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("PDC overlay render-time benchmark");
+    parser.addHelpOption();
+    QCommandLineOption framesOpt("frames", "Number of PDC state updates.", "n", "5000");
+    QCommandLineOption widthOpt("width", "Canvas width.", "px", "640");
+    QCommandLineOption heightOpt("height", "Canvas height.", "px", "400");
+    parser.addOptions({framesOpt, widthOpt, heightOpt});
+    parser.process(app);
+
+    const int frames = qMax(1, parser.value(framesOpt).toInt());
+    const QSize size(qMax(160, parser.value(widthOpt).toInt()), qMax(120, parser.value(heightOpt).toInt()));
+    const std::vector<PdcState> states = makeStates(frames);
+    const QImage background = makeBackground(size);
+    QImage canvas(size, QImage::Format_ARGB32_Premultiplied);
+    QElapsedTimer timer;
+
+    // ── 전체 그리기: 캐시 없음 / layer 캐시 ──
+    HuProtocol::LatencyHistogram uncached;
+    HuProtocol::LatencyHistogram cached;
+    PdcOverlayPainter overlay;
+    for (int pass = 0; pass < 2; ++pass) {
+        overlay.setLayerCacheEnabled(pass == 1);
+        HuProtocol::LatencyHistogram &hist = pass == 0 ? uncached : cached;
+        paintFull(&canvas, background, &overlay, states.front());   // 워밍업 (layer 생성 포함)
+        for (const PdcState &state : states) {
+            timer.start();
+            paintFull(&canvas, background, &overlay, state);
+            hist.add(static_cast<quint64>(timer.nsecsElapsed()));
+        }
+    }
+
+    // ── dirty rects: 이전 상태와 비교해 바뀐 사각형만 ──
+    HuProtocol::LatencyHistogram dirty;
+    PdcOverlayPainter reference;
+    QImage expected(size, QImage::Format_ARGB32_Premultiplied);
+    overlay.setLayerCacheEnabled(true);
+    paintFull(&canvas, background, &overlay, states.front());
+    double dirtyArea = 0.0;
+    quint64 mismatchedFrames = 0;
+    PdcOverlayPainter::ChangedRects rects;
+    for (int n = 1; n < frames; ++n) {
+        timer.start();
+        const int count = PdcOverlayPainter::changedRects(canvas.rect(), states[n - 1], states[n], &rects);
+        if (count > 0) {
+            paintRects(&canvas, background, &overlay, states[n], rects, count);
+            dirty.add(static_cast<quint64>(timer.nsecsElapsed()));
+            for (int i = 0; i < count; ++i)
+                dirtyArea += double(rects[i].width()) * rects[i].height();
+        }
+
+        if (n % 97 == 0 || n == frames - 1) {
+            paintFull(&expected, background, &reference, states[n]);
+            if (expected != canvas)
+                ++mismatchedFrames;
+        }
+    }
+
+    // 캐시 layer와 직접 그린 결과의 차이 (정보용 — antialias 반올림 정도만 달라야 한다)
+    int maxChannelDiff = 0;
+    {
+        QImage direct(size, QImage::Format_ARGB32_Premultiplied);
+        PdcOverlayPainter uncachedPainter;
+        uncachedPainter.setLayerCacheEnabled(false);
+        for (int n = 0; n < frames; n += qMax(1, frames / 16)) {
+            paintFull(&direct, background, &uncachedPainter, states[n]);
+            paintFull(&expected, background, &reference, states[n]);
+            for (int y = 0; y < size.height(); ++y) {
+                const uchar *a = direct.constScanLine(y);
+                const uchar *b = expected.constScanLine(y);
+                for (int x = 0; x < size.width() * 4; ++x)
+                    maxChannelDiff = qMax(maxChannelDiff, qAbs(int(a[x]) - int(b[x])));
+            }
+        }
+    }
+
+    const double canvasArea = double(size.width()) * size.height();
+    std::printf("== PDC overlay render (%dx%d, %d state updates) ==\n", size.width(), size.height(), frames);
+    printResult("full-uncached", uncached, static_cast<quint64>(frames));
+    printResult("full-cached", cached, static_cast<quint64>(frames));
+    printResult("dirty", dirty, static_cast<quint64>(frames - 1));
+    std::printf("  dirty area: mean %.1f%% of canvas per painted update\n",
+                dirty.count() ? 100.0 * dirtyArea / (canvasArea * dirty.count()) : 0.0);
+    std::printf("  cached vs direct guide lines: max channel difference %d\n", maxChannelDiff);
+    std::printf("  dirty vs full repaint: %llu mismatched checkpoints\n",
+                static_cast<unsigned long long>(mismatchedFrames));
+    return mismatchedFrames == 0 ? 0 : 1;
+}
@@ -0,0 +1,165 @@
+/**
+ * @file bench_pdc.cpp
+ * @brief PDC 데이터 경로 마이크로벤치마크 — 프레임당 힙 할당 수 / 처리 시간 (헤드리스)
+ *
+ * 실제 코드로 한 프레임의 경로를 그대로 돈다:
+ *   can_frame → SocketCanPdcProvider::decodeFrame → IPdcSensorProvider::sampleReady
+ *             → PdcController (nearest / warning level / data age / stale 관리)
+ *             → stateChanged → 실제 소비자 2개
+ *                 PdcBeepController::setPdcState   (단계 → tone engine 또는 fallback tick 타이머)
+ *                 ReverseCameraWindow::setPdcState와 같은 경로 (PdcOverlayPainter::changedRects + 값 복사)
+ * 전역 operator new/delete를 바꿔 측정 구간의 할당 횟수를 센다.
+ * 0x350(4채널)과 0x123(단일 거리) 프레임을 번갈아 넣고, 거리를 바꿔 warning level도 움직인다.
+ * 위젯의 update(QRect) 이후(Qt dirty region 관리)와 페인트는 포함하지 않는다 — 렌더링 벤치마크 몫.
+ * beep 경로는 --beep-sink로 고른다: off(기본, QTimer fallback) / null(PdcToneEngine, 오디오 장치 없이).
+ *
+ * 사용법:
+ *   hu_bench_pdc [--frames 1000000] [--warmup 1000] [--beep-sink off|null]
+ * 종료 코드: 측정 구간에서 할당이 한 번이라도 있으면 1
+ */
+
+#include "PdcController.h"
+#include "PdcBeepController.h"
+#include "PdcOverlayPainter.h"
+#include "MockPdcSensorProvider.h"
+#include "SocketCanPdcProvider.h"
+#include "ShellProtocol.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// ── 할당 카운터 ─────────────────────────────────────────────────────────
+namespace {
+std::atomic<quint64> g_allocs{0};
+std::atomic<bool>    g_counting{false};
+
+void *countedAlloc(std::size_t size)
+{
+    if (g_counting.load(std::memory_order_relaxed))
+        g_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+} // namespace
+
+void *operator new(std::size_t size) { return countedAlloc(size); }
+void *operator new[](std::size_t size) { return countedAlloc(size); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+can_frame makeFrame(quint64 i)
+{
+    can_frame frame{};
+    // 20 ~ 219 cm 사이를 오가며 warning level이 바뀌게
+    const quint16 base = static_cast<quint16>(20 + (i * 7) % 200);
+    if (i % 2 == 0) {
+        frame.can_id = 0x350;
+        frame.can_dlc = 8;
+        for (int s = 0; s < 4; ++s) {
+            const quint16 cm = static_cast<quint16>(base + s * 15);
+            frame.data[s * 2] = static_cast<__u8>(cm & 0xFF);
+            frame.data[s * 2 + 1] = static_cast<__u8>(cm >> 8);
+        }
+    } else {
+        frame.can_id = 0x123;
+        frame.can_dlc = 8;
+        frame.data[1] = static_cast<__u8>(base);
+    }
+    return frame;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("hu_bench_pdc");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("PDC provider -> controller -> consumer allocation benchmark");
+    parser.addHelpOption();
+    QCommandLineOption framesOpt("frames", "Measured frames.", "n", "1000000");
+    QCommandLineOption warmupOpt("warmup", "Warm-up frames (not counted).", "n", "1000");
+    QCommandLineOption beepSinkOpt("beep-sink", "PdcBeepController path: off (QTimer fallback) or null (tone engine).",
+                                   "sink", "off");
+    parser.addOptions({framesOpt, warmupOpt, beepSinkOpt});
+    parser.process(app);
+
+    // PdcBeepController는 생성 시 HU_PDC_TONE_SINK를 읽는다
+    qputenv("HU_PDC_TONE_SINK", parser.value(beepSinkOpt).toLatin1());
+
+    const quint64 frames = qMax<quint64>(1, parser.value(framesOpt).toULongLong());
+    const quint64 warmup = parser.value(warmupOpt).toULongLong();
+
+    // 타이머 없이 sampleReady만 직접 emit하는 입력원으로 mock provider를 쓴다
+    auto *provider = new MockPdcSensorProvider;
+    PdcController controller(provider);
+    provider->stop();
+    controller.setActive(true);
+
+    // 소비자: ShellWindow와 같은 연결 — beep은 실제 컨트롤러,
+    // overlay는 ReverseCameraWindow::setPdcState 본문 (위젯 없이 update(QRect) 직전까지)
+    PdcBeepController beep;
+    QObject::connect(&controller, &PdcController::stateChanged, &beep, &PdcBeepController::setPdcState);
+
+    const QRect overlayRect(0, 0, 640, 400);
+    PdcState overlayState;
+    PdcOverlayPainter::ChangedRects dirty;
+    quint64 dirtyRects = 0;
+    quint64 criticalFrames = 0;
+    QObject::connect(&controller, &PdcController::stateChanged, [&](const PdcState &state) {
+        dirtyRects += static_cast<quint64>(PdcOverlayPainter::changedRects(overlayRect, overlayState, state, &dirty));
+        overlayState = state;
+        if (state.warningLevel == PdcWarningLevel::Critical)
+            ++criticalFrames;
+    });
+
+    auto runFrame = [&](quint64 i) {
+        const can_frame frame = makeFrame(i);
+        PdcSample sample;
+        if (SocketCanPdcProvider::decodeFrame(frame, CanBatchReader::realtimeNowNs(), sample))
+            emit provider->sampleReady(sample);
+    };
+
+    for (quint64 i = 0; i < warmup; ++i)
+        runFrame(i);
+
+    g_allocs.store(0);
+    g_counting.store(true);
+    const quint64 startNs = HuProtocol::monotonicNowNs();
+    for (quint64 i = 0; i < frames; ++i)
+        runFrame(warmup + i);
+    const quint64 elapsedNs = HuProtocol::monotonicNowNs() - startNs;
+    g_counting.store(false);
+    const quint64 allocs = g_allocs.load();
+
+    const HuProtocol::LatencyHistogram &age = controller.dataAge();
+    std::printf("== PDC data path (%llu frames) ==\n", static_cast<unsigned long long>(frames));
+    std::printf("  sizeof(PdcSample) %zu B, sizeof(PdcState) %zu B (trivially copyable)\n",
+                sizeof(PdcSample), sizeof(PdcState));
+    std::printf("  time        : %.1f ns/frame (%.2f M frames/s)\n",
+                double(elapsedNs) / frames, frames * 1e3 / double(elapsedNs));
+    std::printf("  heap allocs : %llu total, %.4f per frame\n",
+                static_cast<unsigned long long>(allocs), double(allocs) / frames);
+    std::printf("  data age    : p50 %llu us, p99 %llu us (decode -> controller)\n",
+                static_cast<unsigned long long>(age.percentileUs(0.5)),
+                static_cast<unsigned long long>(age.percentileUs(0.99)));
+    std::printf("  consumers   : beep via %s, last nearest %.0f cm, %llu critical frames, %.2f dirty rects/frame\n",
+                beep.acceptsLevelFromAnyThread() ? "tone engine" : "QTimer fallback",
+                overlayState.nearestDistanceCm, static_cast<unsigned long long>(criticalFrames),
+                double(dirtyRects) / frames);
+
+    const bool pass = allocs == 0;
+    std::printf("\nallocation-free PDC path: %s\n", pass ? "PASS" : "FAIL");
+    return pass ? 0 : 1;
+}
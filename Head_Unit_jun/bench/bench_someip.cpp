@@ -0,0 +1,143 @@
+/**
+ * @file bench_someip.cpp
+ * @brief Head Unit SOME/IP 수신 경로 벤치마크 (헤드리스, 개발 PC용)
+ *
+ * 실제 VSomeIPClient를 QCoreApplication 안에서 돌리고, hu_cluster_standin이 보내는
+ * 0x8004 vehicle state를 받으면서 1초마다 측정한다:
+ *   - 수신 이벤트 수 (vehicleStateReceived) 와 seq 누락 (vehicleStateGaps)
+ *   - Qt 스레드로 전달된 시그널 수 (speedChanged / batteryChanged — 루프 1회당 합쳐진다)
+ *   - 프로세스 CPU 시간 (getrusage: user + sys) → CPU %, 수신 이벤트당 CPU µs
+ *   - --gear-hz > 0 이면 기어 요청을 주기적으로 보내 RTT / 재전송 / 타임아웃을 집계
+ *
+ * 사용법 (같은 머신에서, 대역 클러스터를 먼저 실행):
+ *   VSOMEIP_CONFIGURATION=config/vsomeip_standin.json hu_cluster_standin --rate-hz 1000 &
+ *   VSOMEIP_CONFIGURATION=config/vsomeip_headunit.json \
+ *   hu_bench_someip [--duration-s 10] [--gear-hz 2]
+ * 종료 코드: 이벤트를 하나도 받지 못했거나 기어 요청이 예산(REQ-03)을 넘겼으면 1
+ */
+
+#include "VSomeIPClient.h"
+#include "GearRequest.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTimer>
+
+#include <cstdio>
+
+#include <sys/resource.h>
+
+namespace {
+
+quint64 cpuTimeUs()
+{
+    rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return quint64(ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000000ull
+         + quint64(ru.ru_utime.tv_usec + ru.ru_stime.tv_usec);
+}
+
+quint64 wallTimeUs()
+{
+    return HuProtocol::monotonicNowNs() / 1000;
+}
+
+struct Window {
+    quint64 wallUs    = 0;
+    quint64 cpuUs     = 0;
+    quint32 received  = 0;
+    quint32 gaps      = 0;
+    quint64 speedSigs = 0;
+    quint64 battSigs  = 0;
+};
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("hu_bench_someip");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Head Unit SOME/IP ingestion benchmark (run hu_cluster_standin first)");
+    parser.addHelpOption();
+    QCommandLineOption durationOpt("duration-s", "Measurement time.", "s", "10");
+    QCommandLineOption gearOpt("gear-hz", "Gear requests per second (0 = none).", "hz", "2");
+    parser.addOptions({durationOpt, gearOpt});
+    parser.process(app);
+
+    const int durationS = qMax(1, parser.value(durationOpt).toInt());
+    const int gearHz    = qBound(0, parser.value(gearOpt).toInt(), 50);
+
+    VSomeIPClient client;
+    quint64 speedSignals = 0;
+    quint64 batterySignals = 0;
+    QObject::connect(&client, &IVehicleDataProvider::speedChanged, [&] { ++speedSignals; });
+    QObject::connect(&client, &IVehicleDataProvider::batteryChanged, [&] { ++batterySignals; });
+    QObject::connect(&client, &IVehicleDataProvider::connectionStatusChanged, [](bool up) {
+        std::printf("[bench] cluster service %s\n", up ? "available" : "unavailable");
+    });
+
+    // 기어 요청: P → R → N → D 순환
+    QTimer gearTimer;
+    int gearIndex = 0;
+    if (gearHz > 0) {
+        gearTimer.setInterval(1000 / gearHz);
+        QObject::connect(&gearTimer, &QTimer::timeout, [&] {
+            if (client.isConnected())
+                client.publishGear(static_cast<GearState>(gearIndex++ % 4));
+        });
+        gearTimer.start();
+    }
+
+    Window last{ wallTimeUs(), cpuTimeUs(), 0, 0, 0, 0 };
+    const Window first = last;
+    QTimer report;
+    report.setInterval(1000);
+    QObject::connect(&report, &QTimer::timeout, [&] {
+        const Window now{ wallTimeUs(), cpuTimeUs(), client.vehicleStateReceived(),
+                          client.vehicleStateGaps(), speedSignals, batterySignals };
+        const double secs   = double(now.wallUs - last.wallUs) / 1e6;
+        const quint32 rx    = now.received - last.received;
+        const quint64 cpuUs = now.cpuUs - last.cpuUs;
+        std::printf("[bench] rx %7.1f Hz  gaps %-4u  speed sig %6.1f Hz  battery sig %6.1f Hz  "
+                    "cpu %5.1f %%  %6.2f us/event\n",
+                    rx / secs, now.gaps - last.gaps,
+                    (now.speedSigs - last.speedSigs) / secs, (now.battSigs - last.battSigs) / secs,
+                    100.0 * cpuUs / double(now.wallUs - last.wallUs),
+                    rx ? double(cpuUs) / rx : 0.0);
+        std::fflush(stdout);
+        last = now;
+    });
+    report.start();
+    QTimer::singleShot(durationS * 1000, &app, &QCoreApplication::quit);
+    app.exec();
+
+    const quint32 received = client.vehicleStateReceived() - first.received;
+    const double  secs     = double(wallTimeUs() - first.wallUs) / 1e6;
+    const quint64 cpuUs    = cpuTimeUs() - first.cpuUs;
+    const HuProtocol::LatencyHistogram &rtt = client.gearRoundTrip();
+
+    std::printf("\n== summary (%.1f s) ==\n", secs);
+    std::printf("  vehicle state : %u events (%.1f Hz), %u gaps\n",
+                received, received / secs, client.vehicleStateGaps() - first.gaps);
+    std::printf("  Qt signals    : speed %llu, battery %llu (coalesced per loop pass)\n",
+                static_cast<unsigned long long>(speedSignals),
+                static_cast<unsigned long long>(batterySignals));
+    std::printf("  CPU           : %.1f %% of one core, %.2f us per event\n",
+                100.0 * cpuUs / (secs * 1e6), received ? double(cpuUs) / received : 0.0);
+    std::printf("  gear requests : %llu acked, p50 %llu us, p99 %llu us, max %llu us, "
+                "%u retransmits, %u timeouts\n",
+                static_cast<unsigned long long>(rtt.count()),
+                static_cast<unsigned long long>(rtt.percentileUs(0.5)),
+                static_cast<unsigned long long>(rtt.percentileUs(0.99)),
+                static_cast<unsigned long long>(rtt.maxNs() / 1000),
+                client.gearRetransmits(), client.gearTimeouts());
+
+    const bool withinBudget = client.gearTimeouts() == 0
+        && rtt.maxNs() <= quint64(GearRequest::kBudgetMs) * 1000000ull;
+    const bool pass = received > 0 && withinBudget;
+    std::printf("\nREQ-03 (gear ack <= %d ms) and ingestion: %s\n",
+                GearRequest::kBudgetMs, pass ? "PASS" : "FAIL");
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,159 @@
+/**
+ * @file bench_tone.cpp
+ * @brief PDC 경보음 엔진(PdcToneEngine) 벤치마크 — 경고 단계 변경 → 첫 chirp 재생 지연 / 간격 정확도
+ *
+ * 임의 간격(20 ~ 400 ms)으로 경고 단계를 바꾸며 엔진의 onset latency 히스토그램을 모은다.
+ *   onset latency = setLevel() 시각 → 그 단계의 첫 chirp 첫 frame이 DAC에 닿는 시각
+ *                   (오디오 스레드가 period 경계에서 읽는 대기 + 장치 버퍼 지연)
+ * --sink file:<wav>면 녹음된 WAV에서 chirp 시작점을 찾아, 단계가 유지된 구간의 반복 간격이
+ * 800 / 350 / 120 ms와 frame 단위로 정확히 같은지 센다.
+ *
+ * 사용법:
+ *   hu_bench_tone [--sink null|alsa|file:/tmp/pdc.wav] [--device default] [--changes 200]
+ *                 [--period-us 5000]
+ * 환경 변수 HU_PDC_TONE_RT_PRIORITY / _CPU / _MLOCK도 그대로 적용된다.
+ * 종료 코드: 엔진을 못 열면 2, 간격 검사에서 틀린 간격이 있으면 1
+ */
+
+#include "PdcToneEngine.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/** 16-bit mono WAV에서 무음(≥ 5 ms) 뒤 첫 비-0 sample 위치들 */
+std::vector<qint64> findChirpStarts(const QString &path, int *rate)
+{
+    std::vector<qint64> starts;
+    std::FILE *f = std::fopen(path.toLocal8Bit().constData(), "rb");
+    if (!f)
+        return starts;
+
+    quint8 header[44];
+    if (std::fread(header, 1, sizeof(header), f) != sizeof(header)) {
+        std::fclose(f);
+        return starts;
+    }
+    *rate = header[24] | (header[25] << 8) | (header[26] << 16) | (header[27] << 24);
+    const qint64 minSilence = *rate / 200;
+
+    qint16 sample = 0;
+    qint64 index = 0;
+    qint64 silent = minSilence;
+    while (std::fread(&sample, sizeof(sample), 1, f) == 1) {
+        if (sample == 0) {
+            ++silent;
+        } else {
+            if (silent >= minSilence)
+                starts.push_back(index - 1);   // chirp 첫 frame은 sin(0) = 0
+            silent = 0;
+        }
+        ++index;
+    }
+    std::fclose(f);
+    return starts;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("hu_bench_tone");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("PDC tone engine onset latency / interval benchmark");
+    parser.addHelpOption();
+    QCommandLineOption sinkOpt("sink", "alsa | null | file:<path.wav>", "sink", "null");
+    QCommandLineOption deviceOpt("device", "ALSA device.", "name", "default");
+    QCommandLineOption changesOpt("changes", "Number of warning level changes.", "n", "200");
+    QCommandLineOption periodOpt("period-us", "Audio period.", "us", "5000");
+    parser.addOptions({sinkOpt, deviceOpt, changesOpt, periodOpt});
+    parser.process(app);
+
+    PdcToneEngine::Config config = PdcToneEngine::Config::fromEnvironment();
+    config.sink = parser.value(sinkOpt);
+    config.device = parser.value(deviceOpt);
+    config.periodUs = qMax(500, parser.value(periodOpt).toInt());
+
+    PdcToneEngine engine(config);
+    QString error;
+    if (!engine.start(&error)) {
+        std::fprintf(stderr, "tone engine: %s\n", qPrintable(error.isEmpty() ? QStringLiteral("off") : error));
+        return 2;
+    }
+
+    // 재현 가능한 의사 난수 — 단계와 유지 시간을 섞는다 (Off 포함, 같은 단계 연속은 건너뜀)
+    const int changes = qMax(1, parser.value(changesOpt).toInt());
+    const PdcWarningLevel levels[] = { PdcWarningLevel::Off, PdcWarningLevel::Near,
+                                       PdcWarningLevel::Caution, PdcWarningLevel::Critical };
+    quint32 rng = 2024;
+    PdcWarningLevel current = PdcWarningLevel::Off;
+    for (int i = 0; i < changes; ++i) {
+        rng = rng * 1664525u + 1013904223u;
+        int pick = int((rng >> 16) % 4);
+        if (levels[pick] == current)
+            pick = (pick + 1) % 4;
+        current = levels[pick];
+        engine.setLevel(current);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20 + (rng >> 8) % 380));
+    }
+    engine.setLevel(PdcWarningLevel::Off);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    engine.stop();
+
+    const HuProtocol::LatencyHistogram &onset = engine.onsetLatency();
+    const PdcToneEngine::Stats &stats = engine.stats();
+    std::printf("== PDC tone engine (%s sink, %d us period, %d level changes) ==\n",
+                qPrintable(engine.sinkName()), config.periodUs, changes);
+    std::printf("  periods %llu, chirps %llu, underruns %llu\n",
+                static_cast<unsigned long long>(stats.periods),
+                static_cast<unsigned long long>(stats.chirps),
+                static_cast<unsigned long long>(stats.underruns));
+    std::printf("  onset latency (%llu escalations): min %.2f ms, mean %.2f ms, p50 <= %.2f ms, "
+                "p99 <= %.2f ms, max %.2f ms\n",
+                static_cast<unsigned long long>(onset.count()), onset.minNs() / 1e6, onset.meanUs() / 1e3,
+                onset.percentileUs(0.5) / 1e3, onset.percentileUs(0.99) / 1e3, onset.maxNs() / 1e6);
+
+    if (!config.sink.startsWith(QStringLiteral("file:")))
+        return 0;
+
+    // 같은 단계가 유지된 구간의 간격은 정확히 이 값들 중 하나여야 한다 — 나머지는 단계 전환 지점
+    int rate = 0;
+    const std::vector<qint64> starts = findChirpStarts(config.sink.mid(5), &rate);
+    int exact = 0;
+    int transitions = 0;
+    int wrong = 0;
+    for (size_t i = 1; i < starts.size(); ++i) {
+        const qint64 gap = starts[i] - starts[i - 1];
+        bool matched = false;
+        for (PdcWarningLevel level : { PdcWarningLevel::Near, PdcWarningLevel::Caution,
+                                       PdcWarningLevel::Critical }) {
+            const qint64 expected = qint64(PdcToneEngine::intervalMsForLevel(level)) * rate / 1000;
+            if (gap == expected) {
+                matched = true;
+                break;
+            }
+            if (qAbs(gap - expected) < rate / 1000) {
+                ++wrong;   // 1 ms 안쪽으로 어긋남 = sample 단위 반복이 깨진 것
+                matched = true;
+                break;
+            }
+        }
+        if (matched)
+            ++exact;
+        else
+            ++transitions;
+    }
+    exact -= wrong;
+    std::printf("  intervals in WAV: %d sample-exact, %d off by < 1 ms, %d at level transitions\n",
+                exact, wrong, transitions);
+    return wrong == 0 ? 0 : 1;
+}
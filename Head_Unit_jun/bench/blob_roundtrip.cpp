@@ -0,0 +1,136 @@
+/**
+ * @file blob_roundtrip.cpp
+ * @brief SharedBlob 왕복 검사 — 봉인 → SCM_RIGHTS 전달 → 수신 측 읽기 전용 매핑 (대상 커널에서 실행)
+ *
+ * 봉인된 memfd의 매핑 가능 여부는 커널 버전에 따라 다르다 (F_SEAL_WRITE + MAP_SHARED는 6.7 이전 EPERM).
+ * Pi/Yocto 이미지에서 이 도구를 돌려 실제 커널에서 전체 경로가 동작하는지 확인한다.
+ *   1) SharedBlob::create → writableData() 채움 → seal()            (송신 측 재매핑)
+ *   2) BlobChannel listen / connectTo (임시 경로) → send → take(id)   (SCM_RIGHTS + adopt)
+ *   3) 수신 측 data()가 원본과 같은지, 봉인이 실제로 쓰기/크기 변경을 막는지
+ * 크기마다 반복한다 (0 바이트, 페이지 경계 안팎, 큰 blob).
+ *
+ * 사용법:
+ *   hu_blob_roundtrip [--sizes 0,1,4095,4096,65537,8388608]
+ * 종료 코드: 하나라도 실패하면 1
+ */
+
+#include "SharedBlob.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QStringList>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+
+using HuProtocol::BlobChannel;
+using HuProtocol::SharedBlob;
+
+void fillPattern(char *data, qint64 size, quint32 seed)
+{
+    quint32 x = seed;
+    for (qint64 i = 0; i < size; ++i) {
+        x = x * 1664525u + 1013904223u;
+        data[i] = static_cast<char>(x >> 24);
+    }
+}
+
+bool fail(qint64 size, const char *what)
+{
+    std::printf("  %9lld bytes: FAIL — %s (%s)\n", static_cast<long long>(size), what, std::strerror(errno));
+    return false;
+}
+
+bool roundTrip(BlobChannel *server, BlobChannel *client, qint64 size, quint32 seed)
+{
+    std::vector<char> expected(static_cast<size_t>(size));
+    fillPattern(expected.data(), size, seed);
+
+    SharedBlob blob = SharedBlob::create(size, "hu_blob_check");
+    if (!blob.isValid())
+        return fail(size, "create");
+    if (size > 0)
+        std::memcpy(blob.writableData(), expected.data(), static_cast<size_t>(size));
+    if (!blob.seal())
+        return fail(size, "seal / read-only remap");
+    if (size > 0 && std::memcmp(blob.data(), expected.data(), static_cast<size_t>(size)) != 0)
+        return fail(size, "sender view differs after seal");
+
+    const quint32 id = client->send(blob);
+    if (id == 0)
+        return fail(size, "send (SCM_RIGHTS)");
+
+    const SharedBlob received = server->take(id);
+    if (!received.isValid())
+        return fail(size, "take / adopt");
+    if (received.size() != size)
+        return fail(size, "size mismatch");
+    if (size > 0 && std::memcmp(received.data(), expected.data(), static_cast<size_t>(size)) != 0)
+        return fail(size, "receiver view differs");
+
+    // 봉인이 실제로 걸렸는지 — 쓰기 가능한 공유 매핑과 크기 변경은 거부돼야 한다
+    if (size > 0) {
+        void *w = ::mmap(nullptr, static_cast<size_t>(size), PROT_READ | PROT_WRITE, MAP_SHARED, received.fd(), 0);
+        if (w != MAP_FAILED) {
+            ::munmap(w, static_cast<size_t>(size));
+            errno = 0;
+            return fail(size, "writable shared mapping of a sealed blob succeeded");
+        }
+    }
+    if (::ftruncate(received.fd(), size + 1) == 0) {
+        errno = 0;
+        return fail(size, "sealed blob could be grown");
+    }
+
+    std::printf("  %9lld bytes: ok\n", static_cast<long long>(size));
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("hu_blob_roundtrip");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Sealed memfd blob round-trip check (seal, SCM_RIGHTS, read-only map)");
+    parser.addHelpOption();
+    QCommandLineOption sizesOpt("sizes", "Blob sizes in bytes (comma separated).", "list",
+                                "0,1,4095,4096,65537,8388608");
+    parser.addOption(sizesOpt);
+    parser.process(app);
+
+    const QString path = QDir::temp().filePath(
+        QStringLiteral("hu_blob_roundtrip_%1.fd").arg(QCoreApplication::applicationPid()));
+    BlobChannel server;
+    BlobChannel client;
+    if (!server.listen(path) || !client.connectTo(path)) {
+        std::printf("cannot set up blob side channel at %s\n", qPrintable(path));
+        return 2;
+    }
+
+    std::printf("== SharedBlob round trip (%s) ==\n", qPrintable(path));
+    int failures = 0;
+    quint32 seed = 1;
+    for (const QString &part : parser.value(sizesOpt).split(',')) {
+        bool ok = false;
+        const qint64 size = part.trimmed().toLongLong(&ok);
+        if (!ok || size < 0 || size > HuProtocol::MAX_BLOB_SIZE) {
+            std::printf("  invalid size '%s'\n", qPrintable(part));
+            return 2;
+        }
+        if (!roundTrip(&server, &client, size, seed++))
+            ++failures;
+    }
+    std::printf("  %d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
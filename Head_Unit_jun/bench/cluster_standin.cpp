@@ -0,0 +1,485 @@
+/**
+ * @file cluster_standin.cpp
+ * @brief Instrument Cluster 대역 프로세스 (헤드리스 SOME/IP 부하 생성기, 개발 PC용)
+ *
+ * VSomeIPGearReceiver와 같은 서비스(0x1234/0x0001)를 "InstrumentCluster" 이름으로 offer한다.
+ *   - 0x8004 vehicle state (VehicleStateEvent.h)를 --rate-hz(10 ~ 2000)로 publish
+ *   - 0x8001 legacy speed도 같은 주기로 (--no-legacy로 끔)
+ *   - 0x8002 gear request에 applied gear + seq로 응답 (GearRequest.h)
+ *     --gear-delay-ms 만큼 늦게 응답, --gear-drop N 이면 N번째 요청마다 무시 (재전송 확인용)
+ *
+ * 지터 프로파일 (--jitter):
+ *   none     : 절대 시각 기준 고정 주기 (clock_nanosleep TIMER_ABSTIME)
+ *   uniform  : 각 publish를 ±--jitter-us 안에서 무작위로 흔든다
+ *   burst    : --burst N 주기마다 N개를 한꺼번에 보낸다 (평균 속도는 같다)
+ *   drop     : --drop-pct 확률로 샘플을 건너뛴다 (seq는 증가 — HU gap 카운터 확인용)
+ *
+ * 재생 모드 (--replay session.hutl, hu_traffic_record로 녹화):
+ *   합성 신호 대신 녹화된 SOME/IP 이벤트(0x8001/0x8004)를 publish하고, CAN 프레임은
+ *   --can-out 인터페이스(vcan0 등)로 보낸다. --speed 1 = 실시간, N = N배속, 0 = 최대 속도.
+ *   HU가 구독할 시간을 --start-delay-ms 만큼 기다린 뒤 시작하고, 끝나면 종료한다.
+ *   실제 송신 시각이 예정보다 늦은 정도(lag)를 p50/p99/max로 출력한다.
+ *
+ * 1초마다 publish 통계(실제 속도, 주기 p50/p99/max, 늦은 주기, gear 요청/응답)를 출력한다.
+ * HU 쪽 수신 측정은 hu_bench_someip를 같이 돌린다 (config/vsomeip_standin.json 참고).
+ *
+ * 사용법:
+ *   VSOMEIP_CONFIGURATION=config/vsomeip_standin.json \
+ *   hu_cluster_standin [--rate-hz 100] [--jitter none|uniform|burst|drop] [--jitter-us 500]
+ *                      [--burst 8] [--drop-pct 1] [--duration-s 0] [--gear-delay-ms 0]
+ *                      [--gear-drop 0] [--no-legacy]
+ *   hu_cluster_standin --replay session.hutl [--can-out vcan0] [--speed 1] [--start-delay-ms 1000]
+ */
+
+#include "VehicleStateEvent.h"
+#include "GearRequest.h"
+#include "LatencyHistogram.h"
+#include "TrafficLog.h"
+
+#include <vsomeip/vsomeip.hpp>
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTimer>
+
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <set>
+#include <thread>
+
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#include <net/if.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr vsomeip::service_t    kServiceId     = 0x1234;
+constexpr vsomeip::instance_t   kInstanceId    = 0x0001;
+constexpr vsomeip::method_t     kGearMethodId  = 0x8002;
+constexpr vsomeip::event_t      kSpeedEventId  = 0x8001;
+constexpr vsomeip::event_t      kStateEventId  = VehicleStateEvent::kEventId;
+constexpr vsomeip::eventgroup_t kEventGroupId  = 0x0001;
+
+enum class Jitter { None, Uniform, Burst, Drop };
+
+struct Options {
+    int    rateHz      = 100;
+    Jitter jitter      = Jitter::None;
+    int    jitterUs    = 500;
+    int    burst       = 8;
+    double dropPct     = 1.0;
+    int    durationS   = 0;
+    int    gearDelayMs = 0;
+    int    gearDrop    = 0;
+    bool   legacy      = true;
+
+    // 재생 모드
+    QString replay;
+    QString canOut;
+    double  speed        = 1.0;    // 0 = 최대 속도
+    int     startDelayMs = 1000;
+};
+
+quint64 monoNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return quint64(ts.tv_sec) * 1000000000ull + quint64(ts.tv_nsec);
+}
+
+void sleepUntil(quint64 ns)
+{
+    timespec ts;
+    ts.tv_sec  = static_cast<time_t>(ns / 1000000000ull);
+    ts.tv_nsec = static_cast<long>(ns % 1000000000ull);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {}
+}
+
+/** 재생용 CAN_RAW 송신 소켓. 실패하면 -1 */
+int openCanTx(const QString &ifName)
+{
+    const int fd = ::socket(PF_CAN, SOCK_RAW | SOCK_CLOEXEC, CAN_RAW);
+    if (fd < 0)
+        return -1;
+    ifreq ifr;
+    std::memset(&ifr, 0, sizeof(ifr));
+    std::strncpy(ifr.ifr_name, ifName.toLatin1().constData(), IFNAMSIZ - 1);
+    sockaddr_can addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.can_family = AF_CAN;
+    if (::ioctl(fd, SIOCGIFINDEX, &ifr) < 0
+        || (addr.can_ifindex = ifr.ifr_ifindex,
+            ::bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0)) {
+        ::close(fd);
+        return -1;
+    }
+    ::setsockopt(fd, SOL_CAN_RAW, CAN_RAW_FILTER, nullptr, 0);   // 송신 전용 — 수신 안 함
+    return fd;
+}
+
+/** 최대 속도 재생에서는 TX 큐가 차므로(ENOBUFS) 잠깐 기다렸다가 다시 보낸다 */
+bool sendCan(int fd, const TrafficRecord &rec)
+{
+    can_frame frame;
+    std::memset(&frame, 0, sizeof(frame));
+    frame.can_id  = rec.canId;
+    frame.can_dlc = qMin<quint8>(rec.length, CAN_MAX_DLEN);
+    std::memcpy(frame.data, rec.data, frame.can_dlc);
+    for (int attempt = 0; attempt < 100; ++attempt) {
+        if (::write(fd, &frame, sizeof(frame)) == static_cast<ssize_t>(sizeof(frame)))
+            return true;
+        if (errno != ENOBUFS && errno != EAGAIN && errno != EINTR)
+            return false;
+        pollfd pfd{ fd, POLLOUT, 0 };
+        ::poll(&pfd, 1, 10);
+    }
+    return false;
+}
+
+const char *jitterName(Jitter j)
+{
+    switch (j) {
+    case Jitter::Uniform: return "uniform";
+    case Jitter::Burst:   return "burst";
+    case Jitter::Drop:    return "drop";
+    default:              return "none";
+    }
+}
+
+// ── 대역 클러스터 ─────────────────────────────────────────────────────
+
+class ClusterStandIn
+{
+public:
+    explicit ClusterStandIn(const Options &opt) : m_opt(opt) {}
+
+    bool start()
+    {
+        m_app = vsomeip::runtime::get()->create_application("InstrumentCluster");
+        if (!m_app || !m_app->init()) {
+            std::fprintf(stderr, "vsomeip init failed (VSOMEIP_CONFIGURATION set?)\n");
+            return false;
+        }
+        m_statePayload = vsomeip::runtime::get()->create_payload();
+        m_speedPayload = vsomeip::runtime::get()->create_payload();
+
+        m_app->register_state_handler([this](vsomeip::state_type_e state) {
+            if (state != vsomeip::state_type_e::ST_REGISTERED) {
+                m_registered = false;
+                return;
+            }
+            std::set<vsomeip::eventgroup_t> groups = {kEventGroupId};
+            m_app->offer_event(kServiceId, kInstanceId, kStateEventId, groups,
+                               vsomeip::event_type_e::ET_FIELD);
+            m_app->offer_event(kServiceId, kInstanceId, kSpeedEventId, groups,
+                               vsomeip::event_type_e::ET_FIELD);
+            m_app->offer_service(kServiceId, kInstanceId);
+            m_registered = true;
+            std::printf("[standin] registered, offering 0x1234 (%d Hz, jitter %s)\n",
+                        m_opt.rateHz, jitterName(m_opt.jitter));
+        });
+        m_app->register_message_handler(kServiceId, kInstanceId, kGearMethodId,
+            [this](const std::shared_ptr<vsomeip::message> &msg) { onGearRequest(msg); });
+
+        m_vsomeipThread = std::thread([this] { m_app->start(); });
+        m_running = true;
+        m_publisher = std::thread([this] {
+            if (m_opt.replay.isEmpty())
+                publishLoop();
+            else
+                replayLoop();
+        });
+        return true;
+    }
+
+    void stop()
+    {
+        m_running = false;
+        if (m_publisher.joinable()) m_publisher.join();
+        if (m_app) m_app->stop();
+        if (m_vsomeipThread.joinable()) m_vsomeipThread.join();
+        std::printf("[standin] total: published %llu, skipped %llu, gear requests %u, "
+                    "answered %u, dropped %u\n",
+                    static_cast<unsigned long long>(m_totalSent),
+                    static_cast<unsigned long long>(m_totalSkipped),
+                    m_gearRequests.load(), m_gearAnswered.load(), m_gearDropped.load());
+    }
+
+private:
+    void onGearRequest(const std::shared_ptr<vsomeip::message> &msg)
+    {
+        GearRequest::Payload req;
+        const auto pl = msg->get_payload();
+        if (!pl || !GearRequest::decode(pl->get_data(), pl->get_length(), req))
+            return;
+        const quint32 n = ++m_gearRequests;
+        if (m_opt.gearDrop > 0 && n % static_cast<quint32>(m_opt.gearDrop) == 0) {
+            ++m_gearDropped;
+            return;
+        }
+        m_gear = req.gear;   // 다음 publish부터 gear echo에 반영
+
+        auto reply = [this, msg, req] {
+            if (msg->get_message_type() != vsomeip::message_type_e::MT_REQUEST)
+                return;
+            vsomeip::byte_t data[GearRequest::kWireSize];
+            GearRequest::encode(req, data);
+            auto payload = vsomeip::runtime::get()->create_payload();
+            payload->set_data(data, sizeof(data));
+            auto response = vsomeip::runtime::get()->create_response(msg);
+            response->set_payload(payload);
+            m_app->send(response);
+            ++m_gearAnswered;
+        };
+        if (m_opt.gearDelayMs <= 0) {
+            reply();
+        } else {
+            // vsomeip 디스패처를 막지 않도록 메인 이벤트 루프에서 지연 응답
+            QMetaObject::invokeMethod(qApp, [reply, delay = m_opt.gearDelayMs] {
+                QTimer::singleShot(delay, reply);
+            }, Qt::QueuedConnection);
+        }
+    }
+
+    void publishLoop()
+    {
+        const quint64 periodNs = 1000000000ull / static_cast<quint64>(m_opt.rateHz);
+        std::mt19937 rng(0x5eed);
+        std::uniform_int_distribution<int> jitterDist(-m_opt.jitterUs, m_opt.jitterUs);
+        std::uniform_real_distribution<double> dropDist(0.0, 100.0);
+
+        VehicleStateEvent::State st;
+        st.flags = VehicleStateEvent::FlagSpeedValid | VehicleStateEvent::FlagBatteryValid;
+        std::uint8_t buf[VehicleStateEvent::kWireSize];
+
+        HuProtocol::LatencyHistogram interval;
+        quint64 next = monoNs();
+        quint64 lastSend = 0;
+        quint64 windowStart = next;
+        quint64 sent = 0, skipped = 0, late = 0;
+        quint64 tick = 0;
+
+        while (m_running) {
+            next += periodNs;
+            ++tick;
+
+            // ── 다음 publish 시각 ──
+            switch (m_opt.jitter) {
+            case Jitter::Uniform: {
+                const qint64 offset = qint64(jitterDist(rng)) * 1000;
+                sleepUntil(offset < 0 && quint64(-offset) > next ? next : next + offset);
+                break;
+            }
+            case Jitter::Burst:
+                if (tick % static_cast<quint64>(m_opt.burst) == 1 || m_opt.burst <= 1)
+                    sleepUntil(next + periodNs * static_cast<quint64>(qMax(0, m_opt.burst - 1)));
+                break;
+            default:
+                sleepUntil(next);
+                break;
+            }
+            const quint64 now = monoNs();
+            if (m_opt.jitter == Jitter::None && now > next + periodNs)
+                ++late;   // 한 주기 이상 밀림 (스케줄링 지연)
+
+            ++st.sequence;
+            if (m_opt.jitter == Jitter::Drop && dropDist(rng) < m_opt.dropPct) {
+                ++skipped;
+                continue;
+            }
+            if (!m_registered)
+                continue;
+
+            // 속도: 0 ~ 60 km/h 사인파, 배터리: 천천히 감소
+            const double t = double(now) / 1e9;
+            st.speedKmh       = float(30.0 + 30.0 * std::sin(t * 0.5));
+            st.batteryPercent = float(100.0 - std::fmod(t / 60.0, 50.0));
+            st.batteryVoltage = 6.4f + st.batteryPercent / 100.0f * 2.0f;
+            st.gearEcho       = m_gear.load();
+            st.speedAgeMs     = 0;
+            st.batteryAgeMs   = 0;
+            st.publishTimeUs  = now / 1000;
+
+            VehicleStateEvent::encode(st, buf);
+            m_statePayload->set_data(buf, sizeof(buf));
+            m_app->notify(kServiceId, kInstanceId, kStateEventId, m_statePayload);
+            if (m_opt.legacy) {
+                vsomeip::byte_t speed[4];
+                std::memcpy(speed, &st.speedKmh, sizeof(speed));
+                m_speedPayload->set_data(speed, sizeof(speed));
+                m_app->notify(kServiceId, kInstanceId, kSpeedEventId, m_speedPayload);
+            }
+            if (lastSend) interval.add(now - lastSend);
+            lastSend = now;
+            ++sent;
+
+            if (now - windowStart >= 1000000000ull) {
+                const double secs = double(now - windowStart) / 1e9;
+                std::printf("[standin] %7.1f Hz  interval p50 %6llu us  p99 %6llu us  max %6llu us  "
+                            "late %llu  skipped %llu  gear req %u ack %u drop %u\n",
+                            sent / secs,
+                            static_cast<unsigned long long>(interval.percentileUs(0.5)),
+                            static_cast<unsigned long long>(interval.percentileUs(0.99)),
+                            static_cast<unsigned long long>(interval.maxNs() / 1000),
+                            static_cast<unsigned long long>(late),
+                            static_cast<unsigned long long>(skipped),
+                            m_gearRequests.load(), m_gearAnswered.load(), m_gearDropped.load());
+                std::fflush(stdout);
+                m_totalSent += sent;
+                m_totalSkipped += skipped;
+                interval.clear();
+                windowStart = now;
+                sent = skipped = late = 0;
+            }
+        }
+        m_totalSent += sent;
+        m_totalSkipped += skipped;
+    }
+
+    void replayLoop()
+    {
+        TrafficLogReader reader;
+        if (!reader.open(m_opt.replay)) {
+            std::fprintf(stderr, "[standin] cannot replay %s: %s\n",
+                         qPrintable(m_opt.replay), qPrintable(reader.errorString()));
+            QMetaObject::invokeMethod(qApp, &QCoreApplication::quit, Qt::QueuedConnection);
+            return;
+        }
+        int canFd = -1;
+        if (!m_opt.canOut.isEmpty()) {
+            canFd = openCanTx(m_opt.canOut);
+            if (canFd < 0)
+                std::fprintf(stderr, "[standin] cannot open %s - CAN records skipped\n",
+                             qPrintable(m_opt.canOut));
+        }
+
+        // HU가 서비스를 찾고 구독할 시간
+        sleepUntil(monoNs() + quint64(m_opt.startDelayMs) * 1000000ull);
+        std::printf("[standin] replaying %s at %s\n", qPrintable(m_opt.replay),
+                    m_opt.speed > 0 ? qPrintable(QStringLiteral("%1x").arg(m_opt.speed)) : "max speed");
+
+        HuProtocol::LatencyHistogram lag;
+        TrafficRecord rec;
+        quint64 canSent = 0, canFailed = 0, events = 0, skipped = 0, lastRecordNs = 0;
+        const quint64 start = monoNs();
+        while (m_running && reader.next(rec)) {
+            lastRecordNs = rec.timeNs;
+            if (m_opt.speed > 0) {
+                const quint64 due = start + quint64(double(rec.timeNs) / m_opt.speed);
+                sleepUntil(due);
+                const quint64 now = monoNs();
+                lag.add(now > due ? now - due : 0);
+            }
+
+            if (rec.kind == TrafficRecord::Can) {
+                if (canFd < 0) { ++skipped; continue; }
+                sendCan(canFd, rec) ? ++canSent : ++canFailed;
+            } else if (rec.service == kServiceId && m_registered
+                       && (rec.event == kStateEventId || rec.event == kSpeedEventId)) {
+                auto &payload = rec.event == kStateEventId ? m_statePayload : m_speedPayload;
+                payload->set_data(rec.data, rec.length);
+                m_app->notify(kServiceId, kInstanceId, rec.event, payload);
+                ++events;
+            } else {
+                ++skipped;
+            }
+        }
+        const double wallS = double(monoNs() - start) / 1e9;
+        std::printf("[standin] replay done: %.2f s of traffic in %.2f s, CAN %llu sent / %llu failed, "
+                    "SOME/IP %llu, skipped %llu\n",
+                    double(lastRecordNs) / 1e9, wallS,
+                    static_cast<unsigned long long>(canSent), static_cast<unsigned long long>(canFailed),
+                    static_cast<unsigned long long>(events), static_cast<unsigned long long>(skipped));
+        if (lag.count())
+            std::printf("[standin] schedule lag p50 %llu us  p99 %llu us  max %llu us\n",
+                        static_cast<unsigned long long>(lag.percentileUs(0.5)),
+                        static_cast<unsigned long long>(lag.percentileUs(0.99)),
+                        static_cast<unsigned long long>(lag.maxNs() / 1000));
+        std::fflush(stdout);
+        if (canFd >= 0)
+            ::close(canFd);
+        m_totalSent = canSent + events;
+        QMetaObject::invokeMethod(qApp, &QCoreApplication::quit, Qt::QueuedConnection);
+    }
+
+    Options m_opt;
+    std::shared_ptr<vsomeip::application> m_app;
+    std::shared_ptr<vsomeip::payload>     m_statePayload;
+    std::shared_ptr<vsomeip::payload>     m_speedPayload;
+    std::thread             m_vsomeipThread;
+    std::thread             m_publisher;
+    std::atomic<bool>       m_running{false};
+    std::atomic<bool>       m_registered{false};
+    std::atomic<quint8>     m_gear{0};
+    std::atomic<quint32>    m_gearRequests{0};
+    std::atomic<quint32>    m_gearAnswered{0};
+    std::atomic<quint32>    m_gearDropped{0};
+    quint64                 m_totalSent    = 0;   // publisher 스레드 전용 (stop()은 join 후 읽는다)
+    quint64                 m_totalSkipped = 0;
+};
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("hu_cluster_standin");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Headless Instrument Cluster stand-in (SOME/IP load generator)");
+    parser.addHelpOption();
+    QCommandLineOption rateOpt("rate-hz", "Vehicle state publish rate (10 - 2000).", "hz", "100");
+    QCommandLineOption jitterOpt("jitter", "Jitter profile: none, uniform, burst, drop.", "profile", "none");
+    QCommandLineOption jitterUsOpt("jitter-us", "Uniform jitter amplitude (+/- us).", "us", "500");
+    QCommandLineOption burstOpt("burst", "Burst size for the burst profile.", "n", "8");
+    QCommandLineOption dropOpt("drop-pct", "Drop probability for the drop profile.", "pct", "1");
+    QCommandLineOption durationOpt("duration-s", "Run time (0 = until killed).", "s", "0");
+    QCommandLineOption gearDelayOpt("gear-delay-ms", "Delay before answering gear requests.", "ms", "0");
+    QCommandLineOption gearDropOpt("gear-drop", "Ignore every Nth gear request (0 = never).", "n", "0");
+    QCommandLineOption noLegacyOpt("no-legacy", "Do not publish legacy 0x8001 speed.");
+    QCommandLineOption replayOpt("replay", "Replay a .hutl log instead of synthetic signals.", "file");
+    QCommandLineOption canOutOpt("can-out", "CAN interface for replayed frames (e.g. vcan0).", "if");
+    QCommandLineOption speedOpt("speed", "Replay speed factor (1 = real time, 0 = max).", "x", "1");
+    QCommandLineOption startDelayOpt("start-delay-ms", "Wait before replaying (HU subscribe time).", "ms", "1000");
+    parser.addOptions({rateOpt, jitterOpt, jitterUsOpt, burstOpt, dropOpt, durationOpt,
+                       gearDelayOpt, gearDropOpt, noLegacyOpt,
+                       replayOpt, canOutOpt, speedOpt, startDelayOpt});
+    parser.process(app);
+
+    Options opt;
+    opt.rateHz      = qBound(10, parser.value(rateOpt).toInt(), 2000);
+    opt.jitterUs    = qMax(0, parser.value(jitterUsOpt).toInt());
+    opt.burst       = qMax(1, parser.value(burstOpt).toInt());
+    opt.dropPct     = qBound(0.0, parser.value(dropOpt).toDouble(), 100.0);
+    opt.durationS   = qMax(0, parser.value(durationOpt).toInt());
+    opt.gearDelayMs = qMax(0, parser.value(gearDelayOpt).toInt());
+    opt.gearDrop    = qMax(0, parser.value(gearDropOpt).toInt());
+    opt.legacy      = !parser.isSet(noLegacyOpt);
+    opt.replay       = parser.value(replayOpt);
+    opt.canOut       = parser.value(canOutOpt).trimmed();
+    opt.speed        = qMax(0.0, parser.value(speedOpt).toDouble());
+    opt.startDelayMs = qMax(0, parser.value(startDelayOpt).toInt());
+    const QString jitter = parser.value(jitterOpt).trimmed().toLower();
+    if (jitter == QStringLiteral("uniform")) opt.jitter = Jitter::Uniform;
+    else if (jitter == QStringLiteral("burst")) opt.jitter = Jitter::Burst;
+    else if (jitter == QStringLiteral("drop"))  opt.jitter = Jitter::Drop;
+
+    ClusterStandIn standIn(opt);
+    if (!standIn.start())
+        return 2;
+    if (opt.durationS > 0)
+        QTimer::singleShot(opt.durationS * 1000, &app, &QCoreApplication::quit);
+
+    const int rc = app.exec();
+    standIn.stop();
+    return rc;
+}
@@ -0,0 +1,370 @@
+/**
+ * @file pdc_eval.cpp
+ * @brief PDC 예측 경고(PdcFilter) 오프라인 평가 — 녹화된 .hutl 세션을 재생해 기존 경로와 비교
+ *
+ * 같은 CAN 프레임열을 두 경로로 돌린다 (후진 중, 차속 게이트 포함):
+ *   baseline   : 프레임마다 raw 최근접 거리 → levelForDistance (필터 이전 동작)
+ *   predictive : PdcFilter — 프레임마다 update, 그리고 프레임 사이 50 ms마다 estimate
+ *                (PdcController의 stale 검사 타이머 / RT 리더 스레드의 예측 갱신과 같은 주기)
+ * 단계가 올라가는 시점을 비교한다:
+ *   lead        baseline이 올린 단계를 predictive가 얼마나 먼저 올렸나 (ms, 음수 = late)
+ *   held        predictive는 horizon보다 오래 그 단계였음 — baseline이 튀는 값으로 잠깐 내려갔다 복귀
+ *   suppressed  baseline만 올리고 predictive는 horizon 안에 따라가지 않은 것 — 가까운 쪽 튐은
+ *               단계를 올리면 필터도 바로 따르므로(PdcFilter.h 비대칭 규칙) 0이 정상이다
+ *   false alarm predictive가 올렸는데 baseline이 horizon 안에 같은 단계에 도달하지 않은 것
+ * 속도는 0x123 B0 (CanSignals::kSpeedKmh)에서 읽는다.
+ *
+ * 사용법:
+ *   hu_pdc_eval session.hutl [more.hutl ...] [--horizon-ms 500] [--max-false-alarms 0]
+ *   hu_pdc_eval --synthetic [--write synthetic.hutl]     # 노이즈/튀는 값이 섞인 후진 접근 시나리오
+ * 종료 코드: false alarm이 --max-false-alarms보다 많거나 평균 lead가 음수면 1
+ */
+
+#include "CanSignals.h"
+#include "PdcFilter.h"
+#include "PdcSensorMonitor.h"
+#include "PdcWarning.h"
+#include "SocketCanPdcProvider.h"
+#include "TrafficLog.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+constexpr quint64 kMs = 1000000ull;
+constexpr quint64 kTickNs = PdcSensorMonitor::kTickNs;       // PdcController 검사 주기
+constexpr quint64 kStaleNs = PdcSensorMonitor::kTimeoutNs;   // 센서 timeout
+
+struct CanEvent {
+    quint64 timeNs;
+    can_frame frame;
+};
+
+struct LevelChange {
+    quint64 timeNs;
+    PdcWarningLevel level;
+};
+
+using Trace = std::vector<LevelChange>;
+
+bool loadLog(const QString &path, std::vector<CanEvent> &out)
+{
+    TrafficLogReader reader;
+    if (!reader.open(path)) {
+        std::fprintf(stderr, "%s: %s\n", qPrintable(path), qPrintable(reader.errorString()));
+        return false;
+    }
+    TrafficRecord rec;
+    while (reader.next(rec)) {
+        if (rec.kind != TrafficRecord::Can)
+            continue;
+        CanEvent ev{};
+        ev.timeNs = rec.timeNs;
+        ev.frame.can_id = rec.canId;
+        ev.frame.can_dlc = qMin<quint8>(rec.length, CAN_MAX_DLEN);
+        std::memcpy(ev.frame.data, rec.data, ev.frame.can_dlc);
+        out.push_back(ev);
+    }
+    return true;
+}
+
+/**
+ * 0x123 (B0 속도, B1 거리) 5 Hz — 실차 캡처와 같은 모양.
+ * 1 / 3 / 6 km/h로 벽에 250 cm에서 접근 → 25 cm 정지 2초 → 이탈, 측정 노이즈 ±3 cm,
+ * 2% 확률로 한 프레임짜리 튀는 값.
+ */
+std::vector<CanEvent> synthesize()
+{
+    std::vector<CanEvent> events;
+    quint32 rng = 12345;
+    auto rand01 = [&rng]() {
+        rng = rng * 1664525u + 1013904223u;
+        return float(rng >> 8) / float(1u << 24);
+    };
+
+    quint64 t = 0;
+    for (const float speedKmh : { 1.0f, 3.0f, 6.0f }) {
+        const float cmPerS = speedKmh * 100000.0f / 3600.0f;
+        float distance = 250.0f;
+        float holdS = 0.0f;
+        int phase = 0;   // 0 접근, 1 정지, 2 이탈
+        while (phase < 3) {
+            float speed = 0.0f;
+            if (phase == 0) {
+                speed = speedKmh;
+                distance -= cmPerS * 0.2f;
+                if (distance <= 25.0f) { distance = 25.0f; phase = 1; }
+            } else if (phase == 1) {
+                holdS += 0.2f;
+                if (holdS >= 2.0f) phase = 2;
+            } else {
+                speed = speedKmh;
+                distance += cmPerS * 0.2f;
+                if (distance >= 250.0f) phase = 3;
+            }
+
+            float measured = distance + (rand01() - 0.5f) * 6.0f;
+            if (rand01() < 0.02f)
+                measured = 5.0f + rand01() * 250.0f;
+
+            CanEvent ev{};
+            ev.timeNs = t;
+            ev.frame.can_id = CanSignals::kSpeedKmh.canId;
+            ev.frame.can_dlc = 8;
+            ev.frame.data[0] = static_cast<__u8>(qBound(0.0f, speed + 0.5f, 255.0f));
+            ev.frame.data[1] = static_cast<__u8>(qBound(0.0f, measured + 0.5f, 255.0f));
+            events.push_back(ev);
+            t += 200 * kMs;
+        }
+        t += 1000 * kMs;   // 시나리오 사이 무수신 → stale
+    }
+    return events;
+}
+
+void setLevel(Trace &trace, quint64 timeNs, PdcWarningLevel level)
+{
+    if (trace.empty() || trace.back().level != level)
+        trace.push_back({ timeNs, level });
+}
+
+PdcWarningLevel levelAt(const Trace &trace, quint64 timeNs)
+{
+    auto it = std::upper_bound(trace.begin(), trace.end(), timeNs,
+                               [](quint64 t, const LevelChange &c) { return t < c.timeNs; });
+    return it == trace.begin() ? PdcWarningLevel::Off : std::prev(it)->level;
+}
+
+/** (fromNs, toNs] 안에서 처음으로 level 이상이 되는 시각, 없으면 0 */
+quint64 firstReach(const Trace &trace, quint64 fromNs, quint64 toNs, PdcWarningLevel level)
+{
+    for (const LevelChange &c : trace) {
+        if (c.timeNs > fromNs && c.timeNs <= toNs && c.level >= level)
+            return c.timeNs;
+    }
+    return 0;
+}
+
+/** timeNs에 level 이상인 구간이 시작된 시각 (timeNs에 level 이상이어야 한다) */
+quint64 reachedSince(const Trace &trace, quint64 timeNs, PdcWarningLevel level)
+{
+    quint64 since = timeNs;
+    PdcWarningLevel previous = PdcWarningLevel::Off;
+    for (const LevelChange &c : trace) {
+        if (c.timeNs > timeNs)
+            break;
+        if (c.level >= level && previous < level)
+            since = c.timeNs;
+        previous = c.level;
+    }
+    return since;
+}
+
+/** baseline / predictive 단계 변화를 기록 — HU와 같은 함수(decodeFrame, PdcFilter, PdcWarning) 사용 */
+void simulate(const std::vector<CanEvent> &events, Trace &baseline, Trace &predictive,
+              PdcFilter::Stats &filterStats)
+{
+    PdcFilter filter;
+    float speedKmh = 0.0f;
+    quint8 validMask = 0xFF;    // 0x351 (녹화에 있으면)
+    quint64 validMaskNs = 0;
+    quint64 lastSampleNs = 0;
+    bool haveSample = false;
+
+    auto evaluate = [&](quint64 nowNs) {
+        if (haveSample && nowNs - lastSampleNs > kStaleNs) {
+            haveSample = false;
+            filter.reset();
+            setLevel(baseline, lastSampleNs + kStaleNs, PdcWarningLevel::Off);
+            setLevel(predictive, lastSampleNs + kStaleNs, PdcWarningLevel::Off);
+        }
+        if (haveSample) {
+            setLevel(predictive, nowNs, PdcWarning::gatedLevel(
+                PdcWarning::levelForDistance(filter.estimate(nowNs).warningCm), true, speedKmh));
+        }
+    };
+
+    quint64 nextTickNs = 0;
+    for (const CanEvent &ev : events) {
+        while (haveSample && nextTickNs < ev.timeNs) {
+            evaluate(nextTickNs);
+            nextTickNs += kTickNs;
+        }
+
+        if ((ev.frame.can_id & CAN_EFF_MASK) == CanSignals::kSpeedKmh.canId
+            && ev.frame.can_dlc >= CanSignals::requiredDlc(CanSignals::kSpeedKmh)) {
+            speedKmh = CanSignals::decode<CanSignals::kSpeedKmh>(ev.frame.data);
+        }
+
+        if (SocketCanPdcProvider::decodeValidityFrame(ev.frame, validMask)) {
+            validMaskNs = ev.timeNs;
+            continue;
+        }
+
+        PdcSample sample;
+        if (!SocketCanPdcProvider::decodeFrame(ev.frame, ev.timeNs, sample,
+                SocketCanPdcProvider::effectiveValidMask(validMask, validMaskNs, ev.timeNs)))
+            continue;
+
+        evaluate(ev.timeNs);   // 직전 sample이 stale이 됐는지 먼저
+        filter.setVehicleSpeed(speedKmh);
+        filter.update(sample, ev.timeNs);
+        lastSampleNs = ev.timeNs;
+        haveSample = true;
+        setLevel(baseline, ev.timeNs, PdcWarning::gatedLevel(
+            PdcWarning::levelForDistance(PdcWarning::nearestCm(sample)), true, speedKmh));
+        evaluate(ev.timeNs);
+        nextTickNs = ev.timeNs + kTickNs;
+    }
+    if (haveSample)
+        evaluate(lastSampleNs + kStaleNs + 1);
+    filterStats = filter.stats();
+}
+
+struct LevelReport {
+    int raised = 0;            // baseline 상승 횟수
+    int early = 0;             // predictive가 같거나 먼저
+    int held = 0;
+    int late = 0;
+    int suppressed = 0;
+    int falseAlarms = 0;
+    std::vector<qint64> leadMs;
+};
+
+double percentile(std::vector<qint64> v, double p)
+{
+    if (v.empty())
+        return 0.0;
+    std::sort(v.begin(), v.end());
+    return double(v[static_cast<size_t>(p * (v.size() - 1))]);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("hu_pdc_eval");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Offline evaluation of predictive PDC warnings on recorded CAN logs");
+    parser.addHelpOption();
+    parser.addPositionalArgument("logs", "Recorded .hutl sessions (hu_traffic_record).", "[logs...]");
+    QCommandLineOption syntheticOpt("synthetic", "Evaluate a generated approach/stop/leave scenario.");
+    QCommandLineOption writeOpt("write", "Write the synthetic scenario as .hutl (for --replay).", "path");
+    QCommandLineOption horizonOpt("horizon-ms", "Confirmation window for lead / false alarms.", "ms", "500");
+    QCommandLineOption maxFalseOpt("max-false-alarms", "Fail above this many false alarms.", "n", "0");
+    parser.addOptions({syntheticOpt, writeOpt, horizonOpt, maxFalseOpt});
+    parser.process(app);
+
+    std::vector<CanEvent> events;
+    if (parser.isSet(syntheticOpt)) {
+        events = synthesize();
+        if (parser.isSet(writeOpt)) {
+            TrafficLogWriter writer;
+            if (!writer.open(parser.value(writeOpt))) {
+                std::fprintf(stderr, "write: %s\n", qPrintable(writer.errorString()));
+                return 2;
+            }
+            for (const CanEvent &ev : events)
+                writer.writeCan(ev.timeNs, ev.frame.can_id, ev.frame.data, ev.frame.can_dlc);
+        }
+    }
+    for (const QString &path : parser.positionalArguments()) {
+        // 세션을 이어 붙일 때는 사이에 stale 구간을 둔다
+        const quint64 offset = events.empty() ? 0 : events.back().timeNs + 10 * kStaleNs;
+        std::vector<CanEvent> session;
+        if (!loadLog(path, session))
+            return 2;
+        for (CanEvent &ev : session) {
+            ev.timeNs += offset;
+            events.push_back(ev);
+        }
+    }
+    if (events.empty()) {
+        parser.showHelp(2);
+    }
+
+    const quint64 horizonNs = parser.value(horizonOpt).toULongLong() * kMs;
+    Trace baseline, predictive;
+    PdcFilter::Stats filterStats;
+    simulate(events, baseline, predictive, filterStats);
+
+    // 인덱스 = PdcWarningLevel (Near, Caution, Critical만 보고)
+    LevelReport report[5];
+    for (size_t i = 0; i < baseline.size(); ++i) {
+        const LevelChange &c = baseline[i];
+        const PdcWarningLevel before = i ? baseline[i - 1].level : PdcWarningLevel::Off;
+        for (int l = int(before) + 1; l <= int(c.level); ++l) {
+            const PdcWarningLevel level = static_cast<PdcWarningLevel>(l);
+            if (level < PdcWarningLevel::Near)
+                continue;
+            LevelReport &r = report[l];
+            ++r.raised;
+            if (levelAt(predictive, c.timeNs) >= level) {
+                const quint64 since = reachedSince(predictive, c.timeNs, level);
+                if (c.timeNs - since > horizonNs) {
+                    ++r.held;
+                } else {
+                    ++r.early;
+                    r.leadMs.push_back(qint64((c.timeNs - since) / kMs));
+                }
+            } else if (const quint64 t = firstReach(predictive, c.timeNs, c.timeNs + horizonNs, level)) {
+                ++r.late;
+                r.leadMs.push_back(-qint64((t - c.timeNs) / kMs));
+            } else {
+                ++r.suppressed;
+            }
+        }
+    }
+    for (size_t i = 0; i < predictive.size(); ++i) {
+        const LevelChange &c = predictive[i];
+        const PdcWarningLevel before = i ? predictive[i - 1].level : PdcWarningLevel::Off;
+        for (int l = qMax(int(before) + 1, int(PdcWarningLevel::Near)); l <= int(c.level); ++l) {
+            const PdcWarningLevel level = static_cast<PdcWarningLevel>(l);
+            if (levelAt(baseline, c.timeNs) < level
+                && !firstReach(baseline, c.timeNs, c.timeNs + horizonNs, level)) {
+                ++report[l].falseAlarms;
+            }
+        }
+    }
+
+    std::printf("== PDC predictive warnings (%zu CAN frames, horizon %llu ms) ==\n",
+                events.size(), static_cast<unsigned long long>(horizonNs / kMs));
+    std::printf("  filter: %llu samples, %llu outlier measurements replaced, %llu track restarts\n",
+                static_cast<unsigned long long>(filterStats.samples),
+                static_cast<unsigned long long>(filterStats.outliers),
+                static_cast<unsigned long long>(filterStats.restarts));
+    std::printf("  %-9s %7s %6s %5s %5s %10s %12s %12s %10s %12s\n", "level", "raised", "early", "held",
+                "late", "suppressed", "lead p50 ms", "lead mean ms", "lead max", "false alarm");
+
+    int falseAlarms = 0;
+    double leadSum = 0.0;
+    size_t leadCount = 0;
+    const char *names[] = { "off", "far", "near", "caution", "critical" };
+    for (int l = int(PdcWarningLevel::Near); l <= int(PdcWarningLevel::Critical); ++l) {
+        const LevelReport &r = report[l];
+        double mean = 0.0;
+        for (qint64 v : r.leadMs)
+            mean += double(v);
+        leadSum += mean;
+        leadCount += r.leadMs.size();
+        mean = r.leadMs.empty() ? 0.0 : mean / double(r.leadMs.size());
+        falseAlarms += r.falseAlarms;
+        std::printf("  %-9s %7d %6d %5d %5d %10d %12.0f %12.0f %10.0f %12d\n", names[l], r.raised, r.early,
+                    r.held, r.late, r.suppressed, percentile(r.leadMs, 0.5), mean, percentile(r.leadMs, 1.0),
+                    r.falseAlarms);
+    }
+
+    const int maxFalse = parser.value(maxFalseOpt).toInt();
+    const double meanLead = leadCount ? leadSum / double(leadCount) : 0.0;
+    const bool pass = falseAlarms <= maxFalse && meanLead >= 0.0;
+    std::printf("\nmean lead %.0f ms, %d false alarms (max %d): %s\n",
+                meanLead, falseAlarms, maxFalse, pass ? "PASS" : "FAIL");
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,197 @@
+/**
+ * @file traffic_record.cpp
+ * @brief 실차 CAN / SOME/IP 트래픽 녹화기 (.hutl, TrafficLog.h)
+ *
+ * - CAN   : --can 인터페이스(기본 can0)의 --ids 프레임만 (CAN_RAW_FILTER, 기본 = SocketCanPdcProvider::canIds())
+ *           0x123 = 속도(SerialReader) + 단일 초음파, 0x350 = 후방 4채널 PDC, 0x351 = 센서 valid bitmask
+ * - SOME/IP: --someip 이면 0x1234/0x0001의 0x8001 speed, 0x8004 vehicle state 이벤트를 구독해 기록
+ *            (vsomeip 빌드에서만, HU와 같은 routing 설정으로 실행)
+ * 수신 시각은 CLOCK_MONOTONIC 기준. CAN은 CanBatchReader의 커널 수신 시각(SO_TIMESTAMPING, CLOCK_REALTIME)을
+ * 깨어난 시점의 realtime → monotonic 차이로 옮겨 쓴다 — 프로세스 스케줄링 지연이 녹화 간격에 섞이지 않는다.
+ * SOME/IP는 vsomeip 핸들러 시점의 user-space 시각. 1초마다 누적 레코드 수를 출력한다.
+ *
+ * 사용법:
+ *   hu_traffic_record --out session.hutl [--can can0] [--ids 0x123,0x350,0x351] [--someip]
+ *                     [--duration-s 0]
+ * 재생: hu_cluster_standin --replay session.hutl --can-out vcan0 [--speed 1|N|0(max)]
+ */
+
+#include "TrafficLog.h"
+#include "CanBatchReader.h"
+#include "SocketCanPdcProvider.h"
+
+#ifdef HU_HAS_VSOMEIP
+#include "VehicleStateEvent.h"
+#include <vsomeip/vsomeip.hpp>
+#include <atomic>
+#include <set>
+#include <thread>
+#endif
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QSocketNotifier>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+
+#include <cstdio>
+#include <ctime>
+
+namespace {
+
+quint64 monoNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return quint64(ts.tv_sec) * 1000000000ull + quint64(ts.tv_nsec);
+}
+
+/** HU가 실제로 받는 CAN ID — "0x123,0x350,0x351" */
+QString defaultCanIds()
+{
+    QStringList ids;
+    for (quint32 id : SocketCanPdcProvider::canIds())
+        ids << QStringLiteral("0x%1").arg(id, 0, 16);
+    return ids.join(',');
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("hu_traffic_record");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Record CAN / SOME/IP traffic into a .hutl log");
+    parser.addHelpOption();
+    QCommandLineOption outOpt("out", "Output .hutl file.", "file");
+    QCommandLineOption canOpt("can", "CAN interface (empty = no CAN).", "if", "can0");
+    QCommandLineOption idsOpt("ids", "CAN ids to record (comma separated, empty = all).", "list", defaultCanIds());
+    QCommandLineOption someipOpt("someip", "Also record SOME/IP events 0x8001 / 0x8004.");
+    QCommandLineOption durationOpt("duration-s", "Recording time (0 = until killed).", "s", "0");
+    parser.addOptions({outOpt, canOpt, idsOpt, someipOpt, durationOpt});
+    parser.process(app);
+
+    if (!parser.isSet(outOpt)) {
+        std::fprintf(stderr, "--out is required\n");
+        return 2;
+    }
+    TrafficLogWriter log;
+    if (!log.open(parser.value(outOpt))) {
+        std::fprintf(stderr, "cannot open %s: %s\n",
+                     qPrintable(parser.value(outOpt)), qPrintable(log.errorString()));
+        return 2;
+    }
+
+    // ── CAN ──
+    QVector<quint32> ids;
+    for (const QString &part : parser.value(idsOpt).split(',')) {
+        bool ok = false;
+        const quint32 id = part.trimmed().toUInt(&ok, 0);
+        if (ok) ids << id;
+    }
+    const QString canIf = parser.value(canOpt).trimmed();
+    CanBatchReader can;
+    quint64 canFrames = 0;
+    if (!canIf.isEmpty()) {
+        QString error;
+        if (!can.open(canIf, ids, 0, &error)) {
+            std::fprintf(stderr, "cannot open CAN interface %s: %s\n", qPrintable(canIf), qPrintable(error));
+            return 2;
+        }
+        if (can.stampSource() == CanBatchReader::StampSource::UserSpace)
+            std::fprintf(stderr, "no kernel CAN timestamps on %s - using user-space receive time\n",
+                         qPrintable(canIf));
+        auto *notifier = new QSocketNotifier(can.fd(), QSocketNotifier::Read, &app);
+        QObject::connect(notifier, &QSocketNotifier::activated, [&, notifier] {
+            // 커널 시각은 CLOCK_REALTIME — 이번 wakeup의 두 시계 차이로 로그 기준(monotonic)에 옮긴다
+            const qint64 realToMonoNs = qint64(monoNs()) - qint64(CanBatchReader::realtimeNowNs());
+            const int n = can.drain([&](const CanBatchReader::Frame &rx) {
+                log.writeCan(quint64(qint64(rx.rxRealtimeNs) + realToMonoNs), rx.frame.can_id,
+                             rx.frame.data, qMin<quint8>(rx.frame.can_dlc, CAN_MAX_DLEN));
+                ++canFrames;
+                return true;
+            });
+            if (n < 0) {
+                std::fprintf(stderr, "CAN read error on %s - stopping\n", qPrintable(canIf));
+                notifier->setEnabled(false);
+                QCoreApplication::exit(1);
+            }
+        });
+    }
+
+    // ── SOME/IP ──
+    quint64 someipEvents = 0;
+#ifdef HU_HAS_VSOMEIP
+    std::shared_ptr<vsomeip::application> someip;
+    std::thread someipThread;
+    std::atomic<quint64> someipCount{0};
+    if (parser.isSet(someipOpt)) {
+        constexpr vsomeip::service_t    kServiceId  = 0x1234;
+        constexpr vsomeip::instance_t   kInstanceId = 0x0001;
+        constexpr vsomeip::eventgroup_t kGroupId    = 0x0001;
+        const vsomeip::event_t events[] = { 0x8001, VehicleStateEvent::kEventId };
+
+        someip = vsomeip::runtime::get()->create_application("HuTrafficRecorder");
+        if (!someip || !someip->init()) {
+            std::fprintf(stderr, "vsomeip init failed\n");
+            return 2;
+        }
+        for (vsomeip::event_t ev : events) {
+            someip->request_event(kServiceId, kInstanceId, ev, {kGroupId},
+                                  vsomeip::event_type_e::ET_FIELD);
+            someip->register_message_handler(kServiceId, kInstanceId, ev,
+                [&log, &someipCount](const std::shared_ptr<vsomeip::message> &msg) {
+                    const auto pl = msg->get_payload();
+                    if (!pl) return;
+                    const quint8 len = static_cast<quint8>(qMin<vsomeip::length_t>(pl->get_length(), 255));
+                    log.writeSomeIp(monoNs(), msg->get_service(), msg->get_instance(),
+                                    msg->get_method(), pl->get_data(), len);
+                    ++someipCount;
+                });
+        }
+        someip->register_state_handler([someip](vsomeip::state_type_e state) {
+            if (state != vsomeip::state_type_e::ST_REGISTERED) return;
+            someip->subscribe(kServiceId, kInstanceId, kGroupId);
+            someip->request_service(kServiceId, kInstanceId);
+        });
+        someipThread = std::thread([someip] { someip->start(); });
+    }
+#else
+    if (parser.isSet(someipOpt))
+        std::fprintf(stderr, "built without vsomeip - recording CAN only\n");
+#endif
+
+    QTimer status;
+    status.setInterval(1000);
+    QObject::connect(&status, &QTimer::timeout, [&] {
+#ifdef HU_HAS_VSOMEIP
+        someipEvents = someipCount.load();
+#endif
+        std::printf("[record] %llu records (CAN %llu, SOME/IP %llu)\n",
+                    static_cast<unsigned long long>(log.records()),
+                    static_cast<unsigned long long>(canFrames),
+                    static_cast<unsigned long long>(someipEvents));
+        std::fflush(stdout);
+    });
+    status.start();
+
+    const int durationS = qMax(0, parser.value(durationOpt).toInt());
+    if (durationS > 0)
+        QTimer::singleShot(durationS * 1000, &app, &QCoreApplication::quit);
+    const int rc = app.exec();
+
+#ifdef HU_HAS_VSOMEIP
+    if (someip) {
+        someip->stop();
+        if (someipThread.joinable()) someipThread.join();
+    }
+#endif
+    can.close();
+    log.close();
+    std::printf("[record] wrote %llu records to %s\n",
+                static_cast<unsigned long long>(log.records()), qPrintable(parser.value(outOpt)));
+    return rc;
+}
@@ -17,9 +17,21 @@ public:
     virtual void stop() = 0;
     virtual bool isAvailable() const = 0;
 
+    /**
+     * 경고 게이트(후진 여부 / 차속). PdcController가 바뀔 때마다 넘긴다.
+     * 경고 단계를 직접 계산하는 provider(RT 리더 스레드)만 쓴다.
+     */
+    virtual void setWarningGate(bool active, float speedKmh) { Q_UNUSED(active); Q_UNUSED(speedKmh); }
+    /** true면 warningLevelChanged를 내보낸다 — 경보음은 PdcController 대신 이것을 따른다 */
+    virtual bool publishesWarningLevel() const { return false; }
+
 signals:
-    void readingsChanged(const QVector<PdcSensorReading> &readings);
+    void sampleReady(const PdcSample &sample);
     void faultChanged(const QString &message);
+    /** GUI가 아닌 스레드에서 emit될 수 있다 (stale / fault 시 Off 포함) */
+    void warningLevelChanged(PdcWarningLevel level);
+    /** GUI 스레드 — publishesWarningLevel()이 바뀌었다 (리더 스레드가 죽으면 false: PdcController 경로로 돌아갈 것) */
+    void warningLevelPublishingChanged(bool publishes);
 };
 
 #endif // IPDCSENSORPROVIDER_H
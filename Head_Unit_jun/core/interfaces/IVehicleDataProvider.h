@@ -22,6 +22,17 @@ enum class GearState : quint8 {
     D = 3
 };
 
+/**
+ * 기어 요청 전달 상태 (클러스터 응답 기준)
+ *   Idle: 요청 없음 / Pending: 응답 대기 / Acknowledged: 클러스터가 반영 / Failed: 예산 초과 또는 다른 기어
+ */
+enum class GearAckState : quint8 {
+    Idle = 0,
+    Pending,
+    Acknowledged,
+    Failed
+};
+
 /**
  * @class IVehicleDataProvider
  * @brief Abstract interface - replace with VSomeIPClient for production
@@ -0,0 +1,172 @@
+/**
+ * @file CanBatchReader.cpp
+ */
+
+#include "CanBatchReader.h"
+
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+
+#include <linux/can/raw.h>
+#include <linux/net_tstamp.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace {
+quint64 toNs(const timespec &ts)
+{
+    return quint64(ts.tv_sec) * 1000000000ull + quint64(ts.tv_nsec);
+}
+} // namespace
+
+quint64 CanBatchReader::realtimeNowNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return toNs(ts);
+}
+
+bool CanBatchReader::open(const QString &ifName, const QVector<quint32> &ids,
+                          can_err_mask_t errorMask, QString *error)
+{
+    close();
+
+    m_fd = ::socket(PF_CAN, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, CAN_RAW);
+    if (m_fd < 0) {
+        if (error) *error = QStringLiteral("Failed to create CAN socket");
+        return false;
+    }
+
+    struct ifreq ifr;
+    std::memset(&ifr, 0, sizeof(ifr));
+    std::strncpy(ifr.ifr_name, ifName.toLatin1().constData(), IFNAMSIZ - 1);
+    if (::ioctl(m_fd, SIOCGIFINDEX, &ifr) < 0) {
+        if (error) *error = QStringLiteral("Failed to resolve %1").arg(ifName);
+        close();
+        return false;
+    }
+
+    // 필터는 bind 전에 — bind와 setsockopt 사이에 다른 ID가 큐에 들어오지 않게
+    if (!ids.isEmpty()) {
+        QVector<can_filter> filters;
+        filters.reserve(ids.size());
+        for (quint32 id : ids) {
+            // EFF/RTR 비트도 마스크에 넣어 11-bit 데이터 프레임만 통과
+            filters.push_back(can_filter{ id & CAN_SFF_MASK, CAN_SFF_MASK | CAN_EFF_FLAG | CAN_RTR_FLAG });
+        }
+        if (::setsockopt(m_fd, SOL_CAN_RAW, CAN_RAW_FILTER, filters.constData(),
+                         static_cast<socklen_t>(filters.size() * sizeof(can_filter))) < 0) {
+            if (error) *error = QStringLiteral("Failed to set CAN filter on %1").arg(ifName);
+            close();
+            return false;
+        }
+    }
+    if (errorMask != 0) {
+        // 실패해도 데이터 수신에는 영향 없다 — 에러 프레임만 못 받는다
+        ::setsockopt(m_fd, SOL_CAN_RAW, CAN_RAW_ERR_FILTER, &errorMask, sizeof(errorMask));
+    }
+
+    struct sockaddr_can addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.can_family = AF_CAN;
+    addr.can_ifindex = ifr.ifr_ifindex;
+    if (::bind(m_fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0) {
+        if (error) *error = QStringLiteral("Failed to bind CAN socket to %1").arg(ifName);
+        close();
+        return false;
+    }
+
+    // 커널 수신 시각: SO_TIMESTAMPING → SO_TIMESTAMPNS → user-space
+    const int tsFlags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+    const int on = 1;
+    if (::setsockopt(m_fd, SOL_SOCKET, SO_TIMESTAMPING, &tsFlags, sizeof(tsFlags)) == 0)
+        m_stampSource = StampSource::Timestamping;
+    else if (::setsockopt(m_fd, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on)) == 0)
+        m_stampSource = StampSource::TimestampNs;
+    else
+        m_stampSource = StampSource::UserSpace;
+
+    for (int i = 0; i < kBatch; ++i) {
+        m_iov[i].iov_base = &m_frames[i].frame;
+        m_iov[i].iov_len  = sizeof(can_frame);
+    }
+    m_stats  = Stats{};
+    m_errors = 0;
+    return true;
+}
+
+void CanBatchReader::close()
+{
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
+
+int CanBatchReader::readBatch(int *received)
+{
+    *received = 0;
+    if (m_fd < 0)
+        return -1;
+
+    // recvmmsg가 msg_controllen / msg_len을 덮어쓰므로 매번 다시 채운다
+    for (int i = 0; i < kBatch; ++i) {
+        msghdr &hdr = m_msgs[i].msg_hdr;
+        std::memset(&hdr, 0, sizeof(hdr));
+        hdr.msg_iov        = &m_iov[i];
+        hdr.msg_iovlen     = 1;
+        hdr.msg_control    = m_control[i];
+        hdr.msg_controllen = sizeof(m_control[i]);
+        m_msgs[i].msg_len  = 0;
+    }
+
+    int n;
+    do {
+        n = ::recvmmsg(m_fd, m_msgs, kBatch, MSG_DONTWAIT, nullptr);
+    } while (n < 0 && errno == EINTR);
+    ++m_stats.syscalls;
+    if (n < 0)
+        return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+    *received = n;
+
+    quint64 userNs = 0;
+    int kept = 0;
+    int dataFrames = 0;   // 에러 프레임은 drain()이 errorFrames로 따로 센다
+    for (int i = 0; i < n; ++i) {
+        if (m_msgs[i].msg_len < sizeof(can_frame))
+            continue;   // CAN FD 프레임 등 — 이 소켓은 classic CAN만 받는다
+
+        quint64 stamp = 0;
+        for (cmsghdr *c = CMSG_FIRSTHDR(&m_msgs[i].msg_hdr); c;
+             c = CMSG_NXTHDR(&m_msgs[i].msg_hdr, c)) {
+            if (c->cmsg_level != SOL_SOCKET)
+                continue;
+            if (c->cmsg_type == SO_TIMESTAMPING) {        // scm_timestamping: ts[0] = software
+                timespec ts[3];
+                std::memcpy(ts, CMSG_DATA(c), sizeof(ts));
+                stamp = toNs(ts[0]);
+            } else if (c->cmsg_type == SO_TIMESTAMPNS) {
+                timespec ts;
+                std::memcpy(&ts, CMSG_DATA(c), sizeof(ts));
+                stamp = toNs(ts);
+            }
+        }
+        if (stamp == 0) {
+            if (userNs == 0)
+                userNs = realtimeNowNs();
+            stamp = userNs;
+            ++m_stats.userStamped;
+        }
+
+        if (kept != i)
+            m_frames[kept].frame = m_frames[i].frame;
+        m_frames[kept].rxRealtimeNs = stamp;
+        if (!(m_frames[kept].frame.can_id & CAN_ERR_FLAG))
+            ++dataFrames;
+        ++kept;
+    }
+    m_stats.frames += quint64(dataFrames);
+    return kept;
+}
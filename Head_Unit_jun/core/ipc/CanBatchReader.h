@@ -0,0 +1,122 @@
+/**
+ * @file CanBatchReader.h
+ * @brief SocketCAN 수신 헬퍼 — 깨어날 때마다 recvmmsg로 밀린 프레임을 모두 읽고 커널 수신 시각을 붙인다
+ *
+ * SocketCanPdcProvider(HU)와 SerialReader(클러스터)가 같이 쓴다. Qt에 의존하지 않는다 —
+ * 소켓 fd를 QSocketNotifier에 걸고, activated에서 drain()을 부르면 된다.
+ *
+ *   - 소켓은 non-blocking. drain()은 EAGAIN까지 kBatch개씩 recvmmsg (syscall 1번에 최대 32 프레임)
+ *   - SO_TIMESTAMPING(RX_SOFTWARE)으로 커널이 프레임을 받은 시각(CLOCK_REALTIME)을 같이 받는다.
+ *     커널이 지원하지 않으면 SO_TIMESTAMPNS, 그것도 안 되면 읽은 시점의 user-space 시각을 쓴다.
+ *   - Frame::rxRealtimeNs - realtimeNowNs() = 데이터 나이 (커널 수신 → 소비자 처리)
+ *   - 소비자가 선언한 CAN ID만 CAN_RAW_FILTER로 커널에서 거른다 — 다른 ID는 프로세스를 깨우지 않는다.
+ *     에러 프레임은 CAN_RAW_ERR_FILTER(errorMask)로 받아 onFrame에 넘기지 않고 takeErrors()로 모은다.
+ */
+
+#ifndef CANBATCHREADER_H
+#define CANBATCHREADER_H
+
+#include <QtGlobal>
+#include <QString>
+
+#include <QVector>
+
+#include <linux/can.h>
+#include <linux/can/error.h>
+#include <sys/socket.h>
+
+class CanBatchReader
+{
+public:
+    static constexpr int kBatch = 32;
+
+    struct Frame {
+        can_frame frame;
+        quint64   rxRealtimeNs;   // 커널 수신 시각 (CLOCK_REALTIME)
+    };
+
+    /** 기본 에러 마스크: 컨트롤러 상태(error passive/warning), bus-off, TX timeout, 재시작 */
+    static constexpr can_err_mask_t kDefaultErrorMask =
+        CAN_ERR_TX_TIMEOUT | CAN_ERR_CRTL | CAN_ERR_BUSOFF | CAN_ERR_RESTARTED;
+
+    struct Stats {
+        quint64 frames      = 0;   // 읽은 데이터 프레임 (필터 통과분)
+        quint64 used        = 0;   // onFrame이 true를 돌려준 프레임
+        quint64 errorFrames = 0;   // 에러 프레임
+        quint64 syscalls    = 0;   // recvmmsg 호출 수 (마지막 EAGAIN 포함)
+        quint64 wakeups     = 0;   // drain() 호출 수
+        quint64 userStamped = 0;   // 커널 시각이 없어 user-space 시각을 쓴 프레임
+    };
+
+    enum class StampSource : quint8 { Timestamping, TimestampNs, UserSpace };
+
+    CanBatchReader() = default;
+    ~CanBatchReader() { close(); }
+    CanBatchReader(const CanBatchReader &) = delete;
+    CanBatchReader &operator=(const CanBatchReader &) = delete;
+
+    /**
+     * CAN_RAW 소켓을 열어 ifName에 bind. 실패하면 false + error
+     * ids: 받을 11-bit CAN ID (비어 있으면 전부), errorMask: 받을 에러 클래스 (0 = 안 받음)
+     */
+    bool open(const QString &ifName, const QVector<quint32> &ids = {},
+              can_err_mask_t errorMask = kDefaultErrorMask, QString *error = nullptr);
+    void close();
+
+    int  fd() const { return m_fd; }
+    bool isOpen() const { return m_fd >= 0; }
+    StampSource stampSource() const { return m_stampSource; }
+    const Stats &stats() const { return m_stats; }
+
+    /** 마지막 호출 이후 받은 에러 프레임의 클래스 (CAN_ERR_* OR), 읽으면 0으로 */
+    can_err_mask_t takeErrors() { const can_err_mask_t e = m_errors; m_errors = 0; return e; }
+
+    /**
+     * 대기 중인 데이터 프레임을 모두 읽어 도착 순서대로 bool onFrame(const Frame &)을 부른다.
+     * onFrame은 프레임을 실제로 썼으면 true (Stats::used 집계).
+     * 반환: 읽은 프레임 수 (에러 프레임 포함). 소켓 오류(인터페이스 down 등)면 -1
+     */
+    template <typename Fn>
+    int drain(Fn &&onFrame)
+    {
+        ++m_stats.wakeups;
+        int total = 0;
+        for (;;) {
+            int received = 0;
+            const int n = readBatch(&received);
+            if (n < 0)
+                return total ? total : -1;
+            for (int i = 0; i < n; ++i) {
+                const Frame &rx = m_frames[i];
+                if (rx.frame.can_id & CAN_ERR_FLAG) {
+                    ++m_stats.errorFrames;
+                    m_errors |= rx.frame.can_id & CAN_ERR_MASK;
+                } else if (onFrame(rx)) {
+                    ++m_stats.used;
+                }
+            }
+            total += n;
+            if (received < kBatch)
+                return total;
+        }
+    }
+
+    static quint64 realtimeNowNs();
+
+private:
+    /** 유효 프레임 수를 반환, received = recvmmsg가 돌려준 메시지 수 (배치가 꽉 찼는지 판단용) */
+    int readBatch(int *received);
+
+    int         m_fd = -1;
+    StampSource m_stampSource = StampSource::UserSpace;
+    Stats       m_stats;
+    can_err_mask_t m_errors = 0;
+
+    // recvmmsg 버퍼 — open() 이후 재사용, 수신 경로에서 할당하지 않는다
+    Frame    m_frames[kBatch];
+    mmsghdr  m_msgs[kBatch];
+    iovec    m_iov[kBatch];
+    alignas(cmsghdr) char m_control[kBatch][64];
+};
+
+#endif // CANBATCHREADER_H
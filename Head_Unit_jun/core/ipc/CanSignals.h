@@ -0,0 +1,169 @@
+/**
+ * @file CanSignals.h
+ * @brief CAN 신호 데이터베이스 (constexpr) + 템플릿 decoder — HU(hu_core)와 클러스터가 공유
+ *
+ * 신호 레이아웃은 docs/pdc/CAN_SIGNAL_CONTRACT.md §3 표를 그대로 옮긴 것이다.
+ * 레이아웃이 바뀌면 이 표만 고치면 SerialReader(클러스터)와 SocketCanPdcProvider(HU)가 같이 바뀐다.
+ *
+ *   decode<kRearLeftCm>(frame.data)  → 8바이트를 한 번 읽어 shift + mask (+ scale/offset)
+ * 시작 비트 / 길이 / 바이트 순서 / scale이 모두 템플릿 인자(컴파일 타임 상수)라서
+ * 신호마다 분기 없는 추출 코드가 만들어진다. scale 1, offset 0이면 곱셈/덧셈도 빠진다.
+ *
+ * 비트 번호 (DBC 관례):
+ *   LittleEndian (Intel)   : startBit = LSB 위치, byte * 8 + bit (bit 0 = LSB)
+ *   BigEndian   (Motorola) : startBit = MSB 위치, 같은 번호 체계
+ */
+
+#ifndef CANSIGNALS_H
+#define CANSIGNALS_H
+
+#include <QtGlobal>
+
+namespace CanSignals {
+
+enum class ByteOrder : quint8 { LittleEndian, BigEndian };
+
+struct Signal {
+    const char *name;
+    quint32   canId;
+    quint8    startBit;
+    quint8    length;       // 1..64
+    ByteOrder order;
+    bool      isSigned;
+    float     scale;
+    float     offset;
+    float     min;          // 물리값 유효 범위 (CAN_SIGNAL_CONTRACT §5)
+    float     max;
+    qint8     validBit;     // 0x351 valid bitmask의 비트 (-1 = 해당 없음)
+};
+
+// ── 신호 표 ──────────────────────────────────────────────────────────────
+
+// 0x123 (약 5 Hz): B0 속도, B1 단일 초음파 거리 (live capture, §3.1)
+inline constexpr Signal kSpeedKmh    { "vehicle_speed_kmh", 0x123,  0, 8, ByteOrder::LittleEndian, false, 1.0f, 0.0f, 0.0f, 255.0f, -1 };
+inline constexpr Signal kObstacleCm  { "obstacle_cm",       0x123,  8, 8, ByteOrder::LittleEndian, false, 1.0f, 0.0f, 2.0f, 400.0f, -1 };
+
+// 0x350: 후방 4채널 거리, uint16 little-endian cm
+inline constexpr Signal kRearLeftCm     { "rear_left",      0x350,  0, 16, ByteOrder::LittleEndian, false, 1.0f, 0.0f, 2.0f, 400.0f, 0 };
+inline constexpr Signal kRearMidLeftCm  { "rear_mid_left",  0x350, 16, 16, ByteOrder::LittleEndian, false, 1.0f, 0.0f, 2.0f, 400.0f, 1 };
+inline constexpr Signal kRearMidRightCm { "rear_mid_right", 0x350, 32, 16, ByteOrder::LittleEndian, false, 1.0f, 0.0f, 2.0f, 400.0f, 2 };
+inline constexpr Signal kRearRightCm    { "rear_right",     0x350, 48, 16, ByteOrder::LittleEndian, false, 1.0f, 0.0f, 2.0f, 400.0f, 3 };
+
+// 0x351 (optional): B0 센서 valid bitmask, bit n = 1 이면 validBit n 신호가 유효
+inline constexpr Signal kSensorValidMask { "pdc_sensor_valid", 0x351, 0, 8, ByteOrder::LittleEndian, false, 1.0f, 0.0f, 0.0f, 255.0f, -1 };
+
+// ── 컴파일 타임 헬퍼 ─────────────────────────────────────────────────────
+
+/** 신호가 끝나는 바이트까지 필요한 DLC */
+constexpr quint8 requiredDlc(const Signal &s)
+{
+    if (s.order == ByteOrder::LittleEndian)
+        return quint8((s.startBit + s.length + 7) / 8);
+    // Motorola: MSB가 있는 바이트에서 시작해 뒤 바이트로 내려간다
+    const int msbPos = (7 - s.startBit / 8) * 8 + s.startBit % 8;   // BE 64-bit 워드 안 위치
+    const int lsbPos = msbPos - s.length + 1;
+    return quint8(8 - lsbPos / 8);
+}
+
+constexpr bool layoutValid(const Signal &s)
+{
+    if (s.length == 0 || s.length > 64 || s.startBit > 63)
+        return false;
+    if (s.order == ByteOrder::LittleEndian)
+        return s.startBit + s.length <= 64;
+    const int msbPos = (7 - s.startBit / 8) * 8 + s.startBit % 8;
+    return msbPos - s.length + 1 >= 0;
+}
+
+static_assert(layoutValid(kSpeedKmh) && requiredDlc(kSpeedKmh) == 1, "0x123 B0");
+static_assert(layoutValid(kObstacleCm) && requiredDlc(kObstacleCm) == 2, "0x123 B1");
+static_assert(layoutValid(kRearLeftCm) && layoutValid(kRearMidLeftCm)
+              && layoutValid(kRearMidRightCm) && layoutValid(kRearRightCm), "0x350");
+static_assert(requiredDlc(kRearRightCm) == 8, "0x350 needs 8 bytes");
+static_assert(layoutValid(kSensorValidMask) && requiredDlc(kSensorValidMask) == 1, "0x351 B0");
+
+namespace detail {
+/** 8바이트를 little / big endian 64-bit 워드로 — 컴파일러가 load 1번 (+ bswap)으로 접는다 */
+inline quint64 loadLe64(const quint8 *d)
+{
+    return quint64(d[0])       | quint64(d[1]) << 8  | quint64(d[2]) << 16 | quint64(d[3]) << 24
+         | quint64(d[4]) << 32 | quint64(d[5]) << 40 | quint64(d[6]) << 48 | quint64(d[7]) << 56;
+}
+
+inline quint64 loadBe64(const quint8 *d)
+{
+    return quint64(d[7])       | quint64(d[6]) << 8  | quint64(d[5]) << 16 | quint64(d[4]) << 24
+         | quint64(d[3]) << 32 | quint64(d[2]) << 40 | quint64(d[1]) << 48 | quint64(d[0]) << 56;
+}
+
+constexpr quint64 mask(quint8 length)
+{
+    return length >= 64 ? ~quint64(0) : (quint64(1) << length) - 1;
+}
+} // namespace detail
+
+// ── decoder ──────────────────────────────────────────────────────────────
+
+/**
+ * raw 값 추출. data는 can_frame::data (항상 8바이트 버퍼) — DLC 검사는 호출자가
+ * frame 단위로 한 번 (can_dlc >= requiredDlc(S)).
+ */
+template <const Signal &S>
+inline quint64 rawValue(const quint8 *data)
+{
+    static_assert(layoutValid(S), "signal does not fit in 8 bytes");
+    if constexpr (S.order == ByteOrder::LittleEndian) {
+        return (detail::loadLe64(data) >> S.startBit) & detail::mask(S.length);
+    } else {
+        constexpr int msbPos = (7 - S.startBit / 8) * 8 + S.startBit % 8;
+        constexpr int lsbPos = msbPos - S.length + 1;
+        return (detail::loadBe64(data) >> lsbPos) & detail::mask(S.length);
+    }
+}
+
+/** 물리값 = raw * scale + offset (signed면 부호 확장) */
+template <const Signal &S>
+inline float decode(const quint8 *data)
+{
+    const quint64 raw = rawValue<S>(data);
+    float value;
+    if constexpr (S.isSigned && S.length < 64) {
+        constexpr quint64 sign = quint64(1) << (S.length - 1);
+        value = float(qint64((raw ^ sign) - sign));    // 분기 없는 부호 확장
+    } else {
+        value = float(raw);
+    }
+    if constexpr (S.scale != 1.0f)
+        value *= S.scale;
+    if constexpr (S.offset != 0.0f)
+        value += S.offset;
+    return value;
+}
+
+/** 물리값이 S의 유효 범위 안인가 */
+template <const Signal &S>
+constexpr bool inRange(float value)
+{
+    return value >= S.min && value <= S.max;
+}
+
+/** 같은 프레임의 여러 신호를 한 번에 — out[i] = decode<Signals[i]> */
+template <const Signal &... Signals>
+inline void decodeAll(const quint8 *data, float *out)
+{
+    int i = 0;
+    ((out[i++] = decode<Signals>(data)), ...);
+}
+
+/** 신호들이 모두 들어가는 최소 DLC */
+template <const Signal &... Signals>
+constexpr quint8 requiredDlcAll()
+{
+    quint8 dlc = 0;
+    ((dlc = requiredDlc(Signals) > dlc ? requiredDlc(Signals) : dlc), ...);
+    return dlc;
+}
+
+} // namespace CanSignals
+
+#endif // CANSIGNALS_H
@@ -0,0 +1,55 @@
+/**
+ * @file GearRequest.h
+ * @brief SOME/IP 0x8002 gear method — request/response payload codec (header-only)
+ *
+ * Head Unit(VSomeIPClient)과 Instrument Cluster(VSomeIPGearReceiver)가 공유한다.
+ *   request  : [u8 gear][u32 seq]           (5 bytes, big-endian)
+ *   response : [u8 appliedGear][u32 seq]    (request의 seq를 그대로 돌려준다)
+ * 1-byte 요청(구버전 HU)도 받아들인다 — seq는 0, 응답은 보내되 HU가 무시한다.
+ *
+ * HU는 kRetryMs마다 같은 seq로 재전송하고, kBudgetMs(REQ-03) 안에 응답이 없으면 실패로 본다.
+ */
+
+#ifndef GEARREQUEST_H
+#define GEARREQUEST_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace GearRequest {
+
+constexpr std::size_t kWireSize = 5;
+constexpr int         kRetryMs  = 50;    // 재전송 간격
+constexpr int         kBudgetMs = 200;   // REQ-03 기어 반영 지연 예산
+
+struct Payload {
+    std::uint8_t  gear = 0;
+    std::uint32_t seq  = 0;
+};
+
+/** out에 kWireSize 바이트를 쓴다 */
+inline void encode(const Payload &p, std::uint8_t *out)
+{
+    out[0] = p.gear;
+    out[1] = p.seq >> 24;
+    out[2] = (p.seq >> 16) & 0xFF;
+    out[3] = (p.seq >> 8) & 0xFF;
+    out[4] = p.seq & 0xFF;
+}
+
+/** @return 빈 payload면 false. 1-byte(구버전)는 seq = 0 */
+inline bool decode(const std::uint8_t *data, std::size_t length, Payload &out)
+{
+    if (!data || length < 1)
+        return false;
+    out.gear = data[0];
+    out.seq  = length >= kWireSize
+        ? std::uint32_t(data[1]) << 24 | std::uint32_t(data[2]) << 16
+          | std::uint32_t(data[3]) << 8 | data[4]
+        : 0;
+    return true;
+}
+
+} // namespace GearRequest
+
+#endif // GEARREQUEST_H
@@ -1,16 +1,8 @@
 #include "MockPdcSensorProvider.h"
 
-#include <QDateTime>
-#include <QtMath>
+#include "CanBatchReader.h"
 
-namespace {
-const QStringList kSensorNames = {
-    QStringLiteral("rear_left"),
-    QStringLiteral("rear_mid_left"),
-    QStringLiteral("rear_mid_right"),
-    QStringLiteral("rear_right")
-};
-}
+#include <QtMath>
 
 MockPdcSensorProvider::MockPdcSensorProvider(QObject *parent)
     : IPdcSensorProvider(parent)
@@ -35,21 +27,16 @@ void MockPdcSensorProvider::stop()
 
 void MockPdcSensorProvider::publishNextFrame()
 {
-    const qint64 now = QDateTime::currentMSecsSinceEpoch();
     const float wave = (qSin(m_phase / 18.0) + 1.0) * 0.5;
     const float nearest = 22.0f + static_cast<float>(wave) * 135.0f;
 
-    QVector<PdcSensorReading> readings;
-    readings.reserve(kSensorNames.size());
-    for (int i = 0; i < kSensorNames.size(); ++i) {
-        PdcSensorReading reading;
-        reading.name = kSensorNames.at(i);
-        reading.distanceCm = nearest + qAbs(i - 1.5f) * 18.0f;
-        reading.valid = true;
-        reading.timestampMs = now;
-        readings.push_back(reading);
+    PdcSample sample;
+    for (int i = 0; i < kPdcSensorCount; ++i) {
+        sample.distanceCm[i] = nearest + qAbs(i - 1.5f) * 18.0f;
+        sample.setValid(i, true);
     }
+    sample.timestampNs = CanBatchReader::realtimeNowNs();
 
     ++m_phase;
-    emit readingsChanged(readings);
+    emit sampleReady(sample);
 }
@@ -0,0 +1,93 @@
+/**
+ * @file RealtimeThread.cpp
+ */
+
+#include "RealtimeThread.h"
+
+#include <QDebug>
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+
+namespace {
+int envInt(const QByteArray &name, int fallback)
+{
+    bool ok = false;
+    const int value = qEnvironmentVariable(name.constData()).trimmed().toInt(&ok);
+    return ok ? value : fallback;
+}
+
+bool envFlag(const QByteArray &name)
+{
+    const QString value = qEnvironmentVariable(name.constData()).trimmed().toLower();
+    return value == QStringLiteral("1") || value == QStringLiteral("on") || value == QStringLiteral("true");
+}
+} // namespace
+
+RealtimeThreadConfig RealtimeThreadConfig::fromEnvironment(const char *prefix)
+{
+    const QByteArray p(prefix);
+    RealtimeThreadConfig cfg;
+    cfg.priority   = qBound(0, envInt(p + "_PRIORITY", 0), 99);
+    cfg.cpu        = envInt(p + "_CPU", -1);
+    cfg.lockMemory = envFlag(p + "_MLOCK");
+    cfg.dedicatedThread = envFlag(p + "_THREAD") || cfg.priority > 0 || cfg.cpu >= 0;
+    return cfg;
+}
+
+bool RealtimeThreadConfig::applyToCurrentThread(const char *tag) const
+{
+    bool ok = true;
+    QStringList applied;
+
+    if (priority > 0) {
+        sched_param param;
+        std::memset(&param, 0, sizeof(param));
+        param.sched_priority = priority;
+        const int rc = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (rc == 0) {
+            applied << QStringLiteral("SCHED_FIFO %1").arg(priority);
+        } else {
+            qWarning() << tag << "SCHED_FIFO" << priority << "failed:" << std::strerror(rc)
+                       << "- running with the normal scheduler";
+            ok = false;
+        }
+    }
+
+    if (cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        const int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (rc == 0) {
+            applied << QStringLiteral("cpu %1").arg(cpu);
+        } else {
+            qWarning() << tag << "affinity to cpu" << cpu << "failed:" << std::strerror(rc);
+            ok = false;
+        }
+    }
+
+    if (lockMemory) {
+        // 프로세스 전체 설정 — 여러 RT 스레드가 있어도 한 번만
+        static std::atomic<bool> locked{false};
+        if (!locked.exchange(true)) {
+            if (::mlockall(MCL_CURRENT | MCL_FUTURE) == 0) {
+                applied << QStringLiteral("mlockall");
+            } else {
+                qWarning() << tag << "mlockall failed:" << std::strerror(errno);
+                locked.store(false);
+                ok = false;
+            }
+        }
+    }
+
+    if (!applied.isEmpty()) {
+        qInfo() << tag << "real-time thread:" << applied.join(QStringLiteral(", "));
+    }
+    return ok;
+}
@@ -0,0 +1,33 @@
+/**
+ * @file RealtimeThread.h
+ * @brief 안전 경로 스레드(PDC CAN 리더 등)의 스케줄링 설정 — SCHED_FIFO / CPU affinity / mlockall
+ *
+ * 환경 변수 (prefix = "HU_PDC_RT"):
+ *   <prefix>_THREAD=1      전용 스레드 사용 (PRIORITY/CPU 중 하나라도 주면 자동으로 켜짐)
+ *   <prefix>_PRIORITY=N    SCHED_FIFO 우선순위 1..99 (0 = 일반 스케줄러)
+ *   <prefix>_CPU=N         이 CPU 하나에 고정 (-1 = 고정 안 함)
+ *   <prefix>_MLOCK=1       mlockall(MCL_CURRENT | MCL_FUTURE) — 페이지 폴트로 멈추지 않게
+ * 권한(CAP_SYS_NICE / RLIMIT_RTPRIO / RLIMIT_MEMLOCK)이 없으면 경고만 남기고 일반 스레드로 돈다.
+ */
+
+#ifndef REALTIMETHREAD_H
+#define REALTIMETHREAD_H
+
+#include <QString>
+
+struct RealtimeThreadConfig {
+    bool dedicatedThread = false;
+    int  priority = 0;       // SCHED_FIFO 1..99, 0 = SCHED_OTHER
+    int  cpu = -1;
+    bool lockMemory = false;
+
+    static RealtimeThreadConfig fromEnvironment(const char *prefix);
+
+    /**
+     * 호출한 스레드에 priority / cpu를 적용하고, lockMemory면 프로세스 전체 mlockall (1회).
+     * 결과를 "[tag] ..." 한 줄로 로그에 남긴다. 하나라도 실패하면 false.
+     */
+    bool applyToCurrentThread(const char *tag) const;
+};
+
+#endif // REALTIMETHREAD_H
@@ -1,41 +1,58 @@
 #include "SocketCanPdcProvider.h"
 
-#include <QDateTime>
+#include "CanSignals.h"
+#include "PdcFilter.h"
+#include "PdcSensorMonitor.h"
+#include "PdcWarning.h"
+
 #include <QDebug>
-#include <QByteArray>
 
 #include <cerrno>
 #include <cstring>
-#include <unistd.h>
 
-#include <net/if.h>
-#include <sys/ioctl.h>
-#include <sys/socket.h>
-#include <linux/can.h>
-#include <linux/can/raw.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
 
 namespace {
-constexpr canid_t kObservedCanId = 0x123;
-constexpr canid_t kFourSensorCanId = 0x350;
-constexpr float kMinDistanceCm = 2.0f;
-constexpr float kMaxDistanceCm = 400.0f;
-
-const QStringList kSensorNames = {
-    QStringLiteral("rear_left"),
-    QStringLiteral("rear_mid_left"),
-    QStringLiteral("rear_mid_right"),
-    QStringLiteral("rear_right")
+// 레이아웃은 CanSignals.h (CAN_SIGNAL_CONTRACT §3) 한 곳에서
+using CanSignals::kObstacleCm;
+using CanSignals::kRearLeftCm;
+using CanSignals::kRearMidLeftCm;
+using CanSignals::kRearMidRightCm;
+using CanSignals::kRearRightCm;
+using CanSignals::kSensorValidMask;
+
+constexpr canid_t kObservedCanId = kObstacleCm.canId;
+constexpr canid_t kFourSensorCanId = kRearLeftCm.canId;
+constexpr canid_t kValidityCanId = kSensorValidMask.canId;     // optional
+constexpr quint8 kObservedDlc = CanSignals::requiredDlc(kObstacleCm);
+constexpr quint8 kFourSensorDlc =
+    CanSignals::requiredDlcAll<kRearLeftCm, kRearMidLeftCm, kRearMidRightCm, kRearRightCm>();
+constexpr quint8 kValidityDlc = CanSignals::requiredDlc(kSensorValidMask);
+
+// 0x350 채널 i의 0x351 비트
+constexpr qint8 kRearValidBits[kPdcSensorCount] = {
+    kRearLeftCm.validBit, kRearMidLeftCm.validBit, kRearMidRightCm.validBit, kRearRightCm.validBit
 };
 
-bool distanceValid(float distanceCm)
-{
-    return distanceCm >= kMinDistanceCm && distanceCm <= kMaxDistanceCm;
-}
+static_assert(kRearLeftCm.validBit == int(PdcSensor::RearLeft)
+              && kRearMidLeftCm.validBit == int(PdcSensor::RearMidLeft)
+              && kRearMidRightCm.validBit == int(PdcSensor::RearMidRight)
+              && kRearRightCm.validBit == int(PdcSensor::RearRight),
+              "0x350 channel order must match PdcSensor");
+
+// 커널 CAN_RAW_FILTER — 이 ID 외의 프레임은 HU를 깨우지 않는다
+const QVector<quint32> kPdcCanIds = { kObservedCanId, kFourSensorCanId, kValidityCanId };
 
-quint16 le16(const __u8 *data)
+// 프레임 사이 예측 경고 / 센서 timeout 갱신 주기 (PdcController 검사 주기와 동일)
+constexpr int kPredictTickMs = static_cast<int>(PdcSensorMonitor::kTickNs / 1000000);
+
+bool distanceValid(float distanceCm)
 {
-    return static_cast<quint16>(data[0]) |
-           static_cast<quint16>(data[1] << 8);
+    static_assert(kObstacleCm.min == kRearLeftCm.min && kObstacleCm.max == kRearLeftCm.max,
+                  "PDC distance signals share one valid range");
+    return CanSignals::inRange<kObstacleCm>(distanceCm);
 }
 }
 
@@ -52,50 +69,51 @@ SocketCanPdcProvider::~SocketCanPdcProvider()
 
 void SocketCanPdcProvider::start()
 {
-    if (m_socket >= 0 || !openSocket()) {
+    if (m_reader.isOpen() || !openSocket()) {
         return;
     }
 
-    m_notifier = new QSocketNotifier(m_socket, QSocketNotifier::Read, this);
+    if (m_realtime.dedicatedThread) {
+        if (startReaderThread()) {
+            return;
+        }
+        qWarning() << "[PDC] reader thread unavailable; falling back to the GUI thread";
+    }
+
+    startNotifier();
+}
+
+void SocketCanPdcProvider::startNotifier()
+{
+    m_notifier = new QSocketNotifier(m_reader.fd(), QSocketNotifier::Read, this);
     connect(m_notifier, &QSocketNotifier::activated,
             this, &SocketCanPdcProvider::onCanReadyRead);
 }
 
 void SocketCanPdcProvider::stop()
 {
+    stopReaderThread();
     closeSocket();
 }
 
-bool SocketCanPdcProvider::openSocket()
+void SocketCanPdcProvider::setWarningGate(bool active, float speedKmh)
 {
-    m_socket = ::socket(PF_CAN, SOCK_RAW, CAN_RAW);
-    if (m_socket < 0) {
-        emit faultChanged(QStringLiteral("Failed to create CAN socket"));
-        return false;
-    }
-
-    struct ifreq ifr;
-    std::memset(&ifr, 0, sizeof(ifr));
-    const QByteArray ifName = m_interfaceName.toLatin1();
-    std::strncpy(ifr.ifr_name, ifName.constData(), IFNAMSIZ - 1);
-    if (::ioctl(m_socket, SIOCGIFINDEX, &ifr) < 0) {
-        emit faultChanged(QStringLiteral("Failed to resolve %1").arg(m_interfaceName));
-        closeSocket();
-        return false;
-    }
-
-    struct sockaddr_can addr;
-    std::memset(&addr, 0, sizeof(addr));
-    addr.can_family = AF_CAN;
-    addr.can_ifindex = ifr.ifr_ifindex;
+    m_gateActive.store(active, std::memory_order_relaxed);
+    m_gateSpeedKmh.store(speedKmh, std::memory_order_relaxed);
+    wakeReader();   // 후진 해제 / 과속을 다음 프레임까지 기다리지 않고 반영
+}
 
-    if (::bind(m_socket, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0) {
-        emit faultChanged(QStringLiteral("Failed to bind CAN socket to %1").arg(m_interfaceName));
-        closeSocket();
+bool SocketCanPdcProvider::openSocket()
+{
+    QString error;
+    if (!m_reader.open(m_interfaceName, kPdcCanIds, CanBatchReader::kDefaultErrorMask, &error)) {
+        emit faultChanged(error);
         return false;
     }
 
-    qInfo() << "[PDC] SocketCAN provider listening on" << m_interfaceName;
+    qInfo() << "[PDC] SocketCAN provider listening on" << m_interfaceName
+            << (m_reader.stampSource() == CanBatchReader::StampSource::UserSpace
+                    ? "(user-space timestamps)" : "(kernel timestamps)");
     return true;
 }
 
@@ -107,73 +125,281 @@ void SocketCanPdcProvider::closeSocket()
         m_notifier = nullptr;
     }
 
-    if (m_socket >= 0) {
-        ::close(m_socket);
-        m_socket = -1;
+    if (m_reader.isOpen()) {
+        const CanBatchReader::Stats &st = m_reader.stats();
+        qInfo() << "[PDC] CAN frames received" << st.frames << "used" << st.used
+                << "errors" << st.errorFrames << "wakeups" << st.wakeups;
     }
+    m_reader.close();
 }
 
 void SocketCanPdcProvider::onCanReadyRead()
 {
-    if (m_socket < 0) {
+    if (!m_reader.isOpen()) {
         return;
     }
 
-    struct can_frame frame;
-    const ssize_t n = ::read(m_socket, &frame, sizeof(frame));
-    if (n < static_cast<ssize_t>(sizeof(frame))) {
+    // 밀린 프레임을 한 번에 읽고, 화면에는 마지막으로 도착한 PDC 프레임만 반영한다
+    // (중간 값은 어차피 다음 프레임이 덮어쓴다 — wakeup당 sampleReady 최대 1회)
+    PdcSample sample;
+    bool haveSample = false;
+    const int n = m_reader.drain([&](const CanBatchReader::Frame &rx) {
+        if (decodeValidityFrame(rx.frame, m_validMask)) {
+            m_validMaskNs = rx.rxRealtimeNs;
+            return true;
+        }
+        if (decodeFrame(rx.frame, rx.rxRealtimeNs, sample,
+                        effectiveValidMask(m_validMask, m_validMaskNs, rx.rxRealtimeNs))) {
+            haveSample = true;
+            return true;
+        }
+        return false;
+    });
+    if (n < 0) {
+        emit faultChanged(QStringLiteral("CAN read error on %1").arg(m_interfaceName));
         return;
     }
+    if (const can_err_mask_t errors = m_reader.takeErrors()) {
+        if (errors & CAN_ERR_BUSOFF) {
+            emit faultChanged(QStringLiteral("CAN bus-off on %1").arg(m_interfaceName));
+            return;
+        }
+        qWarning() << "[PDC] CAN error frame on" << m_interfaceName
+                   << "class" << QStringLiteral("0x%1").arg(errors, 0, 16);
+    }
+    if (haveSample) {
+        emit sampleReady(sample);
+    }
+}
 
-    const canid_t canId = frame.can_id & CAN_EFF_MASK;
-    if (canId == kFourSensorCanId && frame.can_dlc >= 8) {
-        emitFourRearDistances(le16(&frame.data[0]),
-                              le16(&frame.data[2]),
-                              le16(&frame.data[4]),
-                              le16(&frame.data[6]));
+// ── 리더 스레드 ──────────────────────────────────────────────────────────
+
+bool SocketCanPdcProvider::startReaderThread()
+{
+    m_wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_wakeFd < 0) {
+        qWarning() << "[PDC] eventfd failed:" << std::strerror(errno);
+        return false;
+    }
+
+    m_running.store(true, std::memory_order_release);
+    m_readerRunning.store(true, std::memory_order_release);
+    m_thread = std::thread(&SocketCanPdcProvider::readerLoop, this);
+    return true;
+}
+
+void SocketCanPdcProvider::stopReaderThread()
+{
+    if (!m_thread.joinable()) {
         return;
     }
 
-    if (canId == kObservedCanId && frame.can_dlc >= 2) {
-        // Live Pi capture currently shows 0x123 as: 00 48/49 00 ...
-        // Byte 0 stays zero while byte 1 changes around plausible cm values.
-        emitUniformRearDistance(static_cast<float>(frame.data[1]));
+    m_running.store(false, std::memory_order_release);
+    wakeReader();
+    m_thread.join();
+    ::close(m_wakeFd);
+    m_wakeFd = -1;
+}
+
+void SocketCanPdcProvider::wakeReader()
+{
+    if (m_wakeFd >= 0) {
+        ::eventfd_write(m_wakeFd, 1);
     }
 }
 
-void SocketCanPdcProvider::emitUniformRearDistance(float distanceCm)
+void SocketCanPdcProvider::markDirty(quint32 bits)
+{
+    if (m_dirty.fetch_or(bits, std::memory_order_release) == 0)
+        QMetaObject::invokeMethod(this, "drainReader", Qt::QueuedConnection);
+}
+
+void SocketCanPdcProvider::readerLoop()
 {
-    const qint64 now = QDateTime::currentMSecsSinceEpoch();
-    QVector<PdcSensorReading> readings;
-    readings.reserve(kSensorNames.size());
+    m_realtime.applyToCurrentThread("[PDC]");
+
+    pollfd fds[2] = {
+        { m_reader.fd(), POLLIN, 0 },
+        { m_wakeFd, POLLIN, 0 },
+    };
+    PdcSample latest;
+    PdcFilter filter;
+    PdcSensorMonitor monitor;   // PdcController와 같은 센서별 timeout (측정 시각 기준)
+    quint8 validMask = 0xFF;
+    quint64 validMaskNs = 0;
+    PdcWarningLevel published = PdcWarningLevel::Off;
+
+    while (m_running.load(std::memory_order_acquire)) {
+        // 살아 있는 센서가 있으면 예측 / timeout 갱신 주기마다 깬다
+        const int timeoutMs = monitor.aliveMask() ? kPredictTickMs : -1;
 
-    for (const QString &name : kSensorNames) {
-        PdcSensorReading reading;
-        reading.name = name;
-        reading.distanceCm = distanceCm;
-        reading.valid = distanceValid(distanceCm);
-        reading.timestampMs = now;
-        readings.push_back(reading);
+        const int rc = ::poll(fds, 2, timeoutMs);
+        if (rc < 0 && errno != EINTR) {
+            markDirty(DirtyReadError);
+            break;
+        }
+        if (rc > 0 && (fds[1].revents & POLLIN)) {
+            eventfd_t ignored;
+            ::eventfd_read(m_wakeFd, &ignored);
+        }
+
+        if (rc > 0 && (fds[0].revents & (POLLIN | POLLERR))) {
+            bool haveSample = false;
+            filter.setVehicleSpeed(m_gateSpeedKmh.load(std::memory_order_relaxed));
+            const int n = m_reader.drain([&](const CanBatchReader::Frame &rx) {
+                if (decodeValidityFrame(rx.frame, validMask)) {
+                    validMaskNs = rx.rxRealtimeNs;
+                    return true;
+                }
+                if (decodeFrame(rx.frame, rx.rxRealtimeNs, latest,
+                                effectiveValidMask(validMask, validMaskNs, rx.rxRealtimeNs))) {
+                    filter.update(latest, rx.rxRealtimeNs);   // 배치 안의 모든 sample로 속도 추정
+                    monitor.update(latest, rx.rxRealtimeNs);
+                    haveSample = true;
+                    return true;
+                }
+                return false;
+            });
+            if (n < 0) {
+                markDirty(DirtyReadError);
+                break;
+            }
+            if (const can_err_mask_t errors = m_reader.takeErrors()) {
+                if (errors & CAN_ERR_BUSOFF) {
+                    monitor.expireAll();
+                    filter.reset();
+                    markDirty(DirtyBusOff);
+                } else {
+                    m_errorClasses.fetch_or(errors, std::memory_order_relaxed);
+                    markDirty(DirtyErrorFrame);
+                }
+            }
+            if (haveSample) {
+                m_slot.store(latest);
+                markDirty(DirtySample);
+            }
+        }
+
+        // 끊긴 센서는 트랙에서 빼고 나머지로 계속 — GUI 쪽은 PdcController가 같은 기준으로 처리
+        const quint64 nowNs = CanBatchReader::realtimeNowNs();
+        const quint8 expired = monitor.expire(nowNs);
+        for (int i = 0; i < kPdcSensorCount; ++i) {
+            if ((expired >> i) & 1u)
+                filter.dropSensor(i);
+        }
+
+        // PdcController와 같은 필터 / 경고 함수 — 프레임 사이에도 예측 거리로 단계를 올린다
+        const PdcWarningLevel level = monitor.aliveMask() == 0
+            ? PdcWarningLevel::Off
+            : PdcWarning::gatedLevel(
+                  PdcWarning::levelForDistance(filter.estimate(nowNs).warningCm),
+                  m_gateActive.load(std::memory_order_relaxed),
+                  m_gateSpeedKmh.load(std::memory_order_relaxed));
+        if (level != published) {
+            published = level;
+            emit warningLevelChanged(level);
+        }
     }
 
-    emit readingsChanged(readings);
+    if (published != PdcWarningLevel::Off) {
+        emit warningLevelChanged(PdcWarningLevel::Off);
+    }
+    m_readerRunning.store(false, std::memory_order_release);
+    if (m_running.load(std::memory_order_acquire)) {
+        markDirty(DirtyReaderExit);   // stop() 요청이 아닌 오류 종료
+    }
 }
 
-void SocketCanPdcProvider::emitFourRearDistances(float rl, float rml, float rmr, float rr)
+void SocketCanPdcProvider::onReaderExited()
 {
-    const qint64 now = QDateTime::currentMSecsSinceEpoch();
-    const float values[] = {rl, rml, rmr, rr};
-    QVector<PdcSensorReading> readings;
-    readings.reserve(kSensorNames.size());
+    if (!m_thread.joinable()) {
+        return;   // 그 사이 stop()이 이미 정리했다
+    }
+    m_thread.join();
+    m_running.store(false, std::memory_order_release);
+    ::close(m_wakeFd);
+    m_wakeFd = -1;
 
-    for (int i = 0; i < kSensorNames.size(); ++i) {
-        PdcSensorReading reading;
-        reading.name = kSensorNames.at(i);
-        reading.distanceCm = values[i];
-        reading.valid = distanceValid(values[i]);
-        reading.timestampMs = now;
-        readings.push_back(reading);
+    qWarning() << "[PDC] reader thread exited on" << m_interfaceName
+               << "; falling back to the GUI thread";
+    if (m_reader.isOpen()) {
+        startNotifier();
     }
+    emit warningLevelPublishingChanged(false);
+}
 
-    emit readingsChanged(readings);
+void SocketCanPdcProvider::drainReader()
+{
+    const quint32 bits = m_dirty.exchange(0, std::memory_order_acquire);
+    if (bits & DirtyReaderExit) {
+        onReaderExited();   // 경보음을 PdcController 경로로 먼저 돌려 놓고 아래 fault를 내보낸다
+    }
+    if (bits & DirtyErrorFrame) {
+        const quint32 errors = m_errorClasses.exchange(0, std::memory_order_relaxed);
+        qWarning() << "[PDC] CAN error frame on" << m_interfaceName
+                   << "class" << QStringLiteral("0x%1").arg(errors, 0, 16);
+    }
+    if (bits & DirtyReadError) {
+        emit faultChanged(QStringLiteral("CAN read error on %1").arg(m_interfaceName));
+        return;
+    }
+    if (bits & DirtyBusOff) {
+        emit faultChanged(QStringLiteral("CAN bus-off on %1").arg(m_interfaceName));
+        return;
+    }
+    if (bits & DirtySample) {
+        emit sampleReady(m_slot.load());
+    }
+}
+
+const QVector<quint32> &SocketCanPdcProvider::canIds()
+{
+    return kPdcCanIds;
+}
+
+bool SocketCanPdcProvider::decodeFrame(const can_frame &frame, quint64 rxRealtimeNs, PdcSample &out,
+                                       quint8 sensorValidMask)
+{
+    const canid_t canId = frame.can_id & CAN_EFF_MASK;
+    if (canId == kFourSensorCanId && frame.can_dlc >= kFourSensorDlc) {
+        CanSignals::decodeAll<kRearLeftCm, kRearMidLeftCm, kRearMidRightCm, kRearRightCm>(
+            frame.data, out.distanceCm.data());
+    } else if (canId == kObservedCanId && frame.can_dlc >= kObservedDlc) {
+        // Live Pi capture currently shows 0x123 as: 00 48/49 00 ...
+        // Byte 0 stays zero while byte 1 changes around plausible cm values.
+        // 단일 거리 신호는 0x351 비트가 없다 (validBit -1)
+        out.distanceCm.fill(CanSignals::decode<kObstacleCm>(frame.data));
+        sensorValidMask = 0xFF;
+    } else {
+        return false;
+    }
+
+    out.validMask = 0;
+    out.outOfRangeMask = 0;
+    for (int i = 0; i < kPdcSensorCount; ++i) {
+        // 센서가 invalid로 보고한 값은 범위와 상관없이 버린다 — 범위 밖 카운트는 보고된 유효 값만
+        if (!((sensorValidMask >> kRearValidBits[i]) & 1u))
+            continue;
+        if (distanceValid(out.distanceCm[i]))
+            out.setValid(i, true);
+        else
+            out.outOfRangeMask |= static_cast<quint8>(1u << i);
+    }
+    out.timestampNs = rxRealtimeNs;
+    return true;
+}
+
+bool SocketCanPdcProvider::decodeValidityFrame(const can_frame &frame, quint8 &mask)
+{
+    if ((frame.can_id & CAN_EFF_MASK) != kValidityCanId || frame.can_dlc < kValidityDlc)
+        return false;
+    mask = static_cast<quint8>(CanSignals::rawValue<kSensorValidMask>(frame.data));
+    return true;
+}
+
+quint8 SocketCanPdcProvider::effectiveValidMask(quint8 mask, quint64 maskRxNs, quint64 nowNs)
+{
+    if (maskRxNs == 0)
+        return 0xFF;
+    return (nowNs <= maskRxNs || nowNs - maskRxNs < PdcSensorMonitor::kTimeoutNs) ? mask : 0xFF;
 }
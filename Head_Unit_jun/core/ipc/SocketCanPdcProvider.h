@@ -2,10 +2,28 @@
 #define SOCKETCANPDCPROVIDER_H
 
 #include "IPdcSensorProvider.h"
+#include "CanBatchReader.h"
+#include "RealtimeThread.h"
+#include "SeqLockSlot.h"
 
 #include <QSocketNotifier>
 #include <QString>
 
+#include <atomic>
+#include <thread>
+
+/**
+ * SocketCAN PDC 입력.
+ *
+ * 기본: QSocketNotifier로 GUI 스레드에서 읽는다.
+ * setRealtime(cfg.dedicatedThread): 전용 리더 스레드가 poll()로 CAN을 읽고
+ *   - 경고 단계(PdcWarning::gatedLevel)를 그 스레드에서 계산해 바뀔 때만 warningLevelChanged
+ *   - 최신 sample은 SeqLockSlot에 쓰고 dirty 비트로 drainReader()를 큐잉 → GUI에서 sampleReady
+ *   - 센서별 신선도(PdcSensorMonitor)로 끊긴 센서만 빼고 판단, 모두 끊기거나 fault면 Off
+ *     — GUI가 멈춰 있어도 경보음 판단은 계속된다
+ *   - poll / 읽기 오류로 리더 스레드가 끝나면 GUI 스레드 읽기로 돌아가고
+ *     warningLevelPublishingChanged(false) — 경보음은 PdcController 경로로 돌아간다
+ */
 class SocketCanPdcProvider : public IPdcSensorProvider
 {
     Q_OBJECT
@@ -17,20 +35,71 @@ public:
 
     void start() override;
     void stop() override;
-    bool isAvailable() const override { return m_socket >= 0; }
+    bool isAvailable() const override { return m_reader.isOpen(); }
+    void setWarningGate(bool active, float speedKmh) override;
+    bool publishesWarningLevel() const override { return m_readerRunning.load(std::memory_order_acquire); }
+
+    /** start() 전에 호출 — 전용 리더 스레드 / SCHED_FIFO / affinity / mlockall */
+    void setRealtime(const RealtimeThreadConfig &config) { m_realtime = config; }
+
+    /** 수신 통계 (프레임 / recvmmsg 호출 / wakeup). 리더 스레드 모드에서는 stop() 후에 읽는다 */
+    const CanBatchReader::Stats &ingestStats() const { return m_reader.stats(); }
+
+    /**
+     * PDC 프레임(0x123 / 0x350) 하나를 sample로 decode. 다른 ID나 DLC 부족이면 false.
+     * sensorValidMask = 마지막 0x351 bitmask (validBit 기준) — 0x350 채널에만 적용, 비트 0이면 그 센서 무효.
+     * 할당 없음 — 벤치마크(hu_bench_pdc)도 이 함수로 provider 경로를 재현한다.
+     */
+    static bool decodeFrame(const can_frame &frame, quint64 rxRealtimeNs, PdcSample &out,
+                            quint8 sensorValidMask = 0xFF);
+    /** provider가 CAN_RAW_FILTER로 받는 ID (0x123 / 0x350 / 0x351) — 녹화기 기본값도 이것 */
+    static const QVector<quint32> &canIds();
+    /** 0x351 센서 valid bitmask. 다른 ID나 DLC 부족이면 false */
+    static bool decodeValidityFrame(const can_frame &frame, quint8 &mask);
+    /** 0x351은 optional — 마지막 수신 후 센서 timeout이 지나면 "전부 유효"로 돌아간다 */
+    static quint8 effectiveValidMask(quint8 mask, quint64 maskRxNs, quint64 nowNs);
 
 private slots:
     void onCanReadyRead();
+    void drainReader();   // GUI 스레드 — 리더 스레드가 쌓은 sample / fault를 시그널로
 
 private:
     bool openSocket();
     void closeSocket();
-    void emitUniformRearDistance(float distanceCm);
-    void emitFourRearDistances(float rl, float rml, float rmr, float rr);
+    bool startReaderThread();
+    void stopReaderThread();
+    void readerLoop();    // 리더 스레드
+    void wakeReader();
+    void startNotifier();
+    void onReaderExited();   // GUI 스레드 — 요청 없이 끝난 리더 스레드 정리 + GUI 스레드 읽기로 전환
+
+    enum DirtyBit : quint32 {
+        DirtySample    = 1u << 0,
+        DirtyReadError = 1u << 1,
+        DirtyBusOff    = 1u << 2,
+        DirtyErrorFrame = 1u << 3,
+        DirtyReaderExit = 1u << 4,
+    };
+    /** 아무 스레드에서나 — 비트를 세우고 0 → non-0 전이 때만 drainReader()를 큐잉 */
+    void markDirty(quint32 bits);
 
     QString m_interfaceName;
-    int m_socket = -1;
+    CanBatchReader m_reader;
     QSocketNotifier *m_notifier = nullptr;
+    quint8 m_validMask = 0xFF;                      // 마지막 0x351 (GUI 스레드 경로)
+    quint64 m_validMaskNs = 0;
+
+    // ── 리더 스레드 모드 ──
+    RealtimeThreadConfig m_realtime;
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};           // stop 요청 전까지 true
+    std::atomic<bool> m_readerRunning{false};     // 리더 루프가 실제로 돌고 있는 동안 true
+    int m_wakeFd = -1;                              // eventfd: stop / 게이트 변경
+    std::atomic<bool> m_gateActive{false};
+    std::atomic<float> m_gateSpeedKmh{0.0f};
+    HuProtocol::SeqLockSlot<PdcSample> m_slot;
+    std::atomic<quint32> m_dirty{0};
+    std::atomic<quint32> m_errorClasses{0};         // bus-off 외 CAN 에러 클래스 (로그용)
 };
 
 #endif // SOCKETCANPDCPROVIDER_H
@@ -0,0 +1,157 @@
+/**
+ * @file TrafficLog.cpp
+ */
+
+#include "TrafficLog.h"
+
+#include <QDateTime>
+#include <QMutexLocker>
+
+#include <cstring>
+
+namespace {
+constexpr char    kMagic[4]   = {'H', 'U', 'T', 'L'};
+constexpr quint16 kVersion    = 1;
+constexpr int     kHeaderSize = 16;
+constexpr int     kRecordHead = 8;
+
+void putLe16(char *p, quint16 v) { p[0] = char(v); p[1] = char(v >> 8); }
+void putLe32(char *p, quint32 v) { putLe16(p, quint16(v)); putLe16(p + 2, quint16(v >> 16)); }
+void putLe64(char *p, quint64 v) { putLe32(p, quint32(v)); putLe32(p + 4, quint32(v >> 32)); }
+
+quint16 getLe16(const char *p) { return quint16(quint8(p[0]) | quint8(p[1]) << 8); }
+quint32 getLe32(const char *p) { return getLe16(p) | quint32(getLe16(p + 2)) << 16; }
+quint64 getLe64(const char *p) { return getLe32(p) | quint64(getLe32(p + 4)) << 32; }
+} // namespace
+
+// ── TrafficLogWriter ──────────────────────────────────────────────────
+
+bool TrafficLogWriter::open(const QString &path)
+{
+    close();
+    QMutexLocker lock(&m_lock);
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    char header[kHeaderSize] = {};
+    std::memcpy(header, kMagic, sizeof(kMagic));
+    putLe16(header + 4, kVersion);
+    putLe64(header + 8, quint64(QDateTime::currentMSecsSinceEpoch()) * 1000000ull);
+    m_file.write(header, kHeaderSize);
+
+    m_haveBase = false;
+    m_lastUs   = 0;
+    m_records  = 0;
+    return true;
+}
+
+void TrafficLogWriter::close()
+{
+    QMutexLocker lock(&m_lock);
+    if (m_file.isOpen())
+        m_file.close();
+}
+
+void TrafficLogWriter::writeCan(quint64 monoNs, quint32 canId, const quint8 *data, quint8 length)
+{
+    char prefix[4];
+    putLe32(prefix, canId);
+    writeRecord(monoNs, TrafficRecord::Can, prefix, sizeof(prefix), data, length);
+}
+
+void TrafficLogWriter::writeSomeIp(quint64 monoNs, quint16 service, quint16 instance, quint16 event,
+                                   const quint8 *payload, quint8 length)
+{
+    char prefix[6];
+    putLe16(prefix, service);
+    putLe16(prefix + 2, instance);
+    putLe16(prefix + 4, event);
+    writeRecord(monoNs, TrafficRecord::SomeIpEvent, prefix, sizeof(prefix), payload, length);
+}
+
+void TrafficLogWriter::writeRecord(quint64 monoNs, TrafficRecord::Kind kind,
+                                   const char *prefix, int prefixLen,
+                                   const quint8 *data, quint8 length)
+{
+    QMutexLocker lock(&m_lock);
+    if (!m_file.isOpen())
+        return;
+
+    if (!m_haveBase) {
+        m_baseNs   = monoNs;
+        m_haveBase = true;
+    }
+    // 다른 스레드의 레코드가 약간 늦은 시각으로 먼저 들어올 수 있다 — 시간은 역행시키지 않는다
+    const quint64 us    = monoNs > m_baseNs ? (monoNs - m_baseNs) / 1000 : 0;
+    // u32 delta(~71분)를 넘는 공백은 잘린 만큼만 진행한다 — 남은 시간은 다음 레코드들이 이어서 싣는다
+    // (m_lastUs를 전체 delta만큼 올리면 reader 쪽 시간이 영구히 어긋난다)
+    const quint64 gap   = us > m_lastUs ? us - m_lastUs : 0;
+    const quint32 delta = gap > 0xFFFFFFFFull ? 0xFFFFFFFFu : quint32(gap);
+    m_lastUs += delta;
+
+    char head[kRecordHead + 6];
+    putLe32(head, delta);
+    head[4] = char(kind);
+    head[5] = char(length);
+    putLe16(head + 6, 0);
+    std::memcpy(head + kRecordHead, prefix, static_cast<size_t>(prefixLen));
+    m_file.write(head, kRecordHead + prefixLen);
+    if (length)
+        m_file.write(reinterpret_cast<const char *>(data), length);
+    ++m_records;
+}
+
+// ── TrafficLogReader ──────────────────────────────────────────────────
+
+bool TrafficLogReader::open(const QString &path)
+{
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+    char header[kHeaderSize];
+    if (m_file.read(header, kHeaderSize) != kHeaderSize
+        || std::memcmp(header, kMagic, sizeof(kMagic)) != 0) {
+        m_error = QStringLiteral("not a .hutl traffic log");
+        return false;
+    }
+    if (getLe16(header + 4) != kVersion) {
+        m_error = QStringLiteral("unsupported .hutl version %1").arg(getLe16(header + 4));
+        return false;
+    }
+    m_startRealtimeNs = getLe64(header + 8);
+    m_timeUs = 0;
+    return true;
+}
+
+bool TrafficLogReader::next(TrafficRecord &out)
+{
+    char head[kRecordHead];
+    if (m_file.read(head, kRecordHead) != kRecordHead)
+        return false;
+
+    m_timeUs  += getLe32(head);
+    out.timeNs = m_timeUs * 1000ull;
+    out.kind   = static_cast<TrafficRecord::Kind>(quint8(head[4]));
+    out.length = quint8(head[5]);
+
+    char prefix[6];
+    switch (out.kind) {
+    case TrafficRecord::Can:
+        if (m_file.read(prefix, 4) != 4) return false;
+        out.canId = getLe32(prefix);
+        break;
+    case TrafficRecord::SomeIpEvent:
+        if (m_file.read(prefix, 6) != 6) return false;
+        out.service  = getLe16(prefix);
+        out.instance = getLe16(prefix + 2);
+        out.event    = getLe16(prefix + 4);
+        break;
+    default:
+        m_error = QStringLiteral("unknown record kind %1").arg(int(out.kind));
+        return false;
+    }
+    return m_file.read(reinterpret_cast<char *>(out.data), out.length) == out.length;
+}
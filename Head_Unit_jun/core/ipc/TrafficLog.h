@@ -0,0 +1,91 @@
+/**
+ * @file TrafficLog.h
+ * @brief CAN / SOME/IP 트래픽 녹화 파일 (.hutl) — 작은 바이너리 포맷 writer/reader
+ *
+ * 실차 세션을 녹화해서 vcan0 + 대역 클러스터(hu_cluster_standin --replay)로 다시 흘려
+ * PDC/속도 경로의 성능·회귀 벤치마크를 반복 가능하게 만든다.
+ *   녹화: hu_traffic_record   재생: hu_cluster_standin --replay <file>
+ *
+ * 파일 레이아웃 (little-endian):
+ *   header  16 B : "HUTL" | u16 version | u16 reserved | u64 startRealtimeNs (녹화 시작 wall clock)
+ *   record   8 B : u32 deltaUs (직전 레코드부터) | u8 kind | u8 length | u16 reserved
+ *            + body
+ *     Can          : u32 canId (EFF/RTR 플래그 포함) + data[length]              (≤ 20 B / frame)
+ *     SomeIpEvent  : u16 service | u16 instance | u16 event + payload[length]   (0x8004 = 46 B)
+ * 시간은 CLOCK_MONOTONIC 기준이며 첫 레코드가 0이다. 끝에 잘린 레코드는 무시한다.
+ */
+
+#ifndef TRAFFICLOG_H
+#define TRAFFICLOG_H
+
+#include <QtGlobal>
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QString>
+
+struct TrafficRecord
+{
+    enum Kind : quint8 {
+        Can         = 1,
+        SomeIpEvent = 2,
+    };
+
+    quint64 timeNs   = 0;    // 세션 시작(첫 레코드) 기준
+    Kind    kind     = Can;
+    quint32 canId    = 0;    // Can
+    quint16 service  = 0;    // SomeIpEvent
+    quint16 instance = 0;
+    quint16 event    = 0;
+    quint8  length   = 0;
+    quint8  data[255] = {};
+};
+
+/** 녹화 — 여러 스레드(CAN 읽기 루프, vsomeip 핸들러)에서 호출해도 된다 */
+class TrafficLogWriter
+{
+public:
+    TrafficLogWriter() = default;
+    ~TrafficLogWriter() { close(); }
+
+    bool open(const QString &path);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+    QString errorString() const { return m_file.errorString(); }
+
+    /** monoNs: CLOCK_MONOTONIC 수신 시각 */
+    void writeCan(quint64 monoNs, quint32 canId, const quint8 *data, quint8 length);
+    void writeSomeIp(quint64 monoNs, quint16 service, quint16 instance, quint16 event,
+                     const quint8 *payload, quint8 length);
+
+    quint64 records() const { QMutexLocker lock(&m_lock); return m_records; }
+
+private:
+    void writeRecord(quint64 monoNs, TrafficRecord::Kind kind, const char *prefix, int prefixLen,
+                     const quint8 *data, quint8 length);
+
+    QFile          m_file;
+    mutable QMutex m_lock;
+    quint64        m_baseNs   = 0;
+    quint64        m_lastUs   = 0;
+    bool           m_haveBase = false;
+    quint64        m_records  = 0;
+};
+
+/** 재생 — 레코드를 순서대로 하나씩 */
+class TrafficLogReader
+{
+public:
+    bool open(const QString &path);
+    bool next(TrafficRecord &out);
+    QString errorString() const { return m_error; }
+    quint64 startRealtimeNs() const { return m_startRealtimeNs; }
+
+private:
+    QFile   m_file;
+    QString m_error;
+    quint64 m_startRealtimeNs = 0;
+    quint64 m_timeUs = 0;
+};
+
+#endif // TRAFFICLOG_H
@@ -4,19 +4,22 @@
  * - vsomeip::runtime::get()->create_application()
  * - request_service(0x1234, 0x0001)
  * - register_availability_handler: IC 서비스가 실제로 올라왔는지 확인
- * - send(request) on gear touch (only when service available)
+ * - send(request) on gear touch — 응답(applied gear, seq)까지 재전송, RTT 기록
+ * - 수신 값은 atomic 슬롯 + dirty 비트로 Qt 스레드에 전달 (drainIngress)
  * @author Ahn Hyunjun
  * @date 2026-02-20
  */
 
 #include "VSomeIPClient.h"
+#include "VehicleStateEvent.h"
+#include "GearRequest.h"
 #include <QDebug>
 #include <QMetaObject>
+#include <QTimer>
 
 #ifdef HU_HAS_VSOMEIP
 #include <cstring>
 #include <set>
-#include <vector>
 
 namespace {
 constexpr vsomeip::service_t      kServiceId         = 0x1234;
@@ -24,17 +27,18 @@ constexpr vsomeip::instance_t     kInstanceId        = 0x0001;
 constexpr vsomeip::method_t       kGearMethodId      = 0x8002;
 constexpr vsomeip::event_t        kSpeedEventId      = 0x8001;
 constexpr vsomeip::eventgroup_t   kSpeedEventGroupId = 0x0001;
+constexpr vsomeip::event_t        kStateEventId      = VehicleStateEvent::kEventId;
 }
 #endif
 
 VSomeIPClient::VSomeIPClient(QObject *parent)
     : IVehicleDataProvider(parent)
-    , m_speed(0.0f)
-    , m_gear(GearState::P)
-    , m_batteryVoltage(7.8f)
-    , m_batteryPercent(85.0f)
-    , m_connected(false)
 {
+    m_gearRetryTimer = new QTimer(this);
+    m_gearRetryTimer->setTimerType(Qt::PreciseTimer);
+    m_gearRetryTimer->setInterval(GearRequest::kRetryMs);
+    connect(m_gearRetryTimer, &QTimer::timeout, this, &VSomeIPClient::onGearRetryTimer);
+
 #ifdef HU_HAS_VSOMEIP
     m_app = vsomeip::runtime::get()->create_application("HeadUnit");
     if (!m_app) {
@@ -68,31 +72,77 @@ VSomeIPClient::~VSomeIPClient()
 #endif
 }
 
-float VSomeIPClient::speed() const { return m_speed; }
-GearState VSomeIPClient::gear() const { return m_gear; }
-float VSomeIPClient::batteryVoltage() const { return m_batteryVoltage; }
-float VSomeIPClient::batteryPercent() const { return m_batteryPercent; }
-bool VSomeIPClient::isConnected() const { return m_connected; }
+float VSomeIPClient::speed() const { return m_speed.load(std::memory_order_relaxed); }
+GearState VSomeIPClient::gear() const { return static_cast<GearState>(m_gear.load(std::memory_order_relaxed)); }
+float VSomeIPClient::batteryVoltage() const { return m_batteryVoltage.load(std::memory_order_relaxed); }
+float VSomeIPClient::batteryPercent() const { return m_batteryPercent.load(std::memory_order_relaxed); }
+bool VSomeIPClient::isConnected() const { return m_connected.load(std::memory_order_relaxed); }
+
+int VSomeIPClient::clusterGearEcho() const
+{
+    const quint8 g = m_clusterGear.load(std::memory_order_relaxed);
+    return g == VehicleStateEvent::kGearUnknown ? -1 : g;
+}
+
+// ── vsomeip 스레드 → Qt 스레드 ────────────────────────────────────────
+
+void VSomeIPClient::markDirty(quint32 bits)
+{
+    // 값 store 뒤에 release — drain이 비트를 보면 값도 보인다
+    if (m_dirty.fetch_or(bits, std::memory_order_release) == 0)
+        QMetaObject::invokeMethod(this, "drainIngress", Qt::QueuedConnection);
+}
+
+void VSomeIPClient::drainIngress()
+{
+    const quint32 bits = m_dirty.exchange(0, std::memory_order_acquire);
+    if (bits & DirtyConnection)
+        emit connectionStatusChanged(isConnected());
+    if (bits & DirtySpeed)
+        emit speedChanged(speed());
+    if (bits & DirtyGear)
+        emit gearChanged(gear());
+    if (bits & DirtyBattery)
+        emit batteryChanged(batteryVoltage(), batteryPercent());
+    if (bits & DirtyGearAck)
+        handleGearAck(m_gearAck.load(std::memory_order_relaxed));
+}
+
+// ── 기어 요청 / 응답 ─────────────────────────────────────────────────
 
 void VSomeIPClient::publishGear(GearState gear)
 {
-    m_gear = gear;
+    m_gear.store(static_cast<quint8>(gear), std::memory_order_relaxed);
     static const char *names[] = {"P", "R", "N", "D"};
     qDebug() << "[VSomeIP] publishGear:" << names[static_cast<int>(gear)];
 #ifdef HU_HAS_VSOMEIP
+    // 이전 요청이 남아 있어도 새 seq로 대체 — 최신 기어만 의미가 있다
+    if (++m_gearSeq == 0) ++m_gearSeq;   // seq 0은 구버전 1-byte 요청용
+    const quint64 now = HuProtocol::monotonicNowNs();
+    m_pendingGear = PendingGear{ gear, m_gearSeq, now, now, true, false };
+    setAckState(GearAckState::Pending, gear);
+    sendGearRequest();
+    m_gearRetryTimer->start();
+#endif
+}
+
+void VSomeIPClient::sendGearRequest()
+{
+#ifdef HU_HAS_VSOMEIP
+    // 등록/서비스 전이면 보내지 않지만 요청은 유지 — 예산 안에 올라오면 재전송이 전달한다
     if (!m_app || !m_registered.load()) {
-        qWarning() << "[VSomeIP] publishGear skipped: not registered with routing manager";
+        qWarning() << "[VSomeIP] gear request deferred: not registered with routing manager";
         return;
     }
     if (!m_serviceAvailable.load()) {
-        qWarning() << "[VSomeIP] publishGear skipped: IC service 0x1234 not available yet"
+        qWarning() << "[VSomeIP] gear request deferred: IC service 0x1234 not available yet"
                    << "(Instrument Cluster가 먼저 실행됐는지 확인하세요)";
         return;
     }
+    vsomeip::byte_t data[GearRequest::kWireSize];
+    GearRequest::encode({ static_cast<quint8>(m_pendingGear.gear), m_pendingGear.seq }, data);
     auto payload = vsomeip::runtime::get()->create_payload();
-    std::vector<vsomeip::byte_t> data(1);
-    data[0] = static_cast<vsomeip::byte_t>(gear);
-    payload->set_data(data);
+    payload->set_data(data, sizeof(data));
 
     auto request = vsomeip::runtime::get()->create_request();
     request->set_service(kServiceId);
@@ -100,10 +150,69 @@ void VSomeIPClient::publishGear(GearState gear)
     request->set_method(kGearMethodId);
     request->set_payload(payload);
     m_app->send(request);
-    qDebug() << "[VSomeIP] gear request sent ->" << names[static_cast<int>(gear)];
 #endif
 }
 
+void VSomeIPClient::onGearRetryTimer()
+{
+    if (!m_pendingGear.active) {
+        m_gearRetryTimer->stop();
+        return;
+    }
+    const quint64 now = HuProtocol::monotonicNowNs();
+    if (now - m_pendingGear.firstSentNs >= quint64(GearRequest::kBudgetMs) * 1000000ull) {
+        m_pendingGear.active = false;
+        m_pendingGear.timedOut = true;
+        m_gearRetryTimer->stop();
+        ++m_gearTimeouts;
+        qWarning() << "[VSomeIP] gear request seq" << m_pendingGear.seq
+                   << "not acknowledged within" << GearRequest::kBudgetMs << "ms"
+                   << "(timeouts" << m_gearTimeouts << ")";
+        setAckState(GearAckState::Failed, m_pendingGear.gear);
+        return;
+    }
+    if (now - m_pendingGear.lastSentNs >= quint64(GearRequest::kRetryMs) * 1000000ull) {
+        m_pendingGear.lastSentNs = now;
+        ++m_gearRetransmits;
+        sendGearRequest();
+    }
+}
+
+void VSomeIPClient::handleGearAck(quint64 packed)
+{
+    const quint32   seq     = static_cast<quint32>(packed >> 8);
+    const GearState applied = static_cast<GearState>(packed & 0xFF);
+    // 최신 요청의 응답만 의미가 있다 (예산 초과로 실패 처리된 뒤 늦게 온 응답도 받아들인다)
+    if (seq == 0 || seq != m_pendingGear.seq)
+        return;
+    if (!m_pendingGear.active && !m_pendingGear.timedOut)
+        return;   // 이미 처리한 중복 응답 (재전송분)
+
+    const quint64 rttNs = HuProtocol::monotonicNowNs() - m_pendingGear.firstSentNs;
+    const bool late = m_pendingGear.timedOut;
+    m_pendingGear.active = false;
+    m_pendingGear.timedOut = false;
+    m_gearRetryTimer->stop();
+    m_gearRtt.add(rttNs);
+    m_ackedGear = applied;
+
+    qDebug() << "[VSomeIP] gear ack seq" << seq << "rtt" << rttNs / 1000 << "us"
+             << (late ? "(late)" : "")
+             << "p50" << m_gearRtt.percentileUs(0.5) << "p99" << m_gearRtt.percentileUs(0.99)
+             << "retransmits" << m_gearRetransmits;
+    emit gearAcknowledged(applied, static_cast<qint64>(rttNs / 1000));
+    setAckState(applied == m_pendingGear.gear ? GearAckState::Acknowledged : GearAckState::Failed,
+                applied);
+}
+
+void VSomeIPClient::setAckState(GearAckState state, GearState gear)
+{
+    if (state == m_ackState && state != GearAckState::Pending)
+        return;
+    m_ackState = state;
+    emit gearAckStateChanged(state, gear);
+}
+
 #ifdef HU_HAS_VSOMEIP
 void VSomeIPClient::onState(vsomeip::state_type_e state)
 {
@@ -121,20 +230,29 @@ void VSomeIPClient::onState(vsomeip::state_type_e state)
                 onAvailability(s, i, available);
             });
 
-        // Subscribe to speed event (0x8001) from IC
+        // Subscribe to vehicle state (0x8004) + legacy speed (0x8001) from IC
         std::set<vsomeip::eventgroup_t> groups = {kSpeedEventGroupId};
+        m_app->request_event(kServiceId, kInstanceId, kStateEventId, groups,
+                             vsomeip::event_type_e::ET_FIELD);
+        m_app->register_message_handler(kServiceId, kInstanceId, kStateEventId,
+            [this](const std::shared_ptr<vsomeip::message> &msg) {
+                onVehicleState(msg);
+            });
+        // Gear method responses (applied gear + seq)
+        m_app->register_message_handler(kServiceId, kInstanceId, kGearMethodId,
+            [this](const std::shared_ptr<vsomeip::message> &msg) {
+                onGearResponse(msg);
+            });
         m_app->request_event(kServiceId, kInstanceId, kSpeedEventId, groups);
         m_app->register_message_handler(kServiceId, kInstanceId, kSpeedEventId,
             [this](const std::shared_ptr<vsomeip::message> &msg) {
-                if (!msg) return;
+                if (!msg || m_stateSeen) return;
                 auto pl = msg->get_payload();
                 if (!pl || pl->get_length() < 4) return;
                 float kmh = 0.0f;
                 std::memcpy(&kmh, pl->get_data(), 4);
-                m_speed = kmh;
-                QMetaObject::invokeMethod(this, [this, kmh]() {
-                    emit speedChanged(kmh);
-                }, Qt::QueuedConnection);
+                m_speed.store(kmh, std::memory_order_relaxed);
+                markDirty(DirtySpeed);
             });
         m_app->subscribe(kServiceId, kInstanceId, kSpeedEventGroupId);
 
@@ -144,24 +262,75 @@ void VSomeIPClient::onState(vsomeip::state_type_e state)
     // ST_DEREGISTERED
     m_registered = false;
     m_serviceAvailable = false;
-    m_connected = false;
+    if (m_connected.exchange(false))
+        markDirty(DirtyConnection);
     qWarning() << "[VSomeIP] Deregistered from routing manager";
 }
 
+void VSomeIPClient::onVehicleState(const std::shared_ptr<vsomeip::message> &msg)
+{
+    if (!msg) return;
+    const auto pl = msg->get_payload();
+    if (!pl) return;
+
+    // 스택 디코드 — payload 버퍼를 직접 읽는다 (할당 없음)
+    VehicleStateEvent::State st;
+    if (!VehicleStateEvent::decode(pl->get_data(), pl->get_length(), st)) {
+        qWarning() << "[VSomeIP] vehicle state: bad payload (" << pl->get_length() << "bytes )";
+        return;
+    }
+    m_stateReceived.fetch_add(1, std::memory_order_relaxed);
+
+    if (m_stateSeen) {
+        if (!VehicleStateEvent::isNewer(st.sequence, m_lastStateSeq)
+            && m_lastStateSeq - st.sequence < 1024u) {
+            return;   // 재전송/순서 뒤바뀜 — 이미 더 최신 값을 가지고 있다
+        }
+        // 큰 역행은 클러스터 재시작으로 보고 그대로 받아들인다
+        if (VehicleStateEvent::isNewer(st.sequence, m_lastStateSeq))
+            m_stateGaps.fetch_add(st.sequence - m_lastStateSeq - 1, std::memory_order_relaxed);
+    }
+    m_stateSeen = true;
+    m_lastStateSeq = st.sequence;
+
+    quint32 dirty = 0;
+    if (st.hasSpeed() && m_speed.exchange(st.speedKmh, std::memory_order_relaxed) != st.speedKmh)
+        dirty |= DirtySpeed;
+    if (st.hasBattery()) {
+        const float oldV = m_batteryVoltage.exchange(st.batteryVoltage, std::memory_order_relaxed);
+        const float oldP = m_batteryPercent.exchange(st.batteryPercent, std::memory_order_relaxed);
+        if (oldV != st.batteryVoltage || oldP != st.batteryPercent)
+            dirty |= DirtyBattery;
+    }
+    m_clusterGear.store(st.gearEcho, std::memory_order_relaxed);
+    if (dirty)
+        markDirty(dirty);
+}
+
+void VSomeIPClient::onGearResponse(const std::shared_ptr<vsomeip::message> &msg)
+{
+    if (!msg || msg->get_message_type() != vsomeip::message_type_e::MT_RESPONSE) return;
+    const auto pl = msg->get_payload();
+    GearRequest::Payload ack;
+    if (!pl || pl->get_length() < GearRequest::kWireSize
+        || !GearRequest::decode(pl->get_data(), pl->get_length(), ack)) {
+        return;
+    }
+    m_gearAck.store((quint64(ack.seq) << 8) | ack.gear, std::memory_order_relaxed);
+    markDirty(DirtyGearAck);
+}
+
 void VSomeIPClient::onAvailability(vsomeip::service_t /*service*/,
                                    vsomeip::instance_t /*instance*/,
                                    bool available)
 {
     m_serviceAvailable = available;
     m_connected = available;
+    markDirty(DirtyConnection);   // onAvailability runs on a vsomeip thread
     if (available) {
         qDebug() << "[VSomeIP] IC service 0x1234 is NOW AVAILABLE - gear IPC ready";
     } else {
         qWarning() << "[VSomeIP] IC service 0x1234 UNAVAILABLE - Instrument Cluster 연결 끊김";
     }
-    // onAvailability runs on a vsomeip thread — emit signal on Qt main thread.
-    QMetaObject::invokeMethod(this, [this, available]() {
-        emit connectionStatusChanged(available);
-    }, Qt::QueuedConnection);
 }
 #endif
@@ -1,10 +1,17 @@
 /**
  * @file VSomeIPClient.h
  * @brief VSOMEIP implementation for Head Unit ↔ Instrument Cluster IPC
- * Subscribe: 0x8001 speed, 0x8002 gear, 0x8003 battery
- * Publish: 0x8002 gear (on touch)
+ * Subscribe: 0x8004 vehicle state (speed/battery/gear echo, VehicleStateEvent.h)
+ *            0x8001 speed (legacy — 0x8004를 받기 시작하면 무시)
+ * Publish: 0x8002 gear (on touch) — request/response, seq + 재전송 (GearRequest.h)
  * Service: 0x1234, Instance: 0x0001
  * Config: /etc/vsomeip/vsomeip_headunit.json
+ *
+ * 스레드 모델: vsomeip 핸들러는 vsomeip 워커 스레드에서 돈다.
+ *   - 최신 값은 atomic 슬롯에 저장 (getter는 어느 스레드에서든 lock 없이 읽는다)
+ *   - 바뀐 항목은 m_dirty 비트로 표시, 0 → non-0 전이 때만 drainIngress()를 큐잉
+ *   - drainIngress()는 Qt 스레드에서 비트를 한 번에 가져와 항목별 시그널을 1회씩 emit
+ * 이벤트 루프 1회당 post 1번 — 샘플마다 람다 할당/post 하지 않는다 (중간 샘플은 합쳐진다).
  * @author Ahn Hyunjun
  * @date 2026-02-20
  */
@@ -13,10 +20,14 @@
 #define VSOMEIPCLIENT_H
 
 #include "IVehicleDataProvider.h"
+#include "LatencyHistogram.h"
+
+#include <atomic>
+
+class QTimer;
 
 #ifdef HU_HAS_VSOMEIP
 #include <vsomeip/vsomeip.hpp>
-#include <atomic>
 #include <memory>
 #include <mutex>
 #include <thread>
@@ -42,14 +53,79 @@ public:
     float batteryPercent() const override;
     bool isConnected() const override;
 
+    /** 클러스터에 기어 요청 — 응답까지 재전송, 결과는 gearAckStateChanged로 */
     void publishGear(GearState gear);
 
+    GearAckState gearAckState() const { return m_ackState; }
+    /** 클러스터가 마지막으로 응답한(반영한) 기어 */
+    GearState acknowledgedGear() const { return m_ackedGear; }
+
+    // ── 기어 요청 통계 (Qt 스레드) ──
+    /** 첫 전송 → 응답 처리까지 (재전송 포함 end-to-end) */
+    const HuProtocol::LatencyHistogram &gearRoundTrip() const { return m_gearRtt; }
+    quint32 gearRetransmits() const { return m_gearRetransmits; }
+    quint32 gearTimeouts() const { return m_gearTimeouts; }
+
+    /** 클러스터가 0x8004로 알려준 표시 중 기어 (받은 적 없으면 -1) */
+    int clusterGearEcho() const;
+    /** 0x8004 sequence 누락 누계 (UDP 손실/클러스터 재시작 진단용) */
+    quint32 vehicleStateGaps() const { return m_stateGaps.load(std::memory_order_relaxed); }
+    /** 디코드에 성공한 0x8004 이벤트 누계 (시그널은 합쳐지므로 수신량은 이 값으로 본다) */
+    quint32 vehicleStateReceived() const { return m_stateReceived.load(std::memory_order_relaxed); }
+
+signals:
+    void gearAckStateChanged(GearAckState state, GearState gear);
+    /** rttUs: 첫 전송부터 응답 처리까지 */
+    void gearAcknowledged(GearState applied, qint64 rttUs);
+
+private slots:
+    void drainIngress();   // Qt 스레드 — 쌓인 변경을 시그널로
+    void onGearRetryTimer();
+
 private:
-    float m_speed;
-    GearState m_gear;
-    float m_batteryVoltage;
-    float m_batteryPercent;
-    bool m_connected;
+    enum DirtyBit : quint32 {
+        DirtySpeed      = 1u << 0,
+        DirtyGear       = 1u << 1,
+        DirtyBattery    = 1u << 2,
+        DirtyConnection = 1u << 3,
+        DirtyGearAck    = 1u << 4,
+    };
+    /** 아무 스레드에서나 호출 — 비트를 세우고 필요하면 drainIngress()를 한 번 큐잉 */
+    void markDirty(quint32 bits);
+
+    void sendGearRequest();
+    void handleGearAck(quint64 packed);
+    void setAckState(GearAckState state, GearState gear);
+
+    // 최신 값 슬롯 (writer: vsomeip 워커 / publishGear, reader: 아무 스레드)
+    std::atomic<float>   m_speed{0.0f};
+    std::atomic<quint8>  m_gear{static_cast<quint8>(GearState::P)};
+    std::atomic<float>   m_batteryVoltage{7.8f};
+    std::atomic<float>   m_batteryPercent{85.0f};
+    std::atomic<bool>    m_connected{false};
+    std::atomic<quint8>  m_clusterGear{0xFF};
+    std::atomic<quint32> m_stateGaps{0};
+    std::atomic<quint32> m_stateReceived{0};
+    std::atomic<quint32> m_dirty{0};
+    std::atomic<quint64> m_gearAck{0};   // seq << 8 | appliedGear — 최신 응답
+
+    // 진행 중인 기어 요청 (Qt 스레드 전용)
+    struct PendingGear {
+        GearState gear        = GearState::P;
+        quint32   seq         = 0;
+        quint64   firstSentNs = 0;
+        quint64   lastSentNs  = 0;
+        bool      active      = false;
+        bool      timedOut    = false;   // 예산 초과 후 늦은 응답은 그래도 받아들인다
+    };
+    PendingGear                  m_pendingGear;
+    quint32                      m_gearSeq = 0;
+    QTimer                      *m_gearRetryTimer = nullptr;
+    GearAckState                 m_ackState  = GearAckState::Idle;
+    GearState                    m_ackedGear = GearState::P;
+    HuProtocol::LatencyHistogram m_gearRtt;
+    quint32                      m_gearRetransmits = 0;
+    quint32                      m_gearTimeouts    = 0;
 
 #ifdef HU_HAS_VSOMEIP
     std::shared_ptr<vsomeip::application> m_app;
@@ -60,6 +136,11 @@ private:
     std::atomic<bool> m_serviceAvailable{false};  // IC 서비스(0x1234)가 실제로 올라왔는가
     void onState(vsomeip::state_type_e state);
     void onAvailability(vsomeip::service_t service, vsomeip::instance_t instance, bool available);
+    void onVehicleState(const std::shared_ptr<vsomeip::message> &msg);
+    void onGearResponse(const std::shared_ptr<vsomeip::message> &msg);
+
+    std::atomic<bool> m_stateSeen{false};   // 0x8004를 받은 뒤로는 legacy 0x8001을 무시
+    quint32 m_lastStateSeq = 0;             // onVehicleState 전용
 #endif
 };
 
@@ -0,0 +1,147 @@
+/**
+ * @file VehicleStateEvent.h
+ * @brief SOME/IP 0x8004 vehicle state 이벤트 — 고정 레이아웃 codec (header-only)
+ *
+ * Instrument Cluster(publisher)와 Head Unit(VSomeIPClient, subscriber)이 같은 헤더를 쓴다.
+ * Qt/vsomeip 의존성 없이 <cstdint>만 사용 — 양쪽 빌드(Qt5/Qt6)에 그대로 포함된다.
+ *
+ * 와이어 레이아웃 (v1, 32 bytes, big-endian):
+ *   off  size  field
+ *    0    1    version          (= kVersion)
+ *    1    1    gearEcho         클러스터가 현재 표시 중인 기어 (0..3, 0xFF = 모름)
+ *    2    1    flags            FlagSpeedValid | FlagBatteryValid
+ *    3    1    reserved         (0)
+ *    4    4    sequence         publish마다 +1
+ *    8    4    speedKmh         float32 (IEEE-754 비트를 u32로)
+ *   12    4    batteryVoltage   float32
+ *   16    4    batteryPercent   float32
+ *   20    2    speedAgeMs       publish 시점 기준 속도 샘플 나이 (포화 0xFFFF)
+ *   22    2    batteryAgeMs     publish 시점 기준 배터리 샘플 나이 (포화 0xFFFF)
+ *   24    8    publishTimeUs    클러스터 steady clock (µs) — 지터/간격 측정용
+ *
+ * 호환성: 필드를 추가할 때는 뒤에 붙이고 version은 그대로 둔다 (decode는 남는 바이트를 무시).
+ * 기존 필드의 의미/위치가 바뀔 때만 version을 올린다 — 다른 version은 decode가 거부한다.
+ */
+
+#ifndef VEHICLESTATEEVENT_H
+#define VEHICLESTATEEVENT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace VehicleStateEvent {
+
+constexpr std::uint16_t kEventId    = 0x8004;
+constexpr std::uint8_t  kVersion    = 1;
+constexpr std::size_t   kWireSize   = 32;
+constexpr int           kCycleMs    = 100;     // 클러스터 publish 주기
+constexpr std::uint8_t  kGearUnknown = 0xFF;
+
+enum Flags : std::uint8_t {
+    FlagSpeedValid   = 1u << 0,
+    FlagBatteryValid = 1u << 1,
+};
+
+/** 디코드된 이벤트 (POD — 스택에 두고 복사) */
+struct State {
+    std::uint8_t  gearEcho       = kGearUnknown;
+    std::uint8_t  flags          = 0;
+    std::uint32_t sequence       = 0;
+    float         speedKmh       = 0.0f;
+    float         batteryVoltage = 0.0f;
+    float         batteryPercent = 0.0f;
+    std::uint16_t speedAgeMs     = 0xFFFF;
+    std::uint16_t batteryAgeMs   = 0xFFFF;
+    std::uint64_t publishTimeUs  = 0;
+
+    bool hasSpeed() const   { return flags & FlagSpeedValid; }
+    bool hasBattery() const { return flags & FlagBatteryValid; }
+};
+
+// ── 내부 헬퍼 ─────────────────────────────────────────────────────────
+namespace detail {
+inline void put16(std::uint8_t *p, std::uint16_t v) { p[0] = v >> 8; p[1] = v & 0xFF; }
+inline void put32(std::uint8_t *p, std::uint32_t v)
+{
+    p[0] = v >> 24; p[1] = (v >> 16) & 0xFF; p[2] = (v >> 8) & 0xFF; p[3] = v & 0xFF;
+}
+inline void put64(std::uint8_t *p, std::uint64_t v)
+{
+    put32(p, static_cast<std::uint32_t>(v >> 32));
+    put32(p + 4, static_cast<std::uint32_t>(v));
+}
+inline void putF(std::uint8_t *p, float f)
+{
+    std::uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    put32(p, bits);
+}
+inline std::uint16_t get16(const std::uint8_t *p) { return std::uint16_t(p[0] << 8 | p[1]); }
+inline std::uint32_t get32(const std::uint8_t *p)
+{
+    return std::uint32_t(p[0]) << 24 | std::uint32_t(p[1]) << 16 | std::uint32_t(p[2]) << 8 | p[3];
+}
+inline std::uint64_t get64(const std::uint8_t *p)
+{
+    return std::uint64_t(get32(p)) << 32 | get32(p + 4);
+}
+inline float getF(const std::uint8_t *p)
+{
+    const std::uint32_t bits = get32(p);
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+} // namespace detail
+
+/** out에 kWireSize 바이트를 쓴다 (호출자 버퍼 — 할당 없음) */
+inline void encode(const State &s, std::uint8_t *out)
+{
+    out[0] = kVersion;
+    out[1] = s.gearEcho;
+    out[2] = s.flags;
+    out[3] = 0;
+    detail::put32(out + 4,  s.sequence);
+    detail::putF (out + 8,  s.speedKmh);
+    detail::putF (out + 12, s.batteryVoltage);
+    detail::putF (out + 16, s.batteryPercent);
+    detail::put16(out + 20, s.speedAgeMs);
+    detail::put16(out + 22, s.batteryAgeMs);
+    detail::put64(out + 24, s.publishTimeUs);
+}
+
+/** @return 길이가 짧거나 version이 다르면 false (out은 건드리지 않는다) */
+inline bool decode(const std::uint8_t *data, std::size_t length, State &out)
+{
+    if (!data || length < kWireSize || data[0] != kVersion)
+        return false;
+    out.gearEcho       = data[1];
+    out.flags          = data[2];
+    out.sequence       = detail::get32(data + 4);
+    out.speedKmh       = detail::getF (data + 8);
+    out.batteryVoltage = detail::getF (data + 12);
+    out.batteryPercent = detail::getF (data + 16);
+    out.speedAgeMs     = detail::get16(data + 20);
+    out.batteryAgeMs   = detail::get16(data + 22);
+    out.publishTimeUs  = detail::get64(data + 24);
+    return true;
+}
+
+/** 샘플 나이(µs)를 와이어의 ms 필드로 — 음수는 0, 너무 오래되면 0xFFFF */
+inline std::uint16_t ageField(std::int64_t ageUs)
+{
+    if (ageUs <= 0) return 0;
+    const std::int64_t ms = ageUs / 1000;
+    return ms >= 0xFFFF ? 0xFFFF : static_cast<std::uint16_t>(ms);
+}
+
+/** 32-bit sequence 비교 (wrap-around 안전) — a가 b보다 나중이면 true */
+inline bool isNewer(std::uint32_t a, std::uint32_t b)
+{
+    return static_cast<std::int32_t>(a - b) > 0;
+}
+
+} // namespace VehicleStateEvent
+
+#endif // VEHICLESTATEEVENT_H
@@ -0,0 +1,171 @@
+/**
+ * @file PdcFilter.cpp
+ */
+
+#include "PdcFilter.h"
+#include "PdcWarning.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+constexpr float kKmhToCmS = 100000.0f / 3600.0f;
+
+float median3(float a, float b, float c)
+{
+    return std::max(std::min(a, b), std::min(std::max(a, b), c));
+}
+
+float secondsBetween(quint64 fromNs, quint64 toNs)
+{
+    return toNs > fromNs ? static_cast<float>(toNs - fromNs) * 1e-9f : 0.0f;
+}
+} // namespace
+
+// ── PdcSensorTrack ──────────────────────────────────────────────────────
+
+void PdcSensorTrack::reset()
+{
+    *this = PdcSensorTrack();
+}
+
+void PdcSensorTrack::start(float distanceCm, quint64 timeNs, float closingCmS)
+{
+    m_x = distanceCm;
+    m_v = -closingCmS;
+    m_lastAcceptedCm = distanceCm;
+    m_warningCm = distanceCm;
+    m_timeNs = timeNs;
+    m_valid = true;
+}
+
+PdcSensorTrack::Update PdcSensorTrack::update(float distanceCm, quint64 timeNs,
+                                              float maxClosingCmS, const PdcFilterConfig &cfg)
+{
+    const float dt = secondsBetween(m_timeNs, timeNs);
+    if (!m_valid || dt > cfg.maxGapS || timeNs < m_timeNs) {
+        // 새 트랙은 속도 0에서 — 첫 프레임만으로 예측 경고를 내지 않는다
+        start(distanceCm, timeNs, 0.0f);
+        m_recentRaw = {{distanceCm, -1.0f}};
+        m_rawCount = 1;
+        return Update::Accepted;
+    }
+
+    const float predicted = m_x + m_v * dt;
+    const float gate = cfg.noiseCm + maxClosingCmS * dt;
+
+    Update result = Update::Accepted;
+    float measured = distanceCm;
+    if (m_rawCount >= 2 && std::fabs(distanceCm - predicted) > gate) {
+        const float med = median3(m_recentRaw[0], m_recentRaw[1], distanceCm);
+        if (std::fabs(med - predicted) > gate) {
+            // 두 프레임 이상이 새 거리에 동의 — 진짜 변화(새 장애물 등)
+            start(distanceCm, timeNs, 0.0f);
+            result = Update::Restarted;
+        } else {
+            measured = med;
+            result = Update::Outlier;
+        }
+    }
+
+    m_recentRaw[1] = m_recentRaw[0];
+    m_recentRaw[0] = distanceCm;
+    m_rawCount = std::min(m_rawCount + 1, 3);
+    if (result == Update::Restarted) {
+        return result;
+    }
+
+    const float residual = measured - predicted;
+    m_x = std::max(0.0f, predicted + cfg.alpha * residual);
+    if (dt > 0.0f) {
+        m_v = std::clamp(m_v + (cfg.beta / dt) * residual, -maxClosingCmS, maxClosingCmS);
+    }
+    m_lastAcceptedCm = measured;
+    // 가까워지는 쪽은 raw 경로보다 늦지 않게 — 단계가 오르면 outlier라도 경고에는 바로 반영
+    m_warningCm = measured;
+    if (result == Update::Outlier && distanceCm < measured
+        && PdcWarning::levelForDistance(distanceCm) > PdcWarning::levelForDistance(measured)) {
+        m_warningCm = distanceCm;
+    }
+    m_timeNs = timeNs;
+    return result;
+}
+
+float PdcSensorTrack::predictCm(quint64 nowNs, float aheadS) const
+{
+    return std::max(0.0f, m_x + m_v * (secondsBetween(m_timeNs, nowNs) + aheadS));
+}
+
+// ── PdcFilter ───────────────────────────────────────────────────────────
+
+PdcFilter::PdcFilter(const PdcFilterConfig &config)
+    : m_config(config)
+{
+}
+
+void PdcFilter::reset()
+{
+    for (PdcSensorTrack &track : m_tracks) {
+        track.reset();
+    }
+}
+
+void PdcFilter::dropSensor(int index)
+{
+    if (index >= 0 && index < kPdcSensorCount) {
+        m_tracks[index].reset();
+    }
+}
+
+float PdcFilter::maxClosingCmS() const
+{
+    // 정지 물체는 차속으로 다가온다 — 여기에 움직이는 물체 여유만 더한다
+    return std::max(0.0f, m_vehicleSpeedKmh) * kKmhToCmS + m_config.movingObstacleCmS;
+}
+
+void PdcFilter::update(const PdcSample &sample, quint64 nowNs)
+{
+    const quint64 timeNs = sample.timestampNs ? sample.timestampNs : nowNs;
+    const float maxClosing = maxClosingCmS();
+
+    ++m_stats.samples;
+    for (int i = 0; i < kPdcSensorCount; ++i) {
+        if (!sample.isValid(i)) {
+            continue;   // 무효 센서는 트랙을 건드리지 않는다 — 오래되면 estimate에서 빠진다
+        }
+        switch (m_tracks[i].update(sample.distanceCm[i], timeNs, maxClosing, m_config)) {
+        case PdcSensorTrack::Update::Outlier:   ++m_stats.outliers; break;
+        case PdcSensorTrack::Update::Restarted: ++m_stats.restarts; break;
+        case PdcSensorTrack::Update::Accepted:  break;
+        }
+    }
+}
+
+PdcFilter::Estimate PdcFilter::estimate(quint64 nowNs) const
+{
+    Estimate out;
+    const PdcSensorTrack *closest = nullptr;
+
+    for (const PdcSensorTrack &track : m_tracks) {
+        if (!track.isValid() || secondsBetween(track.timeNs(), nowNs) > m_config.maxGapS) {
+            continue;
+        }
+        if (out.nearestCm < 0.0f || track.distanceCm() < out.nearestCm) {
+            out.nearestCm = track.distanceCm();
+        }
+        const float warningCm = std::min(track.warningMeasureCm(),
+                                         track.predictCm(nowNs, m_config.lookaheadS));
+        if (out.warningCm < 0.0f || warningCm < out.warningCm) {
+            out.warningCm = warningCm;
+            closest = &track;
+        }
+    }
+
+    if (closest) {
+        out.closingCmS = closest->closingCmS();
+        if (out.closingCmS > m_config.minClosingCmS) {
+            out.timeToCollisionS = closest->predictCm(nowNs, 0.0f) / out.closingCmS;
+        }
+    }
+    return out;
+}
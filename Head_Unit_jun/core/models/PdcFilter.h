@@ -0,0 +1,108 @@
+/**
+ * @file PdcFilter.h
+ * @brief PDC 센서별 필터 — median-3 outlier 제거 + alpha-beta 추적 → 접근 속도 / TTC / 예측 거리
+ *
+ * CAN 프레임은 ~200 ms마다 오므로, 다음 프레임 전에 장애물이 경고 경계를 넘는 것을
+ * 예측해서 경고를 앞당긴다. 규칙:
+ *   - 게이트(노이즈 + 허용 접근 속도 × dt) 밖의 값은 최근 raw 3개의 median으로 대체
+ *     → 한 프레임짜리 튀는 값은 트랙에서 버려지고, 두 프레임 연속이면 새 값으로 트랙을 다시 시작
+ *   - 비대칭: 버려진 값이 더 가깝고 경고 단계를 올린다면 경고 거리에는 그 raw를 바로 쓴다
+ *     (트랙/속도는 median 그대로) — 갑자기 나타난 장애물이 한 CAN 주기 늦게 경고되지 않도록.
+ *     그래서 단계를 올리는 가까운 쪽 튐은 걸러지지 않는다 (멀어지는 쪽 / 같은 단계 안의 튐만 걸러짐)
+ *   - 접근 속도는 차속(setVehicleSpeed)으로 상한을 둔다 (정지 물체 가정 + 움직이는 물체 여유)
+ *   - 경고 거리 = min(경고용 raw, now + lookahead 시점의 예측 거리)
+ *     → 필터 때문에 경고가 raw 경로보다 늦어지는 일은 없고, 예측은 경고를 앞당기기만 한다
+ * 고정 크기, 할당 없음. 시각은 sample.timestampNs와 같은 시계면 무엇이든 된다
+ * (HU: CLOCK_REALTIME, 오프라인 평가: 녹화 시각).
+ */
+
+#ifndef PDCFILTER_H
+#define PDCFILTER_H
+
+#include "PdcTypes.h"
+
+#include <array>
+
+struct PdcFilterConfig {
+    float alpha = 0.5f;               // 위치 보정 이득
+    float beta = 0.2f;                // 속도 보정 이득
+    float noiseCm = 12.0f;            // 초음파 측정 노이즈 (게이트 여유)
+    float movingObstacleCmS = 100.0f; // 차가 서 있어도 허용하는 물체 접근 속도
+    float lookaheadS = 0.2f;          // 예측 시점 = now + 한 CAN 주기
+    float minClosingCmS = 5.0f;       // 이보다 느리면 TTC 없음
+    float maxGapS = 0.6f;             // 이보다 오래 비면 트랙을 새로 시작
+};
+
+/** 센서 하나의 트랙 */
+class PdcSensorTrack
+{
+public:
+    enum class Update : quint8 { Accepted, Outlier, Restarted };
+
+    void reset();
+    Update update(float distanceCm, quint64 timeNs, float maxClosingCmS, const PdcFilterConfig &cfg);
+
+    bool isValid() const { return m_valid; }
+    quint64 timeNs() const { return m_timeNs; }
+    float distanceCm() const { return m_x; }
+    float measuredCm() const { return m_lastAcceptedCm; }
+    /** 경고 단계용 측정값 — 보통 measuredCm(), 단계를 올리는 가까운 outlier면 그 raw */
+    float warningMeasureCm() const { return m_warningCm; }
+    /** 접근 속도 cm/s — 양수 = 가까워지는 중 */
+    float closingCmS() const { return -m_v; }
+    /** timeNs 기준 aheadS 초 뒤의 예측 거리 (0 이상) */
+    float predictCm(quint64 nowNs, float aheadS) const;
+
+private:
+    void start(float distanceCm, quint64 timeNs, float closingCmS);
+
+    float m_x = -1.0f;               // 추정 거리
+    float m_v = 0.0f;                // 거리 변화율 cm/s
+    float m_lastAcceptedCm = -1.0f;
+    float m_warningCm = -1.0f;
+    quint64 m_timeNs = 0;
+    std::array<float, 2> m_recentRaw{{-1.0f, -1.0f}};   // 직전 raw 2개 (median-3용)
+    int m_rawCount = 0;
+    bool m_valid = false;
+};
+
+/** 후방 4채널 필터 + 차속 */
+class PdcFilter
+{
+public:
+    struct Estimate {
+        float nearestCm = -1.0f;        // 필터된 최근접 거리 (유효 트랙 없음 = -1)
+        float warningCm = -1.0f;        // 경고 단계 계산용 — min(raw, 예측)
+        float closingCmS = 0.0f;        // 최근접 센서의 접근 속도
+        float timeToCollisionS = -1.0f; // -1 = 접근 중 아님
+    };
+
+    struct Stats {
+        quint64 samples = 0;
+        quint64 outliers = 0;           // median으로 대체된 측정
+        quint64 restarts = 0;           // 두 프레임 연속 점프 → 트랙 재시작
+    };
+
+    explicit PdcFilter(const PdcFilterConfig &config = PdcFilterConfig());
+
+    void reset();
+    /** 센서 하나가 끊겼을 때 (PdcSensorMonitor) — 그 트랙만 비우고 나머지는 유지 */
+    void dropSensor(int index);
+    void setVehicleSpeed(float kmh) { m_vehicleSpeedKmh = kmh; }
+    /** timestampNs가 0인 sample(mock 등)은 nowNs 시각으로 처리한다 */
+    void update(const PdcSample &sample, quint64 nowNs);
+    Estimate estimate(quint64 nowNs) const;
+
+    const PdcFilterConfig &config() const { return m_config; }
+    const Stats &stats() const { return m_stats; }
+
+private:
+    float maxClosingCmS() const;
+
+    PdcFilterConfig m_config;
+    std::array<PdcSensorTrack, kPdcSensorCount> m_tracks;
+    float m_vehicleSpeedKmh = 0.0f;
+    Stats m_stats;
+};
+
+#endif // PDCFILTER_H
@@ -0,0 +1,105 @@
+#include "PdcSensorMonitor.h"
+
+#include <cmath>
+
+PdcSensorMonitor::PdcSensorMonitor()
+    : m_wheel(kTickNs)
+{
+    reset();
+}
+
+void PdcSensorMonitor::reset()
+{
+    m_wheel.clear();
+    m_status.fill(PdcSensorStatus::Stale);
+    m_health.fill(PdcSensorHealth());
+    m_distanceCm.fill(-1.0f);
+    m_lastReadingNs.fill(0);
+}
+
+quint8 PdcSensorMonitor::maskOf(PdcSensorStatus status) const
+{
+    quint8 mask = 0;
+    for (int i = 0; i < kPdcSensorCount; ++i) {
+        if (m_status[i] == status)
+            mask |= static_cast<quint8>(1u << i);
+    }
+    return mask;
+}
+
+void PdcSensorMonitor::recordInterval(int index, quint64 readingNs)
+{
+    const quint64 previous = m_lastReadingNs[index];
+    m_lastReadingNs[index] = readingNs;
+    if (previous == 0 || readingNs <= previous)
+        return;   // 첫 측정 또는 순서가 뒤바뀐 프레임
+
+    PdcSensorHealth &h = m_health[index];
+    const float intervalMs = static_cast<float>(readingNs - previous) / 1e6f;
+    if (h.meanIntervalMs <= 0.0f) {
+        h.meanIntervalMs = intervalMs;
+    } else {
+        h.jitterMs += (std::fabs(intervalMs - h.meanIntervalMs) - h.jitterMs) / 16.0f;
+        h.meanIntervalMs += (intervalMs - h.meanIntervalMs) / 16.0f;
+    }
+    if (intervalMs > h.maxIntervalMs)
+        h.maxIntervalMs = intervalMs;
+}
+
+void PdcSensorMonitor::update(const PdcSample &sample, quint64 readingNs)
+{
+    for (int i = 0; i < kPdcSensorCount; ++i) {
+        PdcSensorHealth &h = m_health[i];
+        ++h.readings;
+
+        if (sample.isValid(i)) {
+            ++h.valid;
+            m_status[i] = PdcSensorStatus::Fresh;
+            m_distanceCm[i] = sample.distanceCm[i];
+        } else if ((sample.outOfRangeMask >> i) & 1u) {
+            // 센서는 측정했지만 쓸 수 있는 값이 아니다 (에코 없음 등) — 살아 있음
+            ++h.outOfRange;
+            m_status[i] = PdcSensorStatus::Invalid;
+        } else {
+            // 센서가 스스로 invalid를 보고 — 측정이 아니므로 deadline을 미루지 않는다
+            ++h.reportedInvalid;
+            if (m_status[i] == PdcSensorStatus::Fresh)
+                m_status[i] = PdcSensorStatus::Invalid;
+            continue;
+        }
+
+        recordInterval(i, readingNs);
+        m_wheel.schedule(i, readingNs + kTimeoutNs);
+    }
+}
+
+quint8 PdcSensorMonitor::expire(quint64 nowNs)
+{
+    // CLOCK_REALTIME이 뒤로 가면 deadline이 한없이 멀어진다 — timeout보다 먼 deadline은 지금 만료
+    for (int i = 0; i < kPdcSensorCount; ++i) {
+        if (m_wheel.isScheduled(i) && m_wheel.deadlineNs(i) > nowNs + kTimeoutNs)
+            m_wheel.schedule(i, nowNs);
+    }
+
+    quint8 expired = 0;
+    m_wheel.advance(nowNs, [this, &expired](int index) {
+        ++m_health[index].dropouts;
+        m_status[index] = PdcSensorStatus::Stale;
+        m_lastReadingNs[index] = 0;
+        expired |= static_cast<quint8>(1u << index);
+    });
+    return expired;
+}
+
+quint8 PdcSensorMonitor::expireAll()
+{
+    const quint8 alive = aliveMask();
+    for (int i = 0; i < kPdcSensorCount; ++i) {
+        if ((alive >> i) & 1u)
+            ++m_health[i].dropouts;
+        m_status[i] = PdcSensorStatus::Stale;
+    }
+    m_wheel.clear();
+    m_lastReadingNs.fill(0);
+    return alive;
+}
@@ -0,0 +1,88 @@
+/**
+ * @file PdcSensorMonitor.h
+ * @brief PDC 센서별 신선도 / 건강 상태 — 측정 시각 기준 timer wheel 하나로 4채널 timeout 관리
+ *
+ * 배열 전체에 타이머 하나를 두면 죽은 센서 하나는 드러나지 않고, 늦은 프레임 하나에 전부 stale이 된다.
+ * 센서마다:
+ *   Fresh   — 유효 범위 안의 측정이 timeout 안에 있었다 (거리 사용)
+ *   Invalid — 채널은 살아 있지만 마지막 값이 범위 밖이거나 0x351에서 invalid로 보고됐다 (거리 안 씀)
+ *   Stale   — timeout 동안 측정 없음 (0x351 invalid 보고는 측정으로 치지 않는다 → 죽은 센서는 여기로)
+ * deadline = 측정 시각(sample.timestampNs) + 450 ms. GUI 처리 시각이 아니므로 GUI가 밀려도 늦게 stale이 되지 않는다.
+ * 할당/락 없음 — PdcController(GUI)와 SocketCanPdcProvider RT 리더 스레드가 각자 하나씩 쓴다.
+ */
+
+#ifndef PDCSENSORMONITOR_H
+#define PDCSENSORMONITOR_H
+
+#include "PdcTypes.h"
+#include "TimerWheel.h"
+
+#include <array>
+
+enum class PdcSensorStatus : quint8 {
+    Stale = 0,
+    Invalid,
+    Fresh
+};
+
+/** 센서 하나의 누적 건강 카운터 */
+struct PdcSensorHealth {
+    quint64 readings = 0;          // 이 센서 채널이 실린 프레임
+    quint64 valid = 0;
+    quint64 outOfRange = 0;        // 값은 실렸지만 유효 범위 밖
+    quint64 reportedInvalid = 0;   // 0x351 valid 비트 0 (또는 provider가 무효 표시)
+    quint64 dropouts = 0;          // 살아 있다가 timeout으로 Stale이 된 횟수
+    float meanIntervalMs = 0.0f;   // 측정 간격 EWMA (1/16)
+    float jitterMs = 0.0f;         // |간격 - 평균| EWMA (RFC 3550 방식)
+    float maxIntervalMs = 0.0f;
+
+    double outOfRangeRate() const { return readings ? double(outOfRange) / double(readings) : 0.0; }
+};
+
+class PdcSensorMonitor
+{
+public:
+    static constexpr quint64 kTimeoutNs = 450ull * 1000 * 1000;
+    static constexpr quint64 kTickNs = 50ull * 1000 * 1000;   // wheel tick = PdcController 검사 주기
+
+    PdcSensorMonitor();
+
+    /** 상태와 카운터 모두 초기화 */
+    void reset();
+
+    /** sample 하나 반영. readingNs = 측정 시각 (timestampNs가 없거나 미래면 호출자가 now로) */
+    void update(const PdcSample &sample, quint64 readingNs);
+
+    /** nowNs까지 deadline이 지난 센서를 Stale로 — 이번에 Stale이 된 센서 mask 반환 */
+    quint8 expire(quint64 nowNs);
+
+    /** provider fault 등 — 살아 있던 센서를 dropout으로 세고 전부 Stale. 바뀐 센서 mask 반환 */
+    quint8 expireAll();
+
+    PdcSensorStatus status(int index) const { return m_status[index]; }
+    const PdcSensorHealth &health(int index) const { return m_health[index]; }
+    /** 마지막 유효 측정 (Fresh일 때만 의미 있음) */
+    float distanceCm(int index) const { return m_distanceCm[index]; }
+
+    quint8 freshMask() const { return maskOf(PdcSensorStatus::Fresh); }
+    quint8 staleMask() const { return maskOf(PdcSensorStatus::Stale); }
+    /** Stale이 아닌 센서 — 0이면 PDC 전체가 stale */
+    quint8 aliveMask() const { return static_cast<quint8>(~staleMask() & kAllSensors); }
+
+    static constexpr quint8 kAllSensors = (1u << kPdcSensorCount) - 1;
+
+private:
+    static constexpr int kWheelSlots = 16;   // horizon 800 ms > timeout — 모든 deadline이 첫 바퀴에 만료
+    static_assert(kTimeoutNs < kTickNs * kWheelSlots, "timeout must fit in one wheel revolution");
+
+    quint8 maskOf(PdcSensorStatus status) const;
+    void recordInterval(int index, quint64 readingNs);
+
+    HuProtocol::TimerWheel<kPdcSensorCount, kWheelSlots> m_wheel;
+    std::array<PdcSensorStatus, kPdcSensorCount> m_status{};
+    std::array<PdcSensorHealth, kPdcSensorCount> m_health{};
+    std::array<float, kPdcSensorCount> m_distanceCm{};
+    std::array<quint64, kPdcSensorCount> m_lastReadingNs{};   // 간격 계산용, 0 = 없음
+};
+
+#endif // PDCSENSORMONITOR_H
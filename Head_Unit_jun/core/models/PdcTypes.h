@@ -2,8 +2,10 @@
 #define PDCTYPES_H
 
 #include <QMetaType>
-#include <QString>
-#include <QVector>
+#include <QtGlobal>
+
+#include <array>
+#include <type_traits>
 
 enum class PdcWarningLevel : quint8 {
     Off = 0,
@@ -13,24 +15,65 @@ enum class PdcWarningLevel : quint8 {
     Critical
 };
 
-struct PdcSensorReading {
-    QString name;
-    float distanceCm = -1.0f;
-    bool valid = false;
-    qint64 timestampMs = 0;
+/** 후방 센서 인덱스 — PdcSample::distanceCm / validMask의 순서 */
+enum class PdcSensor : quint8 {
+    RearLeft = 0,
+    RearMidLeft,
+    RearMidRight,
+    RearRight
+};
+
+constexpr int kPdcSensorCount = 4;
+
+inline const char *pdcSensorName(PdcSensor sensor)
+{
+    switch (sensor) {
+    case PdcSensor::RearLeft:     return "rear_left";
+    case PdcSensor::RearMidLeft:  return "rear_mid_left";
+    case PdcSensor::RearMidRight: return "rear_mid_right";
+    case PdcSensor::RearRight:    return "rear_right";
+    }
+    return "unknown";
+}
+
+/**
+ * 센서 프레임 1개 = 후방 4채널 스냅샷. 고정 크기, trivially copyable —
+ * provider → PdcController → beep / overlay로 복사해도 힙 할당이 없다.
+ */
+struct PdcSample {
+    std::array<float, kPdcSensorCount> distanceCm{{-1.0f, -1.0f, -1.0f, -1.0f}};
+    quint8 validMask = 0;         // bit i = 센서 i 유효
+    quint8 outOfRangeMask = 0;    // bit i = 센서 i 값이 실렸지만 유효 범위 밖 (0x351로 invalid 보고된 값은 제외)
+    quint64 timestampNs = 0;      // CLOCK_REALTIME — SocketCAN은 커널 수신 시각, mock은 생성 시각
+
+    bool isValid(int index) const { return (validMask >> index) & 1u; }
+    void setValid(int index, bool valid)
+    {
+        validMask = static_cast<quint8>(valid ? (validMask | (1u << index))
+                                              : (validMask & ~(1u << index)));
+    }
 };
 
 struct PdcState {
-    QVector<PdcSensorReading> rearSensors;
-    float nearestDistanceCm = -1.0f;
+    PdcSample rear;
+    float nearestDistanceCm = -1.0f;     // 필터된 최근접 거리 (PdcFilter)
+    float closingSpeedCmS = 0.0f;        // 최근접 물체 접근 속도, 양수 = 다가옴
+    float timeToCollisionS = -1.0f;      // -1 = 접근 중 아님
     PdcWarningLevel warningLevel = PdcWarningLevel::Off;
     bool active = false;
-    bool stale = true;
-    QString fault;
+    bool stale = true;            // 모든 센서가 timeout — 일부만 끊기면 아래 mask로, 나머지 센서는 계속 쓴다
+    quint8 staleSensorMask = 0;   // bit i = 센서 i 측정 끊김 (PdcSensorMonitor)
+    qint64 dataAgeUs = -1;        // 센서 수신 → PdcController 처리, -1 = 모름
+    std::array<char, 64> fault{}; // NUL 종료 문자열, 비어 있으면 정상 (QString이면 복사가 trivially copyable이 아니다)
+
+    bool hasFault() const { return fault[0] != '\0'; }
 };
 
-Q_DECLARE_METATYPE(PdcSensorReading)
-Q_DECLARE_METATYPE(QVector<PdcSensorReading>)
+static_assert(std::is_trivially_copyable<PdcSample>::value, "PdcSample must stay trivially copyable");
+static_assert(std::is_trivially_copyable<PdcState>::value, "PdcState must stay trivially copyable");
+
+Q_DECLARE_METATYPE(PdcWarningLevel)
+Q_DECLARE_METATYPE(PdcSample)
 Q_DECLARE_METATYPE(PdcState)
 
 #endif // PDCTYPES_H
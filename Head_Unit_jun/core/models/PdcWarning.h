@@ -0,0 +1,45 @@
+/**
+ * @file PdcWarning.h
+ * @brief PDC 경고 단계 계산 — PdcController(GUI), SocketCanPdcProvider RT 스레드, overlay가 공유
+ *
+ * 할당/락 없는 순수 함수라 어느 스레드에서 불러도 된다.
+ */
+
+#ifndef PDCWARNING_H
+#define PDCWARNING_H
+
+#include "PdcTypes.h"
+
+namespace PdcWarning {
+
+constexpr float kMaxActiveSpeedKmh = 10.0f;   // 이보다 빠르면 경고 억제 (CAN_SIGNAL_CONTRACT §6)
+
+/** 유효 센서 중 가장 가까운 거리, 없으면 -1 */
+inline float nearestCm(const PdcSample &sample)
+{
+    float nearest = -1.0f;
+    for (int i = 0; i < kPdcSensorCount; ++i) {
+        if (sample.isValid(i) && (nearest < 0.0f || sample.distanceCm[i] < nearest))
+            nearest = sample.distanceCm[i];
+    }
+    return nearest;
+}
+
+inline PdcWarningLevel levelForDistance(float distanceCm)
+{
+    if (distanceCm < 0.0f) return PdcWarningLevel::Off;
+    if (distanceCm < 30.0f) return PdcWarningLevel::Critical;
+    if (distanceCm < 60.0f) return PdcWarningLevel::Caution;
+    if (distanceCm < 120.0f) return PdcWarningLevel::Near;
+    return PdcWarningLevel::Far;
+}
+
+/** 후진(active)이고 저속일 때만 경고 */
+inline PdcWarningLevel gatedLevel(PdcWarningLevel level, bool active, float speedKmh)
+{
+    return (active && speedKmh <= kMaxActiveSpeedKmh) ? level : PdcWarningLevel::Off;
+}
+
+} // namespace PdcWarning
+
+#endif // PDCWARNING_H
@@ -0,0 +1,153 @@
+/**
+ * @file FrameReader.cpp
+ */
+
+#include "FrameReader.h"
+
+#include <QIODevice>
+#include <cstring>
+
+namespace HuProtocol {
+
+namespace {
+int nextPowerOfTwo(int value)
+{
+    int cap = 1;
+    while (cap < value)
+        cap <<= 1;
+    return cap;
+}
+} // namespace
+
+FrameReader::FrameReader(int initialCapacity)
+{
+    grow(qMax(initialCapacity, HEADER_SIZE));
+}
+
+void FrameReader::clear()
+{
+    m_head  = 0;
+    m_tail  = 0;
+    m_error = false;
+}
+
+qint64 FrameReader::readFrom(QIODevice *device)
+{
+    if (!device || m_error)
+        return 0;
+
+    // 비어 있으면 처음으로 되감는다 — 다음 프레임이 wrap될 확률을 낮춘다
+    if (m_head == m_tail)
+        m_head = m_tail = 0;
+
+    // 진행 중인 프레임이 링 전체보다 크면 그때만 확장
+    if (bufferedBytes() >= HEADER_SIZE) {
+        char header[HEADER_SIZE];
+        copyOut(m_head, header, HEADER_SIZE);
+        const quint32 payloadLen = qFromBigEndian<quint32>(header);
+        if (payloadLen > MAX_PAYLOAD_SIZE) {
+            m_error = true;
+            return 0;
+        }
+        const int frameSize = HEADER_SIZE + static_cast<int>(payloadLen);
+        if (frameSize > capacity())
+            grow(frameSize);
+    }
+
+    qint64 total = 0;
+    while (freeSpace() > 0) {
+        const int offset     = offsetOf(m_tail);
+        const int contiguous = qMin(freeSpace(), capacity() - offset);
+        const qint64 n = device->read(m_ring.data() + offset, contiguous);
+        if (n <= 0)
+            break;
+        m_tail += static_cast<quint64>(n);
+        total  += n;
+        if (n < contiguous)
+            break;
+    }
+    return total;
+}
+
+bool FrameReader::next(FrameView &out)
+{
+    if (m_error || bufferedBytes() < HEADER_SIZE)
+        return false;
+
+    char header[HEADER_SIZE];
+    copyOut(m_head, header, HEADER_SIZE);
+    const quint32 payloadLen = qFromBigEndian<quint32>(header);
+    const quint32 typeRaw    = qFromBigEndian<quint32>(header + sizeof(quint32));
+
+    if (payloadLen > MAX_PAYLOAD_SIZE) {
+        m_error = true;
+        return false;
+    }
+
+    const bool stamped = (typeRaw & STAMPED_FLAG) != 0;
+    if (stamped && payloadLen < static_cast<quint32>(STAMP_SIZE)) {
+        m_error = true;
+        return false;
+    }
+
+    int       len       = static_cast<int>(payloadLen);
+    const int frameSize = HEADER_SIZE + len;
+    if (bufferedBytes() < frameSize)
+        return false;
+
+    quint64 payloadPos = m_head + HEADER_SIZE;
+    out.stamped = stamped;
+    if (stamped) {
+        char ext[STAMP_SIZE];
+        copyOut(payloadPos, ext, STAMP_SIZE);
+        out.stamp.sentNs = qFromBigEndian<quint64>(ext);
+        out.stamp.seq    = qFromBigEndian<quint32>(ext + sizeof(quint64));
+        payloadPos += STAMP_SIZE;
+        len        -= STAMP_SIZE;
+    } else {
+        out.stamp = FrameStamp{};
+    }
+
+    const int offset = offsetOf(payloadPos);
+    if (offset + len <= capacity()) {
+        out.data = m_ring.constData() + offset;
+    } else {
+        // 링 끝에서 감긴 payload만 scratch로 선형화 (scratch는 링과 같은 크기로 미리 확보됨)
+        copyOut(payloadPos, m_scratch.data(), len);
+        out.data = m_scratch.constData();
+    }
+    out.type = static_cast<MsgType>(typeRaw & ~STAMPED_FLAG);
+    out.size = len;
+
+    m_head += static_cast<quint64>(frameSize);
+    return true;
+}
+
+void FrameReader::copyOut(quint64 pos, char *dst, int len) const
+{
+    const int offset = offsetOf(pos);
+    const int first  = qMin(len, capacity() - offset);
+    std::memcpy(dst, m_ring.constData() + offset, static_cast<size_t>(first));
+    if (len > first)
+        std::memcpy(dst + first, m_ring.constData(), static_cast<size_t>(len - first));
+}
+
+void FrameReader::grow(int minCapacity)
+{
+    const int newCapacity = nextPowerOfTwo(minCapacity);
+    if (newCapacity <= capacity())
+        return;
+
+    QByteArray ring(newCapacity, Qt::Uninitialized);
+    const int used = bufferedBytes();
+    if (used > 0)
+        copyOut(m_head, ring.data(), used);
+
+    m_ring = ring;
+    m_mask = static_cast<quint64>(newCapacity - 1);
+    m_head = 0;
+    m_tail = static_cast<quint64>(used);
+    m_scratch.resize(newCapacity);
+}
+
+} // namespace HuProtocol
@@ -0,0 +1,68 @@
+/**
+ * @file FrameReader.h
+ * @brief 링버퍼 기반 제로카피 프레임 디코더 (ModuleBridge / ShellClient 공용)
+ *
+ * 소켓에서 링버퍼로 직접 read()하고, 완성된 프레임은 복사 없이 FrameView로 넘긴다.
+ * 소비한 프레임은 read 인덱스만 전진시키므로 QByteArray::remove() 같은 memmove가 없다.
+ * 프레임이 링 끝에서 감겨(wrap) 있는 경우에만 미리 확보한 scratch 버퍼로 선형화한다.
+ *
+ * 사용법:
+ *   while (reader.readFrom(socket) > 0) {
+ *       HuProtocol::FrameView f;
+ *       while (reader.next(f)) dispatchFrame(f);
+ *   }
+ */
+
+#ifndef FRAMEREADER_H
+#define FRAMEREADER_H
+
+#include "ShellProtocol.h"
+
+#include <QByteArray>
+
+class QIODevice;
+
+namespace HuProtocol {
+
+class FrameReader
+{
+public:
+    explicit FrameReader(int initialCapacity = 4096);
+
+    /**
+     * device에서 읽을 수 있는 만큼 링버퍼의 빈 공간으로 직접 읽는다.
+     * 진행 중인 프레임이 버퍼보다 크면 그때만 용량을 늘린다.
+     * @return 이번 호출에서 읽은 바이트 수 (0이면 더 읽을 데이터 없음)
+     */
+    qint64 readFrom(QIODevice *device);
+
+    /**
+     * 완성된 프레임 하나를 꺼낸다. out.data는 다음 next()/readFrom() 전까지만 유효.
+     * @return 완성 프레임이 없으면 false
+     */
+    bool next(FrameView &out);
+
+    /** length 필드가 MAX_PAYLOAD_SIZE를 넘는 등 스트림이 손상되었는가 */
+    bool hasError() const { return m_error; }
+
+    int bufferedBytes() const { return static_cast<int>(m_tail - m_head); }
+    int capacity() const { return m_ring.size(); }
+    void clear();
+
+private:
+    int  freeSpace() const { return capacity() - bufferedBytes(); }
+    int  offsetOf(quint64 pos) const { return static_cast<int>(pos & m_mask); }
+    void copyOut(quint64 pos, char *dst, int len) const;
+    void grow(int minCapacity);
+
+    QByteArray m_ring;        // 용량은 항상 2의 거듭제곱
+    quint64    m_mask = 0;
+    quint64    m_head = 0;    // 다음에 파싱할 위치 (단조 증가)
+    quint64    m_tail = 0;    // 다음에 쓸 위치 (단조 증가)
+    QByteArray m_scratch;     // wrap된 payload 선형화용, 링과 같은 크기로 재사용
+    bool       m_error = false;
+};
+
+} // namespace HuProtocol
+
+#endif // FRAMEREADER_H
@@ -0,0 +1,106 @@
+/**
+ * @file LatencyHistogram.cpp
+ */
+
+#include "LatencyHistogram.h"
+
+#include <QDebug>
+
+namespace HuProtocol {
+
+// ── LatencyHistogram ──────────────────────────────────────────────────
+
+void LatencyHistogram::add(quint64 ns)
+{
+    const quint64 us = ns / 1000;
+    int bucket = 0;
+    if (us >= 2) {
+        bucket = 63 - __builtin_clzll(us);
+        if (bucket >= kBuckets) bucket = kBuckets - 1;
+    }
+    ++m_buckets[bucket];
+
+    if (m_count == 0 || ns < m_minNs) m_minNs = ns;
+    if (ns > m_maxNs) m_maxNs = ns;
+    m_sumNs += static_cast<double>(ns);
+    ++m_count;
+}
+
+void LatencyHistogram::clear()
+{
+    m_buckets.fill(0);
+    m_count = 0;
+    m_minNs = 0;
+    m_maxNs = 0;
+    m_sumNs = 0.0;
+}
+
+quint64 LatencyHistogram::percentileUs(double p) const
+{
+    if (m_count == 0) return 0;
+    const quint64 target = static_cast<quint64>(p * m_count + 0.5);
+    quint64 seen = 0;
+    for (int i = 0; i < kBuckets; ++i) {
+        seen += m_buckets[i];
+        if (seen >= target && m_buckets[i])
+            return qMin<quint64>(2ull << i, m_maxNs / 1000 + 1);
+    }
+    return m_maxNs / 1000 + 1;
+}
+
+// ── FrameLatencyStats ─────────────────────────────────────────────────
+
+void FrameLatencyStats::record(const FrameView &frame, quint64 nowNs)
+{
+    if (!frame.stamped) return;
+
+    PerType &t = m_perType[static_cast<quint32>(frame.type)];
+    // 같은 CLOCK_MONOTONIC을 공유하므로 음수는 나올 수 없지만 방어적으로 0으로 자른다
+    t.latency.add(nowNs > frame.stamp.sentNs ? nowNs - frame.stamp.sentNs : 0);
+    if (t.lastArrivalNs)
+        t.interval.add(nowNs - t.lastArrivalNs);
+    t.lastArrivalNs = nowNs;
+
+    if (m_haveSeq) {
+        const qint32 delta = static_cast<qint32>(frame.stamp.seq - m_lastSeq);
+        if (delta > 1)
+            m_seqGaps += static_cast<quint64>(delta - 1);
+        else if (delta <= 0)
+            ++m_seqReorders;
+    }
+    if (!m_haveSeq || static_cast<qint32>(frame.stamp.seq - m_lastSeq) > 0)
+        m_lastSeq = frame.stamp.seq;
+    m_haveSeq = true;
+    ++m_frames;
+}
+
+void FrameLatencyStats::clear()
+{
+    m_perType.clear();
+    m_frames      = 0;
+    m_seqGaps     = 0;
+    m_seqReorders = 0;
+    m_lastSeq     = 0;
+    m_haveSeq     = false;
+}
+
+void FrameLatencyStats::log(const QString &tag) const
+{
+    if (m_frames == 0) return;
+    qDebug().noquote() << tag << "stamped frames:" << m_frames
+                       << "seq gaps:" << m_seqGaps << "reordered:" << m_seqReorders;
+    for (auto it = m_perType.constBegin(); it != m_perType.constEnd(); ++it) {
+        const LatencyHistogram &l = it->latency;
+        const LatencyHistogram &g = it->interval;
+        qDebug().noquote() << tag
+                           << QStringLiteral("type 0x%1").arg(it.key(), 4, 16, QLatin1Char('0'))
+                           << "n=" << l.count()
+                           << "latency p50" << l.percentileUs(0.50) << "us"
+                           << "p99" << l.percentileUs(0.99) << "us"
+                           << "max" << l.maxNs() / 1000 << "us"
+                           << "| interval p50" << g.percentileUs(0.50) << "us"
+                           << "max" << g.maxNs() / 1000 << "us";
+    }
+}
+
+} // namespace HuProtocol
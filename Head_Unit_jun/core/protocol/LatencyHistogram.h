@@ -0,0 +1,83 @@
+/**
+ * @file LatencyHistogram.h
+ * @brief 고정 버킷 지연 히스토그램 + MsgType별 프레임 지연/간격 통계
+ *
+ * LatencyHistogram  : log2 버킷(1 µs … 약 36분), 할당 없이 add() — 수신 경로에서 호출해도 된다
+ * FrameLatencyStats : 확장 헤더(FrameStamp)가 붙은 프레임마다
+ *                       - 송신 → 수신 지연 (MsgType별)
+ *                       - 같은 MsgType 프레임 사이 도착 간격 (MsgType별)
+ *                       - 순번 누락/역전 (연결 단위)
+ *                     을 누적한다. ModuleBridge / ShellClient가 하나씩 가진다.
+ */
+
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include "ShellProtocol.h"
+
+#include <QHash>
+#include <QString>
+
+#include <array>
+
+namespace HuProtocol {
+
+class LatencyHistogram
+{
+public:
+    static constexpr int kBuckets = 32;   // 버킷 i: [2^i, 2^(i+1)) µs, 0번은 < 2 µs
+
+    void add(quint64 ns);
+    void clear();
+
+    quint64 count() const { return m_count; }
+    quint64 minNs() const { return m_count ? m_minNs : 0; }
+    quint64 maxNs() const { return m_maxNs; }
+    double  meanUs() const { return m_count ? (m_sumNs / 1000.0) / m_count : 0.0; }
+
+    /** p(0..1) 백분위가 속한 버킷의 상한 (µs). 실제 값은 이 이하 */
+    quint64 percentileUs(double p) const;
+
+    const std::array<quint64, kBuckets> &buckets() const { return m_buckets; }
+
+private:
+    std::array<quint64, kBuckets> m_buckets{};
+    quint64 m_count = 0;
+    quint64 m_minNs = 0;
+    quint64 m_maxNs = 0;
+    double  m_sumNs = 0.0;
+};
+
+class FrameLatencyStats
+{
+public:
+    struct PerType {
+        LatencyHistogram latency;    // 송신 시각 → 수신
+        LatencyHistogram interval;   // 같은 타입 직전 프레임과의 도착 간격
+        quint64          lastArrivalNs = 0;
+    };
+
+    /** 수신한 프레임 하나를 기록. 확장 헤더가 없으면 무시 */
+    void record(const FrameView &frame, quint64 nowNs = monotonicNowNs());
+    void clear();
+
+    const QHash<quint32, PerType> &perType() const { return m_perType; }
+    quint64 stampedFrames() const { return m_frames; }
+    quint64 seqGaps() const { return m_seqGaps; }        // 건너뛴 순번 수 (유실)
+    quint64 seqReorders() const { return m_seqReorders; }
+
+    /** MsgType별 p50/p99/max 한 줄씩 qDebug 출력 */
+    void log(const QString &tag) const;
+
+private:
+    QHash<quint32, PerType> m_perType;
+    quint64 m_frames      = 0;
+    quint64 m_seqGaps     = 0;
+    quint64 m_seqReorders = 0;
+    quint32 m_lastSeq     = 0;
+    bool    m_haveSeq     = false;
+};
+
+} // namespace HuProtocol
+
+#endif // LATENCYHISTOGRAM_H
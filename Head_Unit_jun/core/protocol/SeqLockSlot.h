@@ -0,0 +1,74 @@
+/**
+ * @file SeqLockSlot.h
+ * @brief 스레드 간 최신 값 1개를 넘기는 lock-free 슬롯 (single writer seqlock)
+ *
+ * VehicleStateBlock과 같은 seqlock이지만 프로세스 안, 임의의 trivially copyable T용이다.
+ *   writer (RT 스레드 하나) : store(value) — 대기/시스템콜/할당 없음
+ *   reader (아무 스레드)    : load()       — 기록 중이면 다시 읽는다
+ * 값은 8바이트 atomic 워드 배열에 relaxed로 복사한다 (data race 없이 memcpy와 같은 비용).
+ * writer는 reader를 기다리지 않는다 — 최신 값만 의미 있는 센서 샘플 같은 데이터용.
+ */
+
+#ifndef SEQLOCKSLOT_H
+#define SEQLOCKSLOT_H
+
+#include <QtGlobal>
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+namespace HuProtocol {
+
+template <typename T>
+class SeqLockSlot
+{
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLockSlot needs a trivially copyable type");
+    static constexpr std::size_t kWords = (sizeof(T) + sizeof(quint64) - 1) / sizeof(quint64);
+
+public:
+    void store(const T &value)
+    {
+        quint64 words[kWords] = {};
+        std::memcpy(words, &value, sizeof(T));
+
+        const quint32 s = m_seq.load(std::memory_order_relaxed);
+        m_seq.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < kWords; ++i)
+            m_words[i].store(words[i], std::memory_order_relaxed);
+        m_seq.store(s + 2, std::memory_order_release);
+    }
+
+    T load() const
+    {
+        quint64 words[kWords];
+        for (;;) {
+            const quint32 s1 = m_seq.load(std::memory_order_acquire);
+            if (s1 & 1u) {
+                std::this_thread::yield();
+                continue;
+            }
+            for (std::size_t i = 0; i < kWords; ++i)
+                words[i] = m_words[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_seq.load(std::memory_order_relaxed) == s1)
+                break;
+        }
+        T value;
+        std::memcpy(&value, words, sizeof(T));
+        return value;
+    }
+
+    /** store() 횟수 × 2 — 새 값이 들어왔는지 비교용 */
+    quint32 sequence() const { return m_seq.load(std::memory_order_acquire); }
+
+private:
+    std::atomic<quint32> m_seq{0};
+    std::atomic<quint64> m_words[kWords] = {};
+};
+
+} // namespace HuProtocol
+
+#endif // SEQLOCKSLOT_H
@@ -0,0 +1,363 @@
+/**
+ * @file SeqPacketSocket.cpp
+ */
+
+#include "SeqPacketSocket.h"
+
+#include <QDebug>
+#include <QSocketNotifier>
+
+#include <cerrno>
+#include <cstring>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace HuProtocol {
+
+namespace {
+bool fillAddress(const QString &path, sockaddr_un &addr)
+{
+    const QByteArray native = path.toLocal8Bit();
+    if (native.size() >= static_cast<int>(sizeof(addr.sun_path)))
+        return false;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, native.constData(), static_cast<size_t>(native.size()));
+    return true;
+}
+} // namespace
+
+// ── SeqPacketSocket ───────────────────────────────────────────────────
+
+SeqPacketSocket::SeqPacketSocket(QObject *parent)
+    : QIODevice(parent)
+{
+    m_out.reserve(4096);   // capacityReserved — 큐를 비워도 버퍼를 유지한다
+}
+
+SeqPacketSocket::~SeqPacketSocket()
+{
+    teardown(false);
+}
+
+bool SeqPacketSocket::connectToServer(const QString &path)
+{
+    teardown(false);
+    sockaddr_un addr;
+    if (!fillAddress(path, addr))
+        return false;
+
+    const int fd = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return false;
+    if (::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        return false;
+    }
+    attach(fd);
+    return true;
+}
+
+bool SeqPacketSocket::setSocketDescriptor(int fd)
+{
+    teardown(false);
+    if (fd < 0)
+        return false;
+    attach(fd);
+    return true;
+}
+
+void SeqPacketSocket::attach(int fd)
+{
+    m_fd      = fd;
+    m_error   = false;
+    m_rxCount = 0;
+    m_rxIndex = 0;
+    m_out.resize(0);
+    m_outHead = 0;
+    if (m_rx.isEmpty())
+        m_rx.resize(BATCH_SIZE * MAX_PACKET_SIZE);
+
+    m_readNotifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+    connect(m_readNotifier, &QSocketNotifier::activated, this, &SeqPacketSocket::onReadable);
+    m_writeNotifier = new QSocketNotifier(fd, QSocketNotifier::Write, this);
+    m_writeNotifier->setEnabled(false);
+    connect(m_writeNotifier, &QSocketNotifier::activated, this, &SeqPacketSocket::onWritable);
+
+    QIODevice::open(QIODevice::ReadWrite | QIODevice::Unbuffered);
+}
+
+void SeqPacketSocket::teardown(bool emitSignal)
+{
+    if (m_fd < 0)
+        return;
+    // activated 처리 중일 수 있으므로 notifier는 지연 삭제
+    m_readNotifier->setEnabled(false);
+    m_writeNotifier->setEnabled(false);
+    m_readNotifier->deleteLater();
+    m_writeNotifier->deleteLater();
+    m_readNotifier  = nullptr;
+    m_writeNotifier = nullptr;
+    ::close(m_fd);
+    m_fd = -1;
+    m_rxCount = m_rxIndex = 0;
+    m_out.resize(0);
+    m_outHead = 0;
+    QIODevice::close();
+    if (emitSignal)
+        emit disconnected();
+}
+
+void SeqPacketSocket::abort()
+{
+    teardown(true);
+}
+
+void SeqPacketSocket::close()
+{
+    flush();
+    teardown(true);
+}
+
+// ── 수신 ──────────────────────────────────────────────────────────────
+
+void SeqPacketSocket::onReadable()
+{
+    emit readyRead();
+}
+
+int SeqPacketSocket::readBatch()
+{
+    m_rxCount = m_rxIndex = 0;
+    if (m_fd < 0)
+        return 0;
+    if (m_error)
+        return -1;   // 이미 잘린/손상된 데이터그램을 봤다 — 호출자가 연결을 끊어야 한다
+
+    mmsghdr msgs[BATCH_SIZE];
+    iovec   iov[BATCH_SIZE];
+    std::memset(msgs, 0, sizeof(msgs));
+    for (int i = 0; i < BATCH_SIZE; ++i) {
+        iov[i].iov_base = m_rx.data() + i * MAX_PACKET_SIZE;
+        iov[i].iov_len  = MAX_PACKET_SIZE;
+        msgs[i].msg_hdr.msg_iov    = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    const int n = ::recvmmsg(m_fd, msgs, BATCH_SIZE, MSG_DONTWAIT, nullptr);
+    if (n < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK)
+            teardown(true);
+        return 0;
+    }
+
+    bool eof = (n == 0);
+    for (int i = 0; i < n; ++i) {
+        if (msgs[i].msg_len == 0) {   // 빈 데이터그램은 보내지 않는다 → 상대가 닫음
+            eof = true;
+            break;
+        }
+        if (msgs[i].msg_hdr.msg_flags & MSG_TRUNC) {
+            qWarning() << "[SeqPacketSocket] datagram larger than" << MAX_PACKET_SIZE << "bytes";
+            m_error = true;
+            break;
+        }
+        m_rxLen[m_rxCount++] = static_cast<int>(msgs[i].msg_len);
+    }
+
+    if (m_error && m_rxCount == 0)
+        return -1;
+    if (eof && m_rxCount == 0) {
+        teardown(true);
+        return 0;
+    }
+    // EOF 앞의 프레임은 먼저 넘기고, 다음 readBatch()에서 연결 종료를 알린다
+    return m_rxCount;
+}
+
+bool SeqPacketSocket::next(FrameView &out)
+{
+    // 잘린 데이터그램(m_error) 앞에 받은 프레임은 끝까지 넘긴다 — readBatch()가 다음에 -1
+    if (m_rxIndex >= m_rxCount)
+        return false;
+    const int i = m_rxIndex++;
+    if (!parseFrame(m_rx.constData() + i * MAX_PACKET_SIZE, m_rxLen[i], out)) {
+        m_error   = true;
+        m_rxCount = m_rxIndex;   // 손상된 프레임 뒤는 버린다
+        return false;
+    }
+    return true;
+}
+
+qint64 SeqPacketSocket::readData(char *, qint64)
+{
+    return -1;   // 프레임 단위 API(readBatch/next)만 지원
+}
+
+// ── 송신 ──────────────────────────────────────────────────────────────
+
+qint64 SeqPacketSocket::writeData(const char *data, qint64 size)
+{
+    if (m_fd < 0)
+        return -1;
+    // 데이터그램 하나에 담을 수 없는 프레임은 쓰기 자체를 거부한다 — 큐에 넣은 뒤 버리면
+    // 호출자는 성공으로 안다. write()는 항상 완성된 프레임 단위로 들어온다
+    for (qint64 pos = 0; pos + HEADER_SIZE <= size; ) {
+        const qint64 frameSize = HEADER_SIZE + static_cast<qint64>(qFromBigEndian<quint32>(data + pos));
+        if (frameSize > MAX_PACKET_SIZE) {
+            setErrorString(QStringLiteral("frame of %1 bytes exceeds the %2 byte seqpacket limit")
+                               .arg(frameSize).arg(MAX_PACKET_SIZE));
+            qWarning() << "[SeqPacketSocket] refusing" << frameSize
+                       << "byte frame (use SharedBlob for large payloads)";
+            return -1;
+        }
+        pos += frameSize;
+    }
+    m_out.append(data, static_cast<int>(size));
+    if (!m_flushQueued) {
+        // 같은 이벤트 루프 패스의 write는 sendmmsg 한 번으로 묶는다
+        m_flushQueued = true;
+        QMetaObject::invokeMethod(this, "flushQueued", Qt::QueuedConnection);
+    }
+    return size;
+}
+
+void SeqPacketSocket::flushQueued()
+{
+    m_flushQueued = false;
+    flush();
+}
+
+void SeqPacketSocket::onWritable()
+{
+    m_writeNotifier->setEnabled(false);
+    flush();
+}
+
+bool SeqPacketSocket::flush()
+{
+    while (m_fd >= 0 && bytesToWrite() >= HEADER_SIZE) {
+        mmsghdr msgs[BATCH_SIZE];
+        iovec   iov[BATCH_SIZE];
+        std::memset(msgs, 0, sizeof(msgs));
+
+        // 큐에서 완성된 프레임을 최대 BATCH_SIZE개 고른다
+        int count = 0;
+        int pos   = m_outHead;
+        while (count < BATCH_SIZE && pos + HEADER_SIZE <= m_out.size()) {
+            const quint32 payloadLen = qFromBigEndian<quint32>(m_out.constData() + pos);
+            const qint64  frameSize  = HEADER_SIZE + static_cast<qint64>(payloadLen);
+            if (pos + frameSize > m_out.size())
+                break;   // 아직 쓰는 중인 프레임 (크기는 writeData()가 이미 확인)
+            iov[count].iov_base = m_out.data() + pos;
+            iov[count].iov_len  = static_cast<size_t>(frameSize);
+            msgs[count].msg_hdr.msg_iov    = &iov[count];
+            msgs[count].msg_hdr.msg_iovlen = 1;
+            ++count;
+            pos += static_cast<int>(frameSize);
+        }
+        if (count == 0)
+            break;
+
+        const int sent = ::sendmmsg(m_fd, msgs, static_cast<unsigned>(count), MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                m_writeNotifier->setEnabled(true);
+                return false;
+            }
+            teardown(true);
+            return false;
+        }
+
+        qint64 bytes = 0;
+        for (int i = 0; i < sent; ++i)
+            bytes += static_cast<qint64>(iov[i].iov_len);
+        m_outHead += static_cast<int>(bytes);
+        if (m_outHead == m_out.size()) {
+            m_out.resize(0);
+            m_outHead = 0;
+        }
+        emit bytesWritten(bytes);
+
+        if (sent < count) {   // 커널 버퍼가 찼다 — 쓰기 가능해지면 이어서
+            if (m_writeNotifier) m_writeNotifier->setEnabled(true);
+            return false;
+        }
+    }
+    return true;
+}
+
+// ── SeqPacketServer ───────────────────────────────────────────────────
+
+SeqPacketServer::SeqPacketServer(QObject *parent)
+    : QObject(parent)
+{
+}
+
+SeqPacketServer::~SeqPacketServer()
+{
+    close();
+}
+
+bool SeqPacketServer::listen(const QString &path)
+{
+    close();
+    sockaddr_un addr;
+    if (!fillAddress(path, addr))
+        return false;
+
+    m_fd = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (m_fd < 0)
+        return false;
+
+    ::unlink(addr.sun_path);   // 이전 소켓 파일 정리
+    if (::bind(m_fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0
+        || ::listen(m_fd, 4) != 0) {
+        qWarning() << "[SeqPacketServer] cannot listen on" << path << ":" << std::strerror(errno);
+        ::close(m_fd);
+        m_fd = -1;
+        return false;
+    }
+    m_path = path;
+
+    m_notifier = new QSocketNotifier(m_fd, QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, [this] {
+        const int fd = ::accept4(m_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;
+        if (m_pendingFd >= 0)
+            ::close(m_pendingFd);   // 가져가지 않은 이전 연결은 최신 연결로 교체
+        m_pendingFd = fd;
+        emit newConnection();
+    });
+    return true;
+}
+
+void SeqPacketServer::close()
+{
+    if (m_pendingFd >= 0) {
+        ::close(m_pendingFd);
+        m_pendingFd = -1;
+    }
+    if (m_fd < 0)
+        return;
+    delete m_notifier;
+    m_notifier = nullptr;
+    ::close(m_fd);
+    m_fd = -1;
+    ::unlink(m_path.toLocal8Bit().constData());
+    m_path.clear();
+}
+
+SeqPacketSocket *SeqPacketServer::nextPendingConnection()
+{
+    if (m_pendingFd < 0)
+        return nullptr;
+    auto *socket = new SeqPacketSocket(this);
+    socket->setSocketDescriptor(m_pendingFd);
+    m_pendingFd = -1;
+    return socket;
+}
+
+} // namespace HuProtocol
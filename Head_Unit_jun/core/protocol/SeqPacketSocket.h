@@ -0,0 +1,145 @@
+/**
+ * @file SeqPacketSocket.h
+ * @brief SOCK_SEQPACKET Shell ↔ Module 전송 (스트림 소켓의 대안)
+ *
+ * 스트림 소켓은 커널이 메시지 경계를 지우므로 FrameReader가 length 필드로 다시 자른다.
+ * SOCK_SEQPACKET은 커널이 경계를 유지한다 — 데이터그램 1개 = 프레임 1개 (와이어 포맷 동일).
+ *   - 송신 : write()는 프레임을 큐에 쌓기만 하고, 이벤트 루프 1회마다 sendmmsg 한 번으로 보낸다
+ *   - 수신 : readBatch()가 recvmmsg 한 번으로 최대 BATCH_SIZE개 프레임을 고정 버퍼에 받고
+ *            next()가 재조립 없이 FrameView로 넘긴다
+ *
+ * QIODevice를 상속하므로 쓰기/역압 경로(write, bytesToWrite, bytesWritten)는
+ * QLocalSocket과 같은 코드로 다룰 수 있다. 읽기는 프레임 단위 API(readBatch/next)만 지원한다.
+ *
+ * 프레임 하나는 MAX_PACKET_SIZE를 넘을 수 없다 — 넘는 프레임이 든 write()는 -1로 거부된다
+ * (큐에 들어가지 않음). 큰 데이터는 SharedBlob으로 보낸다.
+ *
+ * 선택: shell은 모듈별로 <socketPath>.pkt를 추가로 listen하고(HU_IPC_SEQPACKET),
+ * 모듈(ShellClient)은 .pkt 연결을 먼저 시도한 뒤 실패하면 스트림 소켓으로 돌아간다.
+ */
+
+#ifndef SEQPACKETSOCKET_H
+#define SEQPACKETSOCKET_H
+
+#include "ShellProtocol.h"
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QObject>
+#include <QString>
+
+class QSocketNotifier;
+
+namespace HuProtocol {
+
+enum class Transport {
+    Stream,      // QLocalSocket + FrameReader (기본, 모든 peer 지원)
+    SeqPacket,   // SeqPacketSocket (스트림은 fallback으로 계속 listen)
+};
+
+/** 데이터그램 하나(= 프레임 하나)의 최대 크기 */
+static constexpr int MAX_PACKET_SIZE = 64 * 1024;
+
+class SeqPacketSocket : public QIODevice
+{
+    Q_OBJECT
+
+public:
+    static constexpr int BATCH_SIZE = 16;   // recvmmsg / sendmmsg 한 번에 처리하는 프레임 수
+
+    explicit SeqPacketSocket(QObject *parent = nullptr);
+    ~SeqPacketSocket() override;
+
+    static QString pathFor(const QString &socketPath) { return socketPath + QStringLiteral(".pkt"); }
+
+    /** 동기 연결 (로컬 소켓은 서버 backlog에 들어가는 즉시 완료) */
+    bool connectToServer(const QString &path);
+    /** SeqPacketServer가 accept한 fd를 넘겨받는다 */
+    bool setSocketDescriptor(int fd);
+
+    bool isConnected() const { return m_fd >= 0; }
+    /** 큐를 버리고 즉시 닫는다 (disconnected emit) */
+    void abort();
+
+    // ── 수신 ─────────────────────────────────────────
+    /**
+     * recvmmsg 한 번. @return 이번에 받은 프레임 수 (0이면 더 없음),
+     * -1이면 잘린/손상된 데이터그램 — 호출자는 연결을 끊어야 한다 (hasError()도 true).
+     * 잘린 데이터그램 앞의 프레임은 먼저 넘기고, 그 다음 호출이 -1을 돌려준다.
+     */
+    int readBatch();
+    /** 현재 배치에서 프레임 하나. out.data는 다음 readBatch() 전까지 유효 */
+    bool next(FrameView &out);
+    /** 잘린/손상된 데이터그램을 받았는가 */
+    bool hasError() const { return m_error; }
+
+    // ── 송신 ─────────────────────────────────────────
+    qint64 bytesToWrite() const override { return m_out.size() - m_outHead; }
+    bool   isSequential() const override { return true; }
+    /** 큐에 쌓인 프레임을 sendmmsg로 보낸다 (EAGAIN이면 쓰기 가능해질 때 재시도) */
+    bool   flush();
+
+    void close() override;
+
+signals:
+    void disconnected();
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 size) override;
+
+private slots:
+    void onReadable();
+    void onWritable();
+    void flushQueued();
+
+private:
+    void attach(int fd);
+    void teardown(bool emitSignal);
+
+    int              m_fd = -1;
+    QSocketNotifier *m_readNotifier  = nullptr;
+    QSocketNotifier *m_writeNotifier = nullptr;
+
+    // 수신 배치 — BATCH_SIZE × MAX_PACKET_SIZE 고정 버퍼 (실제로 쓴 페이지만 상주)
+    QByteArray m_rx;
+    int        m_rxLen[BATCH_SIZE] = {};
+    int        m_rxCount = 0;
+    int        m_rxIndex = 0;
+    bool       m_error   = false;
+
+    // 송신 큐 — 인코딩된 프레임을 연속 저장, 경계는 length 필드로 구한다
+    QByteArray m_out;
+    int        m_outHead = 0;
+    bool       m_flushQueued = false;
+};
+
+/** <socketPath>.pkt 서버 — QLocalServer와 같은 사용 패턴 */
+class SeqPacketServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SeqPacketServer(QObject *parent = nullptr);
+    ~SeqPacketServer() override;
+
+    bool listen(const QString &path);
+    bool isListening() const { return m_fd >= 0; }
+    void close();
+
+    /** 대기 중인 연결 하나 (부모는 이 서버, 없으면 nullptr) */
+    SeqPacketSocket *nextPendingConnection();
+
+signals:
+    void newConnection();
+
+private:
+    int              m_fd = -1;
+    QSocketNotifier *m_notifier = nullptr;
+    QString          m_path;
+    int              m_pendingFd = -1;
+};
+
+} // namespace HuProtocol
+
+#endif // SEQPACKETSOCKET_H
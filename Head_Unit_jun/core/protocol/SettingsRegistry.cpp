@@ -0,0 +1,201 @@
+/**
+ * @file SettingsRegistry.cpp
+ */
+
+#include "SettingsRegistry.h"
+
+#include <QtEndian>
+#include <cstring>
+
+namespace HuProtocol {
+
+namespace {
+quint16 wireKeyOf(SettingKey key, SettingType type)
+{
+    return static_cast<quint16>((static_cast<quint16>(type) << 12) |
+                                (static_cast<quint16>(key) & SETTING_ID_MASK));
+}
+
+SettingKey keyOf(quint16 wireKey)  { return static_cast<SettingKey>(wireKey & SETTING_ID_MASK); }
+SettingType typeOf(quint16 wireKey) { return static_cast<SettingType>(wireKey >> 12); }
+} // namespace
+
+const SettingDescriptor *findSetting(const QString &name)
+{
+    for (const SettingDescriptor &d : kSettingRegistry)
+        if (name == QLatin1String(d.name)) return &d;
+    return nullptr;
+}
+
+// ── set ───────────────────────────────────────────────────────────────
+
+bool SettingsDelta::put(SettingKey key, SettingType type, quint32 bits)
+{
+    const SettingDescriptor *desc = findSetting(key);
+    if (!desc || desc->type != type)
+        return false;
+
+    const int idx = indexOf(key);
+    if (idx >= 0) {
+        m_entries[idx].bits = bits;   // 배치 안에서는 최신값만 유지
+        return true;
+    }
+    if (m_count >= kMaxEntries)
+        return false;
+    m_entries[m_count++] = Entry{ wireKeyOf(key, type), bits };
+    return true;
+}
+
+bool SettingsDelta::set(SettingKey key, bool value)   { return put(key, SettingType::Bool, value ? 1u : 0u); }
+bool SettingsDelta::set(SettingKey key, quint8 value) { return put(key, SettingType::U8, value); }
+bool SettingsDelta::set(SettingKey key, qint32 value) { return put(key, SettingType::I32, static_cast<quint32>(value)); }
+
+bool SettingsDelta::set(SettingKey key, float value)
+{
+    quint32 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return put(key, SettingType::F32, bits);
+}
+
+void SettingsDelta::merge(const SettingsDelta &other)
+{
+    for (int i = 0; i < other.m_count; ++i) {
+        const Entry &e = other.m_entries[i];
+        put(keyOf(e.wireKey), typeOf(e.wireKey), e.bits);
+    }
+}
+
+bool SettingsDelta::setVariant(const SettingDescriptor &desc, const QVariant &value)
+{
+    switch (desc.type) {
+    case SettingType::Bool:
+        return set(desc.key, value.toBool());
+    case SettingType::U8:
+        if (desc.key == SettingKey::SpeedUnit && value.type() == QVariant::String)
+            return setSpeedUnit(value.toString() == QLatin1String("mph") ? SpeedUnit::Mph : SpeedUnit::Kmh);
+        return set(desc.key, static_cast<quint8>(value.toUInt()));
+    case SettingType::I32:
+        return set(desc.key, static_cast<qint32>(value.toInt()));
+    case SettingType::F32:
+        return set(desc.key, value.toFloat());
+    }
+    return false;
+}
+
+// ── get ───────────────────────────────────────────────────────────────
+
+int SettingsDelta::indexOf(SettingKey key) const
+{
+    for (int i = 0; i < m_count; ++i)
+        if (keyOf(m_entries[i].wireKey) == key) return i;
+    return -1;
+}
+
+bool SettingsDelta::lookup(SettingKey key, SettingType type, quint32 &bits) const
+{
+    const int idx = indexOf(key);
+    if (idx < 0 || typeOf(m_entries[idx].wireKey) != type)
+        return false;
+    bits = m_entries[idx].bits;
+    return true;
+}
+
+bool SettingsDelta::get(SettingKey key, bool &out) const
+{
+    quint32 bits;
+    if (!lookup(key, SettingType::Bool, bits)) return false;
+    out = bits != 0;
+    return true;
+}
+
+bool SettingsDelta::get(SettingKey key, quint8 &out) const
+{
+    quint32 bits;
+    if (!lookup(key, SettingType::U8, bits)) return false;
+    out = static_cast<quint8>(bits);
+    return true;
+}
+
+bool SettingsDelta::get(SettingKey key, qint32 &out) const
+{
+    quint32 bits;
+    if (!lookup(key, SettingType::I32, bits)) return false;
+    out = static_cast<qint32>(bits);
+    return true;
+}
+
+bool SettingsDelta::get(SettingKey key, float &out) const
+{
+    quint32 bits;
+    if (!lookup(key, SettingType::F32, bits)) return false;
+    std::memcpy(&out, &bits, sizeof(out));
+    return true;
+}
+
+bool SettingsDelta::speedUnit(SpeedUnit &out) const
+{
+    quint8 raw;
+    if (!get(SettingKey::SpeedUnit, raw) || raw > static_cast<quint8>(SpeedUnit::Mph))
+        return false;
+    out = static_cast<SpeedUnit>(raw);
+    return true;
+}
+
+// ── 와이어 인코딩 ─────────────────────────────────────────────────────
+
+int SettingsDelta::encodedSize() const
+{
+    int size = 1;
+    for (int i = 0; i < m_count; ++i)
+        size += 2 + settingValueSize(typeOf(m_entries[i].wireKey));
+    return size;
+}
+
+QByteArray SettingsDelta::encode() const
+{
+    QByteArray out(encodedSize(), Qt::Uninitialized);
+    char *p = out.data();
+    *p++ = static_cast<char>(m_count);
+    for (int i = 0; i < m_count; ++i) {
+        const Entry &e = m_entries[i];
+        qToBigEndian<quint16>(e.wireKey, p);
+        p += 2;
+        if (settingValueSize(typeOf(e.wireKey)) == 4) {
+            qToBigEndian<quint32>(e.bits, p);
+            p += 4;
+        } else {
+            *p++ = static_cast<char>(e.bits);
+        }
+    }
+    return out;
+}
+
+bool SettingsDelta::decode(const char *data, int size, SettingsDelta &out, int *skipped)
+{
+    out.clear();
+    if (size < 1) return false;
+
+    const int count = static_cast<quint8>(data[0]);
+    int pos = 1;
+    for (int i = 0; i < count; ++i) {
+        if (pos + 2 > size) return false;
+        const quint16 wireKey = qFromBigEndian<quint16>(data + pos);
+        pos += 2;
+
+        const SettingType type = typeOf(wireKey);
+        if (static_cast<quint8>(type) > static_cast<quint8>(SettingType::F32))
+            return false;   // 값 크기를 알 수 없으면 이후 항목도 읽을 수 없다
+        const int valueSize = settingValueSize(type);
+        if (pos + valueSize > size) return false;
+
+        const quint32 bits = (valueSize == 4) ? qFromBigEndian<quint32>(data + pos)
+                                              : static_cast<quint8>(data[pos]);
+        pos += valueSize;
+
+        if (!out.put(keyOf(wireKey), type, bits) && skipped)
+            ++*skipped;   // 레지스트리에 없는 키 (새 버전 모듈) — 무시
+    }
+    return true;
+}
+
+} // namespace HuProtocol
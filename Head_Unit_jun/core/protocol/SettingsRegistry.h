@@ -0,0 +1,146 @@
+/**
+ * @file SettingsRegistry.h
+ * @brief 설정 키 레지스트리 + SettingsDelta (MsgType::SettingsDelta 압축 인코딩)
+ *
+ * 설정 키는 문자열 대신 정수 ID(SettingKey)로 식별하고, 값 타입은 레지스트리에서 고정한다.
+ *
+ * SettingsDelta 와이어 포맷 (빅엔디안):
+ *   [uint8: entry 수] { [uint16: (SettingType << 12) | key id] [값: 1 또는 4 bytes] } ...
+ * 키 필드에 타입이 함께 들어 있으므로 수신 측이 모르는 키도 크기만큼 건너뛸 수 있다.
+ * 같은 키를 여러 번 set하면 마지막 값만 남는다 (이벤트 루프 1회 동안의 배치).
+ *
+ * 새 설정 추가 방법:
+ *   1) SettingKey 값 추가  2) kSettingRegistry에 {key, type, 이름} 추가
+ *   3) 필요하면 SettingsDelta에 타입 전용 접근자 추가
+ */
+
+#ifndef SETTINGSREGISTRY_H
+#define SETTINGSREGISTRY_H
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QMetaType>
+#include <QString>
+#include <QVariant>
+
+namespace HuProtocol {
+
+enum class SettingType : quint8 {
+    Bool = 0,   // 1 byte
+    U8   = 1,   // 1 byte (enum 값 포함)
+    I32  = 2,   // 4 bytes
+    F32  = 3,   // 4 bytes IEEE754
+};
+
+enum class SettingKey : quint16 {
+    SpeedUnit = 0x001,   // U8: SpeedUnit
+};
+
+enum class SpeedUnit : quint8 {
+    Kmh = 0,
+    Mph = 1,
+};
+
+struct SettingDescriptor {
+    SettingKey  key;
+    SettingType type;
+    const char *name;   // 구버전 QVariantMap 키 / 로그용
+};
+
+constexpr SettingDescriptor kSettingRegistry[] = {
+    { SettingKey::SpeedUnit, SettingType::U8, "speedUnit" },
+};
+
+constexpr quint16 SETTING_ID_MASK = 0x0FFF;
+
+constexpr int settingValueSize(SettingType type)
+{
+    return (type == SettingType::I32 || type == SettingType::F32) ? 4 : 1;
+}
+
+constexpr const SettingDescriptor *findSetting(SettingKey key)
+{
+    for (const SettingDescriptor &d : kSettingRegistry)
+        if (d.key == key) return &d;
+    return nullptr;
+}
+
+/** 구버전 QVariantMap 키 이름 → 레지스트리 항목 (없으면 nullptr) */
+const SettingDescriptor *findSetting(const QString &name);
+
+namespace detail {
+constexpr bool settingRegistryValid()
+{
+    constexpr int n = sizeof(kSettingRegistry) / sizeof(kSettingRegistry[0]);
+    for (int i = 0; i < n; ++i) {
+        if ((static_cast<quint16>(kSettingRegistry[i].key) & ~SETTING_ID_MASK) != 0) return false;
+        for (int j = i + 1; j < n; ++j)
+            if (kSettingRegistry[i].key == kSettingRegistry[j].key) return false;
+    }
+    return true;
+}
+static_assert(settingRegistryValid(), "SettingKey ids must be unique and fit in 12 bits");
+} // namespace detail
+
+/**
+ * 변경된 설정만 담는 고정 크기 배치 (힙 할당 없음).
+ * 레지스트리에 없는 키나 타입이 맞지 않는 값은 set 단계에서 거부한다.
+ */
+class SettingsDelta
+{
+public:
+    static constexpr int kMaxEntries = 16;
+
+    bool set(SettingKey key, bool value);
+    bool set(SettingKey key, quint8 value);
+    bool set(SettingKey key, qint32 value);
+    bool set(SettingKey key, float value);
+    bool setSpeedUnit(SpeedUnit unit) { return set(SettingKey::SpeedUnit, static_cast<quint8>(unit)); }
+
+    /** other의 항목을 덮어쓰며 합친다 (같은 키는 other가 이김) */
+    void merge(const SettingsDelta &other);
+
+    /** QVariant 값을 레지스트리 타입으로 변환해 set (구버전 QVariantMap 호환) */
+    bool setVariant(const SettingDescriptor &desc, const QVariant &value);
+
+    // ── 타입 접근자 (키가 없거나 타입이 다르면 false) ─────
+    bool contains(SettingKey key) const { return indexOf(key) >= 0; }
+    bool get(SettingKey key, bool &out) const;
+    bool get(SettingKey key, quint8 &out) const;
+    bool get(SettingKey key, qint32 &out) const;
+    bool get(SettingKey key, float &out) const;
+    bool speedUnit(SpeedUnit &out) const;
+
+    int  count() const { return m_count; }
+    bool isEmpty() const { return m_count == 0; }
+    void clear() { m_count = 0; }
+
+    /** 와이어 인코딩 크기 (bytes) */
+    int  encodedSize() const;
+    QByteArray encode() const;
+
+    /**
+     * payload → SettingsDelta. 모르는 키는 건너뛰고 skipped에 개수를 더한다.
+     * @return 길이가 맞지 않으면 false
+     */
+    static bool decode(const char *data, int size, SettingsDelta &out, int *skipped = nullptr);
+
+private:
+    struct Entry {
+        quint16 wireKey = 0;   // (type << 12) | id
+        quint32 bits    = 0;   // 값 (float은 비트 그대로)
+    };
+
+    bool put(SettingKey key, SettingType type, quint32 bits);
+    int  indexOf(SettingKey key) const;
+    bool lookup(SettingKey key, SettingType type, quint32 &bits) const;
+
+    Entry m_entries[kMaxEntries];
+    int   m_count = 0;
+};
+
+} // namespace HuProtocol
+
+Q_DECLARE_METATYPE(HuProtocol::SettingsDelta)
+
+#endif // SETTINGSREGISTRY_H
@@ -0,0 +1,343 @@
+/**
+ * @file SharedBlob.cpp
+ */
+
+#include "SharedBlob.h"
+
+#include <QDebug>
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace HuProtocol {
+
+namespace {
+constexpr int kRequiredSeals = F_SEAL_WRITE | F_SEAL_SHRINK | F_SEAL_GROW;
+
+bool fillAddress(const QString &path, sockaddr_un &addr)
+{
+    const QByteArray native = path.toLocal8Bit();
+    if (native.size() >= static_cast<int>(sizeof(addr.sun_path)))
+        return false;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, native.constData(), static_cast<size_t>(native.size()));
+    return true;
+}
+} // namespace
+
+// ── SharedBlob ────────────────────────────────────────────────────────
+
+SharedBlob::~SharedBlob()
+{
+    reset();
+}
+
+SharedBlob::SharedBlob(SharedBlob &&other) noexcept
+    : m_fd(other.m_fd), m_map(other.m_map), m_size(other.m_size), m_sealed(other.m_sealed)
+{
+    other.m_fd  = -1;
+    other.m_map = nullptr;
+    other.m_size = 0;
+}
+
+SharedBlob &SharedBlob::operator=(SharedBlob &&other) noexcept
+{
+    if (this != &other) {
+        reset();
+        m_fd     = other.m_fd;
+        m_map    = other.m_map;
+        m_size   = other.m_size;
+        m_sealed = other.m_sealed;
+        other.m_fd  = -1;
+        other.m_map = nullptr;
+        other.m_size = 0;
+    }
+    return *this;
+}
+
+SharedBlob SharedBlob::create(qint64 size, const char *name)
+{
+    SharedBlob blob;
+    if (size < 0 || size > MAX_BLOB_SIZE)
+        return blob;
+
+    blob.m_fd = ::memfd_create(name, MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (blob.m_fd < 0) {
+        qWarning() << "[SharedBlob] memfd_create failed:" << std::strerror(errno);
+        return blob;
+    }
+    blob.m_size = size;
+    if (::ftruncate(blob.m_fd, size) != 0 || !blob.map(PROT_READ | PROT_WRITE)) {
+        qWarning() << "[SharedBlob] cannot size/map" << size << "bytes:" << std::strerror(errno);
+        blob.reset();
+    }
+    return blob;
+}
+
+SharedBlob SharedBlob::fromBytes(const char *data, qint64 size)
+{
+    SharedBlob blob = create(size);
+    if (!blob.isValid())
+        return blob;
+    if (size > 0)
+        std::memcpy(blob.writableData(), data, static_cast<size_t>(size));
+    if (!blob.seal())
+        blob.reset();
+    return blob;
+}
+
+SharedBlob SharedBlob::adopt(int fd)
+{
+    SharedBlob blob;
+    blob.m_fd = fd;
+
+    const int seals = ::fcntl(fd, F_GET_SEALS);
+    if (seals < 0 || (seals & kRequiredSeals) != kRequiredSeals) {
+        qWarning() << "[SharedBlob] rejecting unsealed fd";
+        blob.reset();
+        return blob;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size < 0 || st.st_size > MAX_BLOB_SIZE) {
+        qWarning() << "[SharedBlob] rejecting fd: bad size";
+        blob.reset();
+        return blob;
+    }
+    blob.m_size   = st.st_size;
+    blob.m_sealed = true;
+    if (!blob.map(PROT_READ))
+        blob.reset();
+    return blob;
+}
+
+bool SharedBlob::seal()
+{
+    if (!isValid()) return false;
+    if (m_sealed) return true;
+
+    // F_SEAL_WRITE는 쓰기 가능한 공유 매핑이 남아 있으면 실패한다
+    if (m_map) {
+        ::munmap(m_map, static_cast<size_t>(m_size));
+        m_map = nullptr;
+    }
+    if (::fcntl(m_fd, F_ADD_SEALS, kRequiredSeals | F_SEAL_SEAL) != 0) {
+        qWarning() << "[SharedBlob] F_ADD_SEALS failed:" << std::strerror(errno);
+        return false;
+    }
+    m_sealed = true;
+    return map(PROT_READ);
+}
+
+bool SharedBlob::map(int prot)
+{
+    if (m_size == 0)
+        return true;   // 빈 blob은 매핑하지 않는다 (mmap 길이 0 불가)
+    // F_SEAL_WRITE가 걸린 memfd는 6.7 이전 커널에서 PROT_READ라도 MAP_SHARED 매핑을 EPERM으로 거부한다.
+    // 봉인 후에는 내용이 바뀌지 않으므로 MAP_PRIVATE 읽기 전용 매핑도 같은 페이지 캐시를 본다 (쓰지 않으니 COW 없음).
+    const int flags = m_sealed ? MAP_PRIVATE : MAP_SHARED;
+    void *p = ::mmap(nullptr, static_cast<size_t>(m_size), prot, flags, m_fd, 0);
+    if (p == MAP_FAILED)
+        return false;
+    m_map = static_cast<char *>(p);
+    return true;
+}
+
+void SharedBlob::reset()
+{
+    if (m_map)
+        ::munmap(m_map, static_cast<size_t>(m_size));
+    if (m_fd >= 0)
+        ::close(m_fd);
+    m_fd     = -1;
+    m_map    = nullptr;
+    m_size   = 0;
+    m_sealed = false;
+}
+
+// ── BlobChannel ───────────────────────────────────────────────────────
+
+BlobChannel::~BlobChannel()
+{
+    close();
+}
+
+bool BlobChannel::listen(const QString &path)
+{
+    close();
+    sockaddr_un addr;
+    if (!fillAddress(path, addr))
+        return false;
+
+    m_listenFd = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (m_listenFd < 0)
+        return false;
+
+    ::unlink(addr.sun_path);   // 이전 소켓 파일 정리
+    if (::bind(m_listenFd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0
+        || ::listen(m_listenFd, 4) != 0) {
+        qWarning() << "[BlobChannel] cannot listen on" << path << ":" << std::strerror(errno);
+        ::close(m_listenFd);
+        m_listenFd = -1;
+        return false;
+    }
+    m_path = path;
+    return true;
+}
+
+bool BlobChannel::connectTo(const QString &path)
+{
+    close();
+    sockaddr_un addr;
+    if (!fillAddress(path, addr))
+        return false;
+
+    m_peerFd = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (m_peerFd < 0)
+        return false;
+    // 로컬 소켓 connect는 서버 backlog에 들어가는 즉시 완료된다
+    if (::connect(m_peerFd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+        ::close(m_peerFd);
+        m_peerFd = -1;
+        return false;
+    }
+    return true;
+}
+
+bool BlobChannel::hasPeer()
+{
+    acceptPending();
+    return m_peerFd >= 0;
+}
+
+void BlobChannel::acceptPending()
+{
+    if (m_listenFd < 0) return;
+    for (;;) {
+        const int fd = ::accept4(m_listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) break;
+        dropPeer();   // 모듈 재시작 — 새 연결로 교체
+        m_peerFd = fd;
+    }
+}
+
+void BlobChannel::dropPeer()
+{
+    for (int fd : qAsConst(m_pending))
+        ::close(fd);
+    m_pending.clear();
+    if (m_peerFd >= 0) {
+        ::close(m_peerFd);
+        m_peerFd = -1;
+    }
+}
+
+void BlobChannel::close()
+{
+    dropPeer();
+    if (m_listenFd >= 0) {
+        ::close(m_listenFd);
+        m_listenFd = -1;
+        ::unlink(m_path.toLocal8Bit().constData());
+    }
+    m_path.clear();
+}
+
+quint32 BlobChannel::send(const SharedBlob &blob)
+{
+    if (!blob.isValid() || !blob.isSealed() || !hasPeer())
+        return 0;
+
+    quint32 id = ++m_nextId;
+    if (id == 0) id = ++m_nextId;   // 0은 실패 표시로 예약
+
+    iovec iov{ &id, sizeof(id) };
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+    msghdr msg{};
+    msg.msg_iov        = &iov;
+    msg.msg_iovlen     = 1;
+    msg.msg_control    = control;
+    msg.msg_controllen = sizeof(control);
+
+    cmsghdr *cmsg   = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type  = SCM_RIGHTS;
+    cmsg->cmsg_len   = CMSG_LEN(sizeof(int));
+    const int fd = blob.fd();
+    std::memcpy(CMSG_DATA(cmsg), &fd, sizeof(fd));
+
+    if (::sendmsg(m_peerFd, &msg, MSG_NOSIGNAL | MSG_DONTWAIT) != static_cast<ssize_t>(sizeof(id))) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK)
+            dropPeer();   // 상대가 닫힘 — 다음 연결에서 다시 accept
+        return 0;
+    }
+    return id;
+}
+
+void BlobChannel::drain()
+{
+    if (m_peerFd < 0) return;
+    for (;;) {
+        quint32 id = 0;
+        iovec iov{ &id, sizeof(id) };
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * 4)];
+        msghdr msg{};
+        msg.msg_iov        = &iov;
+        msg.msg_iovlen     = 1;
+        msg.msg_control    = control;
+        msg.msg_controllen = sizeof(control);
+
+        const ssize_t n = ::recvmsg(m_peerFd, &msg, MSG_DONTWAIT | MSG_CMSG_CLOEXEC);
+        if (n <= 0) {
+            if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK))
+                dropPeer();
+            return;
+        }
+
+        // fd는 정확히 하나만 받는다 — 나머지(잘렸거나 여분)는 바로 닫는다
+        int received = -1;
+        for (cmsghdr *c = CMSG_FIRSTHDR(&msg); c; c = CMSG_NXTHDR(&msg, c)) {
+            if (c->cmsg_level != SOL_SOCKET || c->cmsg_type != SCM_RIGHTS) continue;
+            const int count = static_cast<int>((c->cmsg_len - CMSG_LEN(0)) / sizeof(int));
+            for (int i = 0; i < count; ++i) {
+                int fd;
+                std::memcpy(&fd, CMSG_DATA(c) + i * sizeof(int), sizeof(fd));
+                if (received < 0) received = fd;
+                else ::close(fd);
+            }
+        }
+        if (received < 0) continue;
+        if (n != sizeof(id) || (msg.msg_flags & MSG_CTRUNC) || id == 0
+            || m_pending.size() >= MAX_PENDING || m_pending.contains(id)) {
+            qWarning() << "[BlobChannel] dropping blob fd (id" << id << "pending"
+                       << m_pending.size() << ")";
+            ::close(received);
+            continue;
+        }
+        m_pending.insert(id, received);
+    }
+}
+
+SharedBlob BlobChannel::take(quint32 blobId)
+{
+    if (!m_pending.contains(blobId)) {
+        acceptPending();
+        drain();
+    }
+    auto it = m_pending.find(blobId);
+    if (it == m_pending.end())
+        return {};
+    const int fd = it.value();
+    m_pending.erase(it);
+    return SharedBlob::adopt(fd);
+}
+
+} // namespace HuProtocol
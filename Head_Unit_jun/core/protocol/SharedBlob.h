@@ -0,0 +1,135 @@
+/**
+ * @file SharedBlob.h
+ * @brief 대용량 payload용 봉인된 memfd + SCM_RIGHTS 사이드 채널
+ *
+ * 커버 아트, 플레이리스트, 스크린샷처럼 큰 데이터는 스트림 소켓으로 복사하지 않는다.
+ *   1) 송신 측이 SharedBlob::create()로 memfd를 만들고 writableData()에 직접 채운 뒤 seal()
+ *      (F_SEAL_WRITE | F_SEAL_SHRINK | F_SEAL_GROW — 보낸 뒤에는 내용/크기를 바꿀 수 없다)
+ *   2) BlobChannel::send()가 fd를 사이드 소켓(<socketPath>.fd, SOCK_SEQPACKET)으로
+ *      SCM_RIGHTS 전달하고 blob id를 돌려준다
+ *   3) 메인 스트림에는 작은 제어 프레임(ShellBlob / ModuleBlob: id, kind, size)만 보낸다
+ *   4) 수신 측은 제어 프레임을 받으면 BlobChannel::take(id)로 fd를 꺼내 읽기 전용 매핑
+ * 데이터는 프로세스 사이에서 한 번도 복사되지 않는다 (같은 페이지를 양쪽이 매핑).
+ *
+ * fd는 제어 프레임보다 먼저 보내므로, 제어 프레임이 도착했을 때 fd는 이미
+ * 사이드 소켓 수신 큐에 있다 — take()는 필요하면 그 자리에서 큐를 비운다.
+ * 봉인되지 않은 memfd는 거부한다 (송신 측이 truncate하면 수신 측이 SIGBUS를 맞는다).
+ */
+
+#ifndef SHAREDBLOB_H
+#define SHAREDBLOB_H
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QHash>
+#include <QMetaType>
+#include <QSharedPointer>
+#include <QString>
+
+namespace HuProtocol {
+
+/** 받아들이는 blob 최대 크기 (손상되었거나 악의적인 fd 방어) */
+static constexpr qint64 MAX_BLOB_SIZE = 256ll * 1024 * 1024;
+
+/** memfd 하나와 그 매핑을 소유하는 RAII 핸들 (이동만 가능) */
+class SharedBlob
+{
+public:
+    SharedBlob() = default;
+    ~SharedBlob();
+
+    SharedBlob(SharedBlob &&other) noexcept;
+    SharedBlob &operator=(SharedBlob &&other) noexcept;
+    SharedBlob(const SharedBlob &) = delete;
+    SharedBlob &operator=(const SharedBlob &) = delete;
+
+    /** 쓰기 가능한 blob 생성 — writableData()를 채운 뒤 seal()해야 보낼 수 있다 */
+    static SharedBlob create(qint64 size, const char *name = "hu_blob");
+    /** 편의용: 이미 메모리에 있는 데이터를 한 번 복사해 봉인된 blob으로 */
+    static SharedBlob fromBytes(const char *data, qint64 size);
+    /** 수신한 fd의 소유권을 넘겨받아 읽기 전용으로 매핑 (봉인 안 됨/크기 초과면 fd를 닫고 무효) */
+    static SharedBlob adopt(int fd);
+
+    /** seal() 전까지만 유효 */
+    char *writableData() { return m_sealed ? nullptr : m_map; }
+    /** 쓰기 매핑을 풀고 봉인한 뒤 읽기 전용으로 다시 매핑 */
+    bool seal();
+
+    const char *data() const { return m_map; }
+    qint64 size() const { return m_size; }
+    int  fd() const { return m_fd; }
+    bool isValid() const { return m_fd >= 0; }
+    bool isSealed() const { return m_sealed; }
+
+    /** 복사 없는 QByteArray 뷰 — blob이 살아 있는 동안만 유효 */
+    QByteArray view() const
+    {
+        return QByteArray::fromRawData(m_map, static_cast<int>(m_size));
+    }
+
+private:
+    bool map(int prot);
+    void reset();
+
+    int    m_fd     = -1;
+    char  *m_map    = nullptr;
+    qint64 m_size   = 0;
+    bool   m_sealed = false;
+};
+
+/** 수신 측에서 시그널로 넘길 때 사용 (스레드 간 공유, 마지막 참조가 사라지면 munmap/close) */
+using SharedBlobPtr = QSharedPointer<const SharedBlob>;
+
+/**
+ * fd 전달용 사이드 소켓 (연결당 하나).
+ *   Shell  : listen(pathFor(socketPath)) — 모듈이 연결하면 hasPeer()/take()에서 accept
+ *   Module : connectTo(pathFor(socketPath)) — 메인 소켓 연결 직후 동기로 연결
+ * 메시지 하나 = [uint32 blob id] + SCM_RIGHTS fd 1개. 모든 호출은 논블로킹이다.
+ */
+class BlobChannel
+{
+public:
+    BlobChannel() = default;
+    ~BlobChannel();
+
+    BlobChannel(const BlobChannel &) = delete;
+    BlobChannel &operator=(const BlobChannel &) = delete;
+
+    static QString pathFor(const QString &socketPath) { return socketPath + QStringLiteral(".fd"); }
+
+    bool listen(const QString &path);
+    bool connectTo(const QString &path);
+    bool isListening() const { return m_listenFd >= 0; }
+
+    /** 연결된 상대가 있는지 (서버는 대기 중인 연결을 여기서 accept — 최신 연결이 이긴다) */
+    bool hasPeer();
+    /** 현재 상대 연결과 아직 찾아가지 않은 fd를 모두 닫는다 (listen은 유지) */
+    void dropPeer();
+    void close();
+
+    /** 봉인된 blob의 fd를 보낸다. @return blob id (실패 시 0 — 호출자는 스트림 전송으로 대체) */
+    quint32 send(const SharedBlob &blob);
+
+    /** id에 해당하는 fd를 꺼내 매핑. 없거나 봉인되지 않았으면 무효 blob */
+    SharedBlob take(quint32 blobId);
+
+    int pendingCount() const { return m_pending.size(); }
+
+private:
+    void acceptPending();
+    void drain();
+
+    int                 m_listenFd = -1;
+    int                 m_peerFd   = -1;
+    QString             m_path;
+    quint32             m_nextId   = 0;
+    QHash<quint32, int> m_pending;   // 제어 프레임을 기다리는 수신 fd
+
+    static constexpr int MAX_PENDING = 32;
+};
+
+} // namespace HuProtocol
+
+Q_DECLARE_METATYPE(HuProtocol::SharedBlobPtr)
+
+#endif // SHAREDBLOB_H
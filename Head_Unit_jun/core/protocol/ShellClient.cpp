@@ -9,165 +9,346 @@
 ShellClient::ShellClient(const QString &socketPath, QObject *parent)
     : QObject(parent)
     , m_socketPath(socketPath)
-    , m_socket(new QLocalSocket(this))
+    , m_stream(new QLocalSocket(this))
+    , m_packet(new HuProtocol::SeqPacketSocket(this))
+    , m_socket(m_stream)
+    , m_transport(qEnvironmentVariable("HU_IPC_TRANSPORT").trimmed().toLower() == QStringLiteral("stream")
+                      ? HuProtocol::Transport::Stream : HuProtocol::Transport::SeqPacket)
     , m_reconnectTimer(new QTimer(this))
 {
     m_reconnectTimer->setInterval(1000);
     m_reconnectTimer->setSingleShot(true);
 
-    connect(m_socket, &QLocalSocket::connected,    this, &ShellClient::onConnected);
-    connect(m_socket, &QLocalSocket::disconnected, this, &ShellClient::onDisconnected);
-    connect(m_socket, &QLocalSocket::readyRead,    this, &ShellClient::onReadyRead);
+    connect(m_stream, &QLocalSocket::connected,    this, &ShellClient::onConnected);
+    connect(m_stream, &QLocalSocket::disconnected, this, &ShellClient::onDisconnected);
+    connect(m_stream, &QLocalSocket::readyRead,    this, &ShellClient::onReadyRead);
+    connect(m_packet, &HuProtocol::SeqPacketSocket::disconnected, this, &ShellClient::onDisconnected);
+    connect(m_packet, &HuProtocol::SeqPacketSocket::readyRead,    this, &ShellClient::onReadyRead);
     connect(m_reconnectTimer, &QTimer::timeout,    this, &ShellClient::tryReconnect);
 }
 
+ShellClient::~ShellClient()
+{
+    closeSharedState();
+}
+
 void ShellClient::connectToShell()
 {
-    m_socket->connectToServer(m_socketPath);
+    startConnect();
+}
+
+void ShellClient::startConnect()
+{
+    // .pkt는 shell이 이 모듈에 SOCK_SEQPACKET을 켰을 때만 존재한다 — connect는 동기
+    if (m_transport == HuProtocol::Transport::SeqPacket
+        && m_packet->connectToServer(HuProtocol::SeqPacketSocket::pathFor(m_socketPath))) {
+        m_socket = m_packet;
+        onConnected();
+        return;
+    }
+    m_socket = m_stream;
+    m_stream->connectToServer(m_socketPath);
 }
 
 bool ShellClient::isConnected() const
 {
-    return m_socket->state() == QLocalSocket::ConnectedState;
+    if (m_socket == m_packet)
+        return m_packet->isConnected();
+    return m_stream->state() == QLocalSocket::ConnectedState;
 }
 
 // ── Shell 연결 이벤트 ─────────────────────────────────────────────────
 
 void ShellClient::onConnected()
 {
-    qDebug() << "[ShellClient] connected to" << m_socketPath;
+    m_reader.clear();
+    m_peerStamps = false;
+    m_txSeq      = 0;
+    m_latency.clear();
+    m_peerBlobs  = false;
+    qDebug() << "[ShellClient] connected to" << m_socketPath
+             << (m_socket == m_packet ? "(seqpacket)" : "(stream)");
+
+    // 사이드 채널은 Capabilities보다 먼저 연결해 둔다 — shell은 이 비트를 받자마자 accept한다
+    quint32 caps = HuProtocol::CapTimestampedHeader;
+    if (m_blobs.connectTo(HuProtocol::BlobChannel::pathFor(m_socketPath)))
+        caps |= HuProtocol::CapBlobChannel;
+    // 공유 블록을 열었을 때만 알린다 — 못 열면 shell이 계속 소켓으로 보낸다
+    if (openSharedState())
+        caps |= HuProtocol::CapSharedVehicleState;
+    // 구버전 shell은 모르는 타입으로 무시한다 → 확장 헤더 없이 계속 동작
+    send(HuProtocol::ModuleCapabilitiesMsg{ caps });
     emit connected();
+    if (m_vehicleState.isValid())
+        emitSharedState(true);
 }
 
 void ShellClient::onDisconnected()
 {
     qDebug() << "[ShellClient] disconnected; retrying in 1s";
+    m_latency.log(QStringLiteral("[ShellClient] %1").arg(m_socketPath));
+    m_blobs.close();
+    m_peerBlobs = false;
+    closeSharedState();
     emit disconnected();
     m_reconnectTimer->start();
 }
 
 void ShellClient::tryReconnect()
 {
-    if (m_socket->state() == QLocalSocket::UnconnectedState)
-        m_socket->connectToServer(m_socketPath);
+    if (!m_packet->isConnected() && m_stream->state() == QLocalSocket::UnconnectedState)
+        startConnect();
 }
 
-// ── 수신 처리 ─────────────────────────────────────────────────────────
+// ── 공유 메모리 차량 상태 ─────────────────────────────────────────────
 
-void ShellClient::onReadyRead()
+bool ShellClient::openSharedState()
 {
-    m_readBuf.append(m_socket->readAll());
-    processBuffer();
+    closeSharedState();
+    if (!m_vehicleState.open()) {
+        qDebug() << "[ShellClient] shared vehicle state unavailable; using socket updates";
+        return false;
+    }
+
+    // 워커는 futex로 잠들어 있다가 값이 바뀔 때만 깨어나 GUI 스레드에 한 번 알린다.
+    // 이미 알림이 대기 중이면 추가로 post하지 않는다 (이벤트 루프 1회당 최대 1건).
+    m_watching = true;
+    m_stateWatcher = std::thread([this] {
+        quint32 seen = m_vehicleState.changeCount();
+        while (m_watching.load()) {
+            if (!m_vehicleState.waitForChange(seen, 200))
+                continue;
+            seen = m_vehicleState.changeCount();
+            if (!m_statePending.exchange(true))
+                QMetaObject::invokeMethod(this, "onSharedStateChanged", Qt::QueuedConnection);
+        }
+    });
+    return true;
 }
 
-void ShellClient::processBuffer()
+void ShellClient::closeSharedState()
 {
-    while (true) {
-        HuProtocol::MsgType type;
-        QByteArray payload;
-        int consumed = 0;
-        if (!HuProtocol::decodeFrame(m_readBuf, type, payload, consumed))
-            break;
-        m_readBuf.remove(0, consumed);
-        dispatchFrame(type, payload);
-    }
+    m_watching = false;
+    if (m_stateWatcher.joinable())
+        m_stateWatcher.join();
+    m_vehicleState.close();
+    m_statePending = false;
 }
 
-void ShellClient::dispatchFrame(HuProtocol::MsgType type, const QByteArray &payload)
+void ShellClient::onSharedStateChanged()
 {
-    using MT = HuProtocol::MsgType;
-    QDataStream ds(payload);
-    ds.setByteOrder(QDataStream::BigEndian);
+    m_statePending = false;
+    emitSharedState(false);
+}
 
-    switch (type) {
-    case MT::ShowModule: {
-        qint32 x, y, w, h;
-        ds >> x >> y >> w >> h;
-        emit showRequested(QRect(x, y, w, h));
-        break;
+void ShellClient::emitSharedState(bool force)
+{
+    // 일관된 값을 못 읽었으면 이번 알림은 건너뛴다 — 다음 변경 알림에서 다시 읽는다
+    HuProtocol::VehicleStateSnapshot s;
+    if (!m_vehicleState.snapshot(s)) return;
+
+    // 기어는 순서가 중요한 이산 이벤트라 소켓(GearStateUpdate)으로만 전달한다
+    if (force || s.speedKmh != m_lastShared.speedKmh)
+        emit vehicleSpeedUpdated(s.speedKmh);
+    if (force || s.batteryVoltage != m_lastShared.batteryVoltage
+              || s.batteryPercent != m_lastShared.batteryPercent)
+        emit batteryUpdated(s.batteryVoltage, s.batteryPercent);
+    if (force || s.ipcConnected != m_lastShared.ipcConnected)
+        emit ipcStatusUpdated(s.ipcConnected);
+    m_lastShared = s;
+}
+
+// ── 수신 처리 ─────────────────────────────────────────────────────────
+
+void ShellClient::onReadyRead()
+{
+    if (m_socket == m_packet) {
+        readPackets();
+        return;
     }
-    case MT::HideModule:
-        emit hideRequested();
-        break;
-    case MT::GearStateUpdate: {
-        quint8 g;
-        ds >> g;
-        emit gearStateUpdated(static_cast<GearState>(g));
-        break;
+
+    // 소켓 → 링버퍼 직접 읽기, 프레임은 제자리에서 파싱 (프레임당 복사/할당 없음)
+    while (m_reader.readFrom(m_stream) > 0) {
+        HuProtocol::FrameView frame;
+        while (m_reader.next(frame))
+            dispatchFrame(frame);
     }
-    case MT::VehicleSpeedUpdate: {
-        float kmh;
-        ds >> kmh;
-        emit vehicleSpeedUpdated(kmh);
-        break;
+    if (m_reader.hasError()) {
+        qWarning() << "[ShellClient] corrupt frame stream; dropping connection";
+        m_reader.clear();
+        m_stream->abort();
     }
-    case MT::BatteryUpdate: {
-        float v, pct;
-        ds >> v >> pct;
-        emit batteryUpdated(v, pct);
-        break;
+}
+
+void ShellClient::readPackets()
+{
+    // 커널이 경계를 유지 — recvmmsg 한 번에 여러 프레임, 재조립 없음
+    while (m_packet->readBatch() > 0) {
+        HuProtocol::FrameView frame;
+        while (m_packet->next(frame))
+            dispatchFrame(frame);
+        if (m_packet->hasError())
+            break;
     }
-    case MT::IpcStatusUpdate: {
-        quint8 status;
-        ds >> status;
-        emit ipcStatusUpdated(status != 0);
-        break;
+    // 잘린 데이터그램은 readBatch()가 -1로 끝난다 — 그대로 두면 notifier가 계속 깨운다
+    if (m_packet->hasError()) {
+        qWarning() << "[ShellClient] malformed datagram; dropping connection";
+        m_packet->abort();
     }
-    case MT::ShellShutdown:
-        emit shellShutdown();
+}
+
+void ShellClient::dispatchFrame(const HuProtocol::FrameView &frame)
+{
+    m_latency.record(frame);
+    switch (Dispatcher::dispatch(*this, frame)) {
+    case HuProtocol::DispatchResult::Handled:
+        break;
+    case HuProtocol::DispatchResult::Malformed:
+        qWarning() << "[ShellClient] truncated payload for msg type"
+                   << static_cast<quint32>(frame.type) << "size" << frame.size;
         break;
-    default:
-        qWarning() << "[ShellClient] unknown msg type" << static_cast<quint32>(type);
+    case HuProtocol::DispatchResult::Unknown:
+        qWarning() << "[ShellClient] unknown msg type" << static_cast<quint32>(frame.type);
         break;
     }
 }
 
+void ShellClient::handle(const HuProtocol::ShowModuleMsg &msg)
+{
+    // 공유 블록 변경 알림이 큐에 남아 있으면 표시 전에 먼저 반영 — 화면에 이전 값이 먼저 뜨지 않게
+    if (m_statePending.exchange(false))
+        emitSharedState(false);
+    emit showRequested(QRect(msg.x, msg.y, msg.w, msg.h));
+}
+
+void ShellClient::handle(const HuProtocol::HideModuleMsg &)
+{
+    emit hideRequested();
+}
+
+void ShellClient::handle(const HuProtocol::GearStateUpdateMsg &msg)
+{
+    emit gearStateUpdated(static_cast<GearState>(msg.gear));
+}
+
+void ShellClient::handle(const HuProtocol::VehicleSpeedUpdateMsg &msg)
+{
+    emit vehicleSpeedUpdated(msg.kmh);
+}
+
+void ShellClient::handle(const HuProtocol::BatteryUpdateMsg &msg)
+{
+    emit batteryUpdated(msg.voltage, msg.percent);
+}
+
+void ShellClient::handle(const HuProtocol::IpcStatusUpdateMsg &msg)
+{
+    emit ipcStatusUpdated(msg.connected != 0);
+}
+
+void ShellClient::handle(const HuProtocol::ShellBlobMsg &msg)
+{
+    HuProtocol::SharedBlob blob = m_blobs.take(msg.blobId);
+    if (!blob.isValid() || static_cast<quint64>(blob.size()) != msg.size) {
+        qWarning() << "[ShellClient] blob" << msg.blobId << "missing or size mismatch";
+        return;
+    }
+    emit blobReceived(msg.kind,
+                      HuProtocol::SharedBlobPtr(new HuProtocol::SharedBlob(std::move(blob))));
+}
+
+void ShellClient::handle(const HuProtocol::ShellCapabilitiesMsg &msg)
+{
+    m_peerStamps = (msg.flags & HuProtocol::CapTimestampedHeader) != 0;
+    m_peerBlobs  = (msg.flags & HuProtocol::CapBlobChannel) != 0 && m_blobs.hasPeer();
+}
+
+void ShellClient::handle(const HuProtocol::ShellShutdownMsg &)
+{
+    m_latency.log(QStringLiteral("[ShellClient] %1").arg(m_socketPath));
+    emit shellShutdown();
+}
+
 // ── 송신 헬퍼 ─────────────────────────────────────────────────────────
 
 void ShellClient::sendFrame(HuProtocol::MsgType type, const QByteArray &payload)
 {
     if (!isConnected()) return;
-    m_socket->write(HuProtocol::encodeFrame(type, payload));
+    qint64 written;
+    if (m_peerStamps) {
+        const HuProtocol::FrameStamp stamp{ HuProtocol::monotonicNowNs(), ++m_txSeq };
+        written = m_socket->write(HuProtocol::encodeFrame(type, payload, &stamp));
+    } else {
+        written = m_socket->write(HuProtocol::encodeFrame(type, payload));
+    }
+    if (written < 0)
+        qWarning() << "[ShellClient] frame not sent:" << m_socket->errorString();
+}
+
+bool ShellClient::sendBlob(quint32 kind, const HuProtocol::SharedBlob &blob)
+{
+    if (!canSendBlobs()) return false;
+    // fd가 제어 프레임보다 먼저 나가야 shell의 take()가 항상 찾을 수 있다
+    const quint32 id = m_blobs.send(blob);
+    if (id == 0) return false;
+    send(HuProtocol::ModuleBlobMsg{ id, kind, static_cast<quint64>(blob.size()) });
+    return true;
 }
 
 void ShellClient::notifyReady(quint64 winId)
 {
-    QByteArray p;
-    QDataStream ds(&p, QIODevice::WriteOnly);
-    ds.setByteOrder(QDataStream::BigEndian);
-    ds << winId;
-    sendFrame(HuProtocol::MsgType::ModuleReady, p);
+    send(HuProtocol::ModuleReadyMsg{ winId });
 }
 
 void ShellClient::requestGearChange(GearState gear, const QString &source)
 {
-    QByteArray p;
-    QDataStream ds(&p, QIODevice::WriteOnly);
-    ds.setByteOrder(QDataStream::BigEndian);
-    quint8 src = (source == "button") ? 1 : 0;
-    ds << static_cast<quint8>(gear) << src;
-    sendFrame(HuProtocol::MsgType::GearChangeRequest, p);
+    const quint8 src = (source == "button") ? 1 : 0;
+    send(HuProtocol::GearChangeRequestMsg{ static_cast<quint8>(gear), src });
 }
 
 void ShellClient::sendAmbientColor(quint8 r, quint8 g, quint8 b, quint8 brightness)
 {
-    QByteArray p;
-    QDataStream ds(&p, QIODevice::WriteOnly);
-    ds.setByteOrder(QDataStream::BigEndian);
-    ds << r << g << b << brightness;
-    sendFrame(HuProtocol::MsgType::AmbientColorSet, p);
+    send(HuProtocol::AmbientColorSetMsg{ r, g, b, brightness });
 }
 
 void ShellClient::sendAmbientOff()
 {
-    sendFrame(HuProtocol::MsgType::AmbientOff);
+    send(HuProtocol::AmbientOffMsg{});
+}
+
+void ShellClient::sendSettings(const HuProtocol::SettingsDelta &delta)
+{
+    if (delta.isEmpty()) return;
+    m_pendingSettings.merge(delta);
+    if (!m_settingsFlushQueued) {
+        m_settingsFlushQueued = true;
+        QMetaObject::invokeMethod(this, "flushSettings", Qt::QueuedConnection);
+    }
+}
+
+void ShellClient::flushSettings()
+{
+    m_settingsFlushQueued = false;
+    if (m_pendingSettings.isEmpty()) return;
+    sendFrame(HuProtocol::MsgType::SettingsDelta, m_pendingSettings.encode());
+    m_pendingSettings.clear();
 }
 
 void ShellClient::sendSettingsChanged(const QVariantMap &changes)
 {
+    HuProtocol::SettingsDelta delta;
+    QVariantMap extension;
+    for (auto it = changes.constBegin(); it != changes.constEnd(); ++it) {
+        const HuProtocol::SettingDescriptor *desc = HuProtocol::findSetting(it.key());
+        if (!desc || !delta.setVariant(*desc, it.value()))
+            extension.insert(it.key(), it.value());
+    }
+    sendSettings(delta);
+    if (extension.isEmpty()) return;
+
     QByteArray p;
     QDataStream ds(&p, QIODevice::WriteOnly);
     ds.setByteOrder(QDataStream::BigEndian);
-    ds << changes;
+    ds << extension;
     sendFrame(HuProtocol::MsgType::SettingsChanged, p);
 }
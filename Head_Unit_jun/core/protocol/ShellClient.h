@@ -6,12 +6,30 @@
  *   ShellClient *client = new ShellClient("/tmp/hu_shell_media.sock");
  *   connect(client, &ShellClient::showRequested, window, [](QRect geo){ window->setGeometry(geo); window->show(); });
  *   client->connectToShell();
+ *
+ * 속도/배터리/IPC 상태는 shell이 공유 메모리 블록(VehicleStateBlock)에 기록한다.
+ * 블록을 열 수 있으면 워커 스레드가 futex로 변경을 기다렸다가 기존 시그널을 emit하고,
+ * vehicleState(out)로 시스템콜 없이 최신 스냅샷을 읽을 수 있다.
+ *
+ * 전송: <socketPath>.pkt(SOCK_SEQPACKET)가 열려 있으면 먼저 그쪽으로 연결하고,
+ * 없으면 스트림 소켓을 쓴다. HU_IPC_TRANSPORT=stream이면 항상 스트림 소켓.
+ *
+ * 커버 아트 같은 대용량 데이터는 sendBlob()으로 봉인된 memfd를 넘긴다 (SharedBlob.h):
+ *   HuProtocol::SharedBlob blob = HuProtocol::SharedBlob::create(size);
+ *   renderInto(blob.writableData());  blob.seal();
+ *   if (!client->sendBlob(HuProtocol::BlobCoverArt, blob)) { ...구버전 shell: 대체 경로... }
  */
 
 #ifndef SHELLCLIENT_H
 #define SHELLCLIENT_H
 
 #include "ShellProtocol.h"
+#include "FrameReader.h"
+#include "LatencyHistogram.h"
+#include "SettingsRegistry.h"
+#include "SeqPacketSocket.h"
+#include "SharedBlob.h"
+#include "VehicleStateBlock.h"
 #include "IVehicleDataProvider.h"  // GearState enum
 
 #include <QLocalSocket>
@@ -19,25 +37,58 @@
 #include <QVariantMap>
 #include <QTimer>
 
+#include <atomic>
+#include <thread>
+
 class ShellClient : public QObject
 {
     Q_OBJECT
 
 public:
     explicit ShellClient(const QString &socketPath, QObject *parent = nullptr);
+    ~ShellClient() override;
 
     /** Shell 소켓에 연결 시도 (비동기, 실패 시 재시도) */
     void connectToShell();
 
     bool isConnected() const;
 
+    /** 다음 연결부터 적용. SeqPacket = .pkt 먼저 시도 후 스트림으로 fallback */
+    void setTransport(HuProtocol::Transport transport) { m_transport = transport; }
+    HuProtocol::Transport activeTransport() const
+    {
+        return m_socket == m_packet ? HuProtocol::Transport::SeqPacket : HuProtocol::Transport::Stream;
+    }
+
+    // ── 공유 메모리 차량 상태 (읽기 전용) ─────────────────
+    bool hasSharedVehicleState() const { return m_vehicleState.isValid(); }
+    /** 일관된 스냅샷을 못 읽으면 false (out은 그대로) */
+    bool vehicleState(HuProtocol::VehicleStateSnapshot &out) const { return m_vehicleState.snapshot(out); }
+
+    /** shell → 모듈 프레임의 MsgType별 지연/간격 (확장 헤더가 협상된 경우) */
+    const HuProtocol::FrameLatencyStats &latencyStats() const { return m_latency; }
+
     // ── Module → Shell 전송 메서드 ─────────────────────────
     void notifyReady(quint64 winId);
     void requestGearChange(GearState gear, const QString &source);
     void sendAmbientColor(quint8 r, quint8 g, quint8 b, quint8 brightness);
     void sendAmbientOff();
+
+    /**
+     * 설정 변경 전송. 같은 이벤트 루프 패스의 호출은 하나의 SettingsDelta 프레임으로
+     * 합쳐진다 (같은 키는 마지막 값).
+     */
+    void sendSettings(const HuProtocol::SettingsDelta &delta);
+    /** 호환용: 레지스트리 키는 sendSettings()로, 나머지는 QVariantMap 프레임으로 보낸다 */
     void sendSettingsChanged(const QVariantMap &changes);
 
+    /**
+     * 봉인된 blob을 fd로 넘기고 ModuleBlob 제어 프레임을 보낸다 (복사 없음).
+     * @return shell이 사이드 채널을 지원하지 않거나 전달에 실패하면 false
+     */
+    bool sendBlob(quint32 kind, const HuProtocol::SharedBlob &blob);
+    bool canSendBlobs() const { return isConnected() && m_peerBlobs; }
+
 signals:
     void connected();
     void disconnected();
@@ -49,6 +100,8 @@ signals:
     void vehicleSpeedUpdated(float kmh);
     void batteryUpdated(float voltage, float percent);
     void ipcStatusUpdated(bool connected);
+    /** shell이 보낸 대용량 payload (읽기 전용 매핑) */
+    void blobReceived(quint32 kind, const HuProtocol::SharedBlobPtr &blob);
     void shellShutdown();
 
 private slots:
@@ -56,16 +109,69 @@ private slots:
     void onDisconnected();
     void onReadyRead();
     void tryReconnect();
+    void onSharedStateChanged();
+    void flushSettings();
 
 private:
+    using Dispatcher = HuProtocol::Dispatcher<ShellClient, HuProtocol::ShellToModule>;
+    friend Dispatcher;
+
+    template <typename Msg>
+    void send(const Msg &msg)
+    {
+        if (!isConnected()) return;
+        if (m_peerStamps) {
+            const auto frame = HuProtocol::encode(
+                msg, HuProtocol::FrameStamp{ HuProtocol::monotonicNowNs(), ++m_txSeq });
+            m_socket->write(frame.data(), frame.size());
+        } else {
+            const auto frame = HuProtocol::encode(msg);
+            m_socket->write(frame.data(), frame.size());
+        }
+    }
+
     void sendFrame(HuProtocol::MsgType type, const QByteArray &payload = {});
-    void processBuffer();
-    void dispatchFrame(HuProtocol::MsgType type, const QByteArray &payload);
+    void startConnect();
+    void readPackets();
+    void dispatchFrame(const HuProtocol::FrameView &frame);
+
+    // ── Shell → Module 핸들러 (Dispatcher가 호출) ─────
+    void handle(const HuProtocol::ShowModuleMsg &msg);
+    void handle(const HuProtocol::HideModuleMsg &msg);
+    void handle(const HuProtocol::GearStateUpdateMsg &msg);
+    void handle(const HuProtocol::VehicleSpeedUpdateMsg &msg);
+    void handle(const HuProtocol::BatteryUpdateMsg &msg);
+    void handle(const HuProtocol::IpcStatusUpdateMsg &msg);
+    void handle(const HuProtocol::ShellBlobMsg &msg);
+    void handle(const HuProtocol::ShellCapabilitiesMsg &msg);
+    void handle(const HuProtocol::ShellShutdownMsg &msg);
+    bool openSharedState();   // 성공 시 CapSharedVehicleState를 알린다
+    void closeSharedState();
+    void emitSharedState(bool force);
+
+    QString                      m_socketPath;
+    QLocalSocket                *m_stream;
+    HuProtocol::SeqPacketSocket *m_packet;
+    QIODevice                   *m_socket;      // 현재 전송 (m_stream 또는 m_packet)
+    HuProtocol::Transport        m_transport;
+    HuProtocol::FrameReader      m_reader;      // 스트림 전송에서만 사용
+    QTimer                  *m_reconnectTimer;
+
+    HuProtocol::SettingsDelta     m_pendingSettings;
+    bool                          m_settingsFlushQueued = false;
+
+    bool                          m_peerStamps = false;   // shell이 확장 헤더 수신 가능
+    quint32                       m_txSeq      = 0;
+    HuProtocol::FrameLatencyStats m_latency;
+
+    HuProtocol::BlobChannel       m_blobs;
+    bool                          m_peerBlobs = false;    // shell 사이드 채널 사용 가능
 
-    QString        m_socketPath;
-    QLocalSocket  *m_socket;
-    QByteArray     m_readBuf;
-    QTimer        *m_reconnectTimer;
+    HuProtocol::VehicleStateBlock    m_vehicleState;
+    HuProtocol::VehicleStateSnapshot m_lastShared;
+    std::thread                      m_stateWatcher;
+    std::atomic<bool>                m_watching{false};
+    std::atomic<bool>                m_statePending{false};
 };
 
 #endif // SHELLCLIENT_H
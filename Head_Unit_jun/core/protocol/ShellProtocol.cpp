@@ -6,19 +6,51 @@
 
 namespace HuProtocol {
 
-static constexpr int HEADER_SIZE = sizeof(quint32) * 2; // length + type
-
-QByteArray encodeFrame(MsgType type, const QByteArray &payload)
+QByteArray encodeFrame(MsgType type, const QByteArray &payload, const FrameStamp *stamp)
 {
     QByteArray frame;
     QDataStream ds(&frame, QIODevice::WriteOnly);
     ds.setByteOrder(QDataStream::BigEndian);
-    ds << static_cast<quint32>(payload.size());
-    ds << static_cast<quint32>(type);
+    if (stamp) {
+        ds << static_cast<quint32>(payload.size() + STAMP_SIZE);
+        ds << (static_cast<quint32>(type) | STAMPED_FLAG);
+        ds << stamp->sentNs << stamp->seq;
+    } else {
+        ds << static_cast<quint32>(payload.size());
+        ds << static_cast<quint32>(type);
+    }
     frame.append(payload);
     return frame;
 }
 
+bool parseFrame(const char *data, int size, FrameView &out)
+{
+    if (size < HEADER_SIZE)
+        return false;
+    const quint32 payloadLen = qFromBigEndian<quint32>(data);
+    const quint32 typeRaw    = qFromBigEndian<quint32>(data + sizeof(quint32));
+    if (payloadLen != static_cast<quint32>(size - HEADER_SIZE))
+        return false;
+
+    const char *payload = data + HEADER_SIZE;
+    int         len     = static_cast<int>(payloadLen);
+    out.stamped = (typeRaw & STAMPED_FLAG) != 0;
+    if (out.stamped) {
+        if (len < STAMP_SIZE)
+            return false;
+        out.stamp.sentNs = qFromBigEndian<quint64>(payload);
+        out.stamp.seq    = qFromBigEndian<quint32>(payload + sizeof(quint64));
+        payload += STAMP_SIZE;
+        len     -= STAMP_SIZE;
+    } else {
+        out.stamp = FrameStamp{};
+    }
+    out.type = static_cast<MsgType>(typeRaw & ~STAMPED_FLAG);
+    out.data = payload;
+    out.size = len;
+    return true;
+}
+
 bool decodeFrame(const QByteArray &buf,
                  MsgType &outType, QByteArray &outPayload,
                  int &bytesConsumed)
@@ -37,8 +69,15 @@ bool decodeFrame(const QByteArray &buf,
     if (buf.size() < totalSize)
         return false;
 
-    outType        = static_cast<MsgType>(typeRaw);
-    outPayload     = buf.mid(HEADER_SIZE, static_cast<int>(payloadLen));
+    int skip = 0;
+    if (typeRaw & STAMPED_FLAG) {
+        if (payloadLen < static_cast<quint32>(STAMP_SIZE))
+            return false;
+        skip = STAMP_SIZE;
+    }
+
+    outType        = static_cast<MsgType>(typeRaw & ~STAMPED_FLAG);
+    outPayload     = buf.mid(HEADER_SIZE + skip, static_cast<int>(payloadLen) - skip);
     bytesConsumed  = totalSize;
     return true;
 }
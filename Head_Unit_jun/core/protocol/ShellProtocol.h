@@ -2,14 +2,38 @@
  * @file ShellProtocol.h
  * @brief Shell ↔ Module IPC 메시지 타입 및 직렬화 유틸리티
  *
- * 프레임 포맷 (QDataStream 빅엔디안):
+ * 프레임 포맷 (빅엔디안):
  *   [uint32: payload_length] [uint32: MsgType] [payload bytes...]
+ *
+ * 확장 헤더 (선택): MsgType 최상위 비트(STAMPED_FLAG)가 켜져 있으면 payload 앞에
+ *   [uint64: 송신 시각, CLOCK_MONOTONIC ns] [uint32: 연결별 송신 순번]
+ * 이 붙는다 (payload_length에 포함). 상대가 Capabilities로 CapTimestampedHeader를
+ * 알려온 경우에만 보낸다 — 구버전 peer는 Capabilities를 모르는 타입으로 무시하므로
+ * 확장 헤더를 받을 일이 없다.
+ *
+ * 메시지 카탈로그: MsgType마다 POD payload 구조체(…Msg)가 하나씩 대응한다.
+ *   - encode<Msg>() : 스택 버퍼에 고정 크기 프레임 생성 (QByteArray/QDataStream 없음)
+ *   - decode<Msg>() : FrameView에서 필드를 바로 읽음 (할당 없음)
+ *   - Dispatcher    : 컴파일 타임에 만든 점프 테이블로 Handler::handle(const Msg&) 호출
+ * 필드 목록과 선언된 kWireSize가 어긋나면 컴파일 에러가 난다.
+ *
+ * 새 신호 추가 방법:
+ *   1) MsgType 값 추가  2) …Msg 구조체 정의 (kType, kWireSize, fields())
+ *   3) ShellToModule / ModuleToShell 목록에 추가  4) Handler에 handle() 오버로드 추가
  */
 
 #ifndef SHELLPROTOCOL_H
 #define SHELLPROTOCOL_H
 
 #include <QtCore>
+#include <QtEndian>
+
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
 namespace HuProtocol {
 
@@ -18,24 +42,464 @@ enum class MsgType : quint32 {
     ShowModule          = 0x0001,   // payload: qint32 x, y, w, h
     HideModule          = 0x0002,   // no payload
     GearStateUpdate     = 0x0010,   // payload: quint8 gear (GearState enum value)
-    VehicleSpeedUpdate  = 0x0011,   // payload: float speed_kmh
-    BatteryUpdate       = 0x0012,   // payload: float voltage, float percent
+    VehicleSpeedUpdate  = 0x0011,   // payload: float32 speed_kmh
+    BatteryUpdate       = 0x0012,   // payload: float32 voltage, float32 percent
     IpcStatusUpdate     = 0x0013,   // payload: quint8 connected (0=disconnected, 1=connected)
+    ShellBlob           = 0x0020,   // payload: quint32 blobId, quint32 kind, quint64 size (fd는 사이드 채널)
+    ShellCapabilities   = 0x00F0,   // payload: quint32 flags (CapabilityFlag)
     ShellShutdown       = 0x00FF,   // no payload
 
     // ── Module → Shell ──────────────────────────────
-    ModuleReady         = 0x1001,   // payload: quint32 pid
+    ModuleReady         = 0x1001,   // payload: quint64 winId
     GearChangeRequest   = 0x1010,   // payload: quint8 gear, quint8 source
     AmbientColorSet     = 0x1020,   // payload: quint8 r, g, b, brightness
     AmbientOff          = 0x1021,   // no payload
-    SettingsChanged     = 0x1030,   // payload: QVariantMap (QDataStream)
+    SettingsChanged     = 0x1030,   // payload: QVariantMap (QDataStream) — 레지스트리에 없는 키 / 구버전 모듈
+    SettingsDelta       = 0x1031,   // payload: SettingsDelta (SettingsRegistry.h, 가변 길이)
+    ModuleBlob          = 0x1040,   // payload: quint32 blobId, quint32 kind, quint64 size (fd는 사이드 채널)
+    ModuleCapabilities  = 0x10F0,   // payload: quint32 flags (CapabilityFlag)
+};
+
+/** Capabilities 메시지로 교환하는 기능 비트 */
+enum CapabilityFlag : quint32 {
+    CapTimestampedHeader = 1u << 0,   // 확장 헤더(송신 시각 + 순번) 수신 가능
+    CapBlobChannel       = 1u << 1,   // memfd 사이드 채널(SharedBlob.h) 연결됨
+    CapSharedVehicleState = 1u << 2,  // 모듈 → shell: 공유 차량 상태 블록(VehicleStateBlock)을 열었음
+                                      //   — shell은 속도/배터리/IPC 상태를 소켓으로 보내지 않는다
+};
+
+/** ShellBlob / ModuleBlob의 kind — 수신 측이 내용을 해석하는 방법 */
+enum BlobKind : quint32 {
+    BlobCoverArt   = 1,   // 인코딩된 이미지 (PNG/JPEG)
+    BlobPlaylist   = 2,   // UTF-8 텍스트, 줄 단위
+    BlobScreenshot = 3,   // 인코딩된 이미지
+};
+
+static constexpr int HEADER_SIZE = sizeof(quint32) * 2; // length + type
+
+/**
+ * 손상된 length 필드로 버퍼가 무한히 커지지 않도록 하는 상한 (스트림 전송).
+ * SOCK_SEQPACKET 전송은 프레임 하나(헤더 포함)가 64 KiB(SeqPacketSocket.h의 MAX_PACKET_SIZE)를
+ * 넘을 수 없다 — 넘는 write는 거부된다. 그보다 큰 데이터는 SharedBlob 사이드 채널로 보낸다.
+ */
+static constexpr quint32 MAX_PAYLOAD_SIZE = 16u * 1024u * 1024u;
+
+/** MsgType 필드의 확장 헤더 표시 비트 */
+static constexpr quint32 STAMPED_FLAG = 0x80000000u;
+
+/** 확장 헤더 크기: uint64 송신 시각 + uint32 순번 */
+static constexpr int STAMP_SIZE = sizeof(quint64) + sizeof(quint32);
+
+/** 확장 헤더 내용 */
+struct FrameStamp {
+    quint64 sentNs = 0;
+    quint32 seq    = 0;
+};
+
+/** 프로세스 간 비교 가능한 단조 시계 (Linux steady_clock = CLOCK_MONOTONIC) */
+inline quint64 monotonicNowNs()
+{
+    return static_cast<quint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/** kWireSize로 쓰면 가변 길이 payload (fields() 대신 원시 바이트 뷰) */
+static constexpr quint32 VARIABLE_SIZE = 0xFFFFFFFFu;
+
+/**
+ * 수신 버퍼 안의 프레임 하나를 가리키는 뷰 (복사 없음).
+ * data는 FrameReader 내부 버퍼를 가리키므로 다음 readFrom()/next() 호출 전까지만 유효하다.
+ * 확장 헤더가 있었으면 stamped=true이고 data/size는 그 뒤의 payload만 가리킨다.
+ */
+struct FrameView {
+    MsgType     type = MsgType::ShellShutdown;
+    const char *data = nullptr;
+    int         size = 0;
+    bool        stamped = false;
+    FrameStamp  stamp;
+};
+
+// ── 메시지 카탈로그: Shell → Module ───────────────────────────────────
+
+struct ShowModuleMsg {
+    static constexpr MsgType kType     = MsgType::ShowModule;
+    static constexpr quint32 kWireSize = 16;
+    qint32 x = 0, y = 0, w = 0, h = 0;
+    template <typename Self> static auto fields(Self &m) { return std::tie(m.x, m.y, m.w, m.h); }
+};
+
+struct HideModuleMsg {
+    static constexpr MsgType kType     = MsgType::HideModule;
+    static constexpr quint32 kWireSize = 0;
+    template <typename Self> static auto fields(Self &) { return std::tie(); }
+};
+
+struct GearStateUpdateMsg {
+    static constexpr MsgType kType     = MsgType::GearStateUpdate;
+    static constexpr quint32 kWireSize = 1;
+    quint8 gear = 0;
+    template <typename Self> static auto fields(Self &m) { return std::tie(m.gear); }
+};
+
+struct VehicleSpeedUpdateMsg {
+    static constexpr MsgType kType     = MsgType::VehicleSpeedUpdate;
+    static constexpr quint32 kWireSize = 4;
+    float kmh = 0.0f;
+    template <typename Self> static auto fields(Self &m) { return std::tie(m.kmh); }
+};
+
+struct BatteryUpdateMsg {
+    static constexpr MsgType kType     = MsgType::BatteryUpdate;
+    static constexpr quint32 kWireSize = 8;
+    float voltage = 0.0f;
+    float percent = 0.0f;
+    template <typename Self> static auto fields(Self &m) { return std::tie(m.voltage, m.percent); }
+};
+
+struct IpcStatusUpdateMsg {
+    static constexpr MsgType kType     = MsgType::IpcStatusUpdate;
+    static constexpr quint32 kWireSize = 1;
+    quint8 connected = 0;
+    template <typename Self> static auto fields(Self &m) { return std::tie(m.connected); }
+};
+
+/** 봉인된 memfd 참조 — fd 자체는 BlobChannel로 먼저 전달된다 */
+struct ShellBlobMsg {
+    static constexpr MsgType kType     = MsgType::ShellBlob;
+    static constexpr quint32 kWireSize = 16;
+    quint32 blobId = 0;
+    quint32 kind   = 0;
+    quint64 size   = 0;
+    template <typename Self> static auto fields(Self &m) { return std::tie(m.blobId, m.kind, m.size); }
+};
+
+struct ShellCapabilitiesMsg {
+    static constexpr MsgType kType     = MsgType::ShellCapabilities;
+    static constexpr quint32 kWireSize = 4;
+    quint32 flags = 0;
+    template <typename Self> static auto fields(Self &m) { return std::tie(m.flags); }
+};
+
+struct ShellShutdownMsg {
+    static constexpr MsgType kType     = MsgType::ShellShutdown;
+    static constexpr quint32 kWireSize = 0;
+    template <typename Self> static auto fields(Self &) { return std::tie(); }
+};
+
+// ── 메시지 카탈로그: Module → Shell ───────────────────────────────────
+
+struct ModuleReadyMsg {
+    static constexpr MsgType kType     = MsgType::ModuleReady;
+    static constexpr quint32 kWireSize = 8;
+    quint64 winId = 0;
+    template <typename Self> static auto fields(Self &m) { return std::tie(m.winId); }
+};
+
+struct GearChangeRequestMsg {
+    static constexpr MsgType kType     = MsgType::GearChangeRequest;
+    static constexpr quint32 kWireSize = 2;
+    quint8 gear   = 0;
+    quint8 source = 0;   // 0=touch, 1=button
+    template <typename Self> static auto fields(Self &m) { return std::tie(m.gear, m.source); }
+};
+
+struct AmbientColorSetMsg {
+    static constexpr MsgType kType     = MsgType::AmbientColorSet;
+    static constexpr quint32 kWireSize = 4;
+    quint8 r = 0, g = 0, b = 0, brightness = 0;
+    template <typename Self> static auto fields(Self &m) { return std::tie(m.r, m.g, m.b, m.brightness); }
+};
+
+struct AmbientOffMsg {
+    static constexpr MsgType kType     = MsgType::AmbientOff;
+    static constexpr quint32 kWireSize = 0;
+    template <typename Self> static auto fields(Self &) { return std::tie(); }
+};
+
+/** 가변 길이 — SettingsDelta::decode()로 해석 */
+struct SettingsDeltaMsg {
+    static constexpr MsgType kType     = MsgType::SettingsDelta;
+    static constexpr quint32 kWireSize = VARIABLE_SIZE;
+    const char *data = nullptr;
+    int         size = 0;
+};
+
+struct ModuleBlobMsg {
+    static constexpr MsgType kType     = MsgType::ModuleBlob;
+    static constexpr quint32 kWireSize = 16;
+    quint32 blobId = 0;
+    quint32 kind   = 0;
+    quint64 size   = 0;
+    template <typename Self> static auto fields(Self &m) { return std::tie(m.blobId, m.kind, m.size); }
 };
 
-/** 프레임 하나를 QByteArray로 인코딩 */
-QByteArray encodeFrame(MsgType type, const QByteArray &payload = {});
+struct ModuleCapabilitiesMsg {
+    static constexpr MsgType kType     = MsgType::ModuleCapabilities;
+    static constexpr quint32 kWireSize = 4;
+    quint32 flags = 0;
+    template <typename Self> static auto fields(Self &m) { return std::tie(m.flags); }
+};
+
+/** 가변 길이 — payload 원시 바이트 뷰 (FrameView와 같은 수명) */
+struct SettingsChangedMsg {
+    static constexpr MsgType kType     = MsgType::SettingsChanged;
+    static constexpr quint32 kWireSize = VARIABLE_SIZE;
+    const char *data = nullptr;
+    int         size = 0;
+};
+
+template <typename... Msgs> struct MessageList {};
+
+using ShellToModule = MessageList<ShowModuleMsg, HideModuleMsg, GearStateUpdateMsg,
+                                  VehicleSpeedUpdateMsg, BatteryUpdateMsg,
+                                  IpcStatusUpdateMsg, ShellBlobMsg, ShellCapabilitiesMsg,
+                                  ShellShutdownMsg>;
+using ModuleToShell = MessageList<ModuleReadyMsg, GearChangeRequestMsg, AmbientColorSetMsg,
+                                  AmbientOffMsg, SettingsChangedMsg, SettingsDeltaMsg,
+                                  ModuleBlobMsg, ModuleCapabilitiesMsg>;
+
+// ── 컴파일 타임 검증 ──────────────────────────────────────────────────
+
+namespace detail {
+
+template <typename Msg>
+constexpr bool isVariable() { return Msg::kWireSize == VARIABLE_SIZE; }
+
+template <typename Tuple, std::size_t... I>
+constexpr quint32 tupleWireSize(std::index_sequence<I...>)
+{
+    return (quint32(0) + ... + quint32(sizeof(std::remove_reference_t<std::tuple_element_t<I, Tuple>>)));
+}
+
+template <typename Tuple, std::size_t... I>
+constexpr bool tupleIsArithmetic(std::index_sequence<I...>)
+{
+    return (true && ... && std::is_arithmetic<std::remove_cv_t<
+                               std::remove_reference_t<std::tuple_element_t<I, Tuple>>>>::value);
+}
+
+/** fields()에 나열된 필드들의 실제 직렬화 크기 */
+template <typename Msg>
+constexpr quint32 fieldsWireSize()
+{
+    using Tuple = decltype(Msg::fields(std::declval<Msg &>()));
+    return tupleWireSize<Tuple>(std::make_index_sequence<std::tuple_size<Tuple>::value>{});
+}
+
+template <typename Msg>
+constexpr bool fieldsArithmetic()
+{
+    using Tuple = decltype(Msg::fields(std::declval<Msg &>()));
+    return tupleIsArithmetic<Tuple>(std::make_index_sequence<std::tuple_size<Tuple>::value>{});
+}
+
+template <typename Msg, bool Variable = isVariable<Msg>()>
+struct MessageCheck {
+    static_assert(std::is_trivially_copyable<Msg>::value, "message payload must be POD");
+    static_assert(fieldsArithmetic<Msg>(), "message fields must be arithmetic types");
+    static_assert(fieldsWireSize<Msg>() == Msg::kWireSize,
+                  "fields() do not add up to the declared kWireSize");
+    static constexpr bool ok = true;
+};
+
+template <typename Msg>
+struct MessageCheck<Msg, true> {
+    static_assert(std::is_trivially_copyable<Msg>::value, "message payload must be POD");
+    static constexpr bool ok = true;
+};
+
+/**
+ * 희소한 MsgType 값을 점프 테이블 인덱스(0..511)로 접는다:
+ * 하위 8비트 + 방향 비트(0x1000 → 0x100).
+ */
+constexpr quint32 kSlotCount = 512;
+constexpr quint32 slotOf(quint32 raw) { return (raw & 0xFFu) | ((raw >> 4) & 0x100u); }
+constexpr bool    slotEncodable(quint32 raw) { return (raw & ~0x10FFu) == 0; }
+
+template <typename... Msgs>
+constexpr bool slotsUnique()
+{
+    constexpr quint32 slots[] = { slotOf(quint32(Msgs::kType))... };
+    for (std::size_t i = 0; i < sizeof...(Msgs); ++i)
+        for (std::size_t j = i + 1; j < sizeof...(Msgs); ++j)
+            if (slots[i] == slots[j]) return false;
+    return true;
+}
+
+// ── 필드 단위 빅엔디안 읽기/쓰기 ─────────────────────────────────────
+
+template <typename T>
+inline void putField(char *&out, T value)
+{
+    if constexpr (std::is_floating_point<T>::value) {
+        static_assert(sizeof(T) == 4 || sizeof(T) == 8, "IEEE754 float32/float64 only");
+        using Bits = std::conditional_t<sizeof(T) == 4, quint32, quint64>;
+        Bits bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        qToBigEndian<Bits>(bits, out);
+    } else {
+        qToBigEndian<T>(value, out);
+    }
+    out += sizeof(T);
+}
+
+template <typename T>
+inline void getField(const char *&in, T &value)
+{
+    if constexpr (std::is_floating_point<T>::value) {
+        using Bits = std::conditional_t<sizeof(T) == 4, quint32, quint64>;
+        const Bits bits = qFromBigEndian<Bits>(in);
+        std::memcpy(&value, &bits, sizeof(value));
+    } else {
+        value = qFromBigEndian<T>(in);
+    }
+    in += sizeof(T);
+}
+
+} // namespace detail
+
+// ── 인코딩 / 디코딩 ───────────────────────────────────────────────────
+
+/** 헤더(+확장 헤더) + payload가 들어있는 고정 크기 프레임 (스택에 생성) */
+template <typename Msg, bool Stamped = false>
+struct EncodedFrame {
+    static constexpr int kSize = HEADER_SIZE + (Stamped ? STAMP_SIZE : 0)
+                               + static_cast<int>(Msg::kWireSize);
+    char bytes[kSize];
+    const char *data() const { return bytes; }
+    constexpr int size() const { return kSize; }
+};
+
+namespace detail {
+template <typename Msg, bool Stamped>
+EncodedFrame<Msg, Stamped> encodeImpl(const Msg &msg, const FrameStamp &stamp)
+{
+    static_assert(MessageCheck<Msg>::ok, "");
+    static_assert(!isVariable<Msg>(), "variable-size messages use encodeFrame()");
+
+    EncodedFrame<Msg, Stamped> frame;
+    char *out = frame.bytes;
+    const quint32 type = static_cast<quint32>(Msg::kType) | (Stamped ? STAMPED_FLAG : 0u);
+    putField<quint32>(out, Msg::kWireSize + (Stamped ? STAMP_SIZE : 0));
+    putField<quint32>(out, type);
+    if constexpr (Stamped) {
+        putField<quint64>(out, stamp.sentNs);
+        putField<quint32>(out, stamp.seq);
+    }
+    std::apply([&out](const auto &...f) { (putField(out, f), ...); }, Msg::fields(msg));
+    return frame;
+}
+} // namespace detail
+
+template <typename Msg>
+EncodedFrame<Msg> encode(const Msg &msg)
+{
+    return detail::encodeImpl<Msg, false>(msg, FrameStamp{});
+}
+
+/** 확장 헤더(송신 시각 + 순번) 포함 — 상대가 CapTimestampedHeader를 알린 경우에만 사용 */
+template <typename Msg>
+EncodedFrame<Msg, true> encode(const Msg &msg, const FrameStamp &stamp)
+{
+    return detail::encodeImpl<Msg, true>(msg, stamp);
+}
+
+/**
+ * FrameView → Msg. payload가 선언 크기보다 짧으면 false.
+ * 뒤에 붙은 추가 바이트는 무시한다 (이후 버전의 필드 확장 허용).
+ */
+template <typename Msg>
+bool decode(const FrameView &frame, Msg &out)
+{
+    static_assert(detail::MessageCheck<Msg>::ok, "");
+    if constexpr (detail::isVariable<Msg>()) {
+        out.data = frame.data;
+        out.size = frame.size;
+        return true;
+    } else {
+        if (frame.size < static_cast<int>(Msg::kWireSize))
+            return false;
+        const char *in = frame.data;
+        std::apply([&in](auto &...f) { (detail::getField(in, f), ...); }, Msg::fields(out));
+        return true;
+    }
+}
+
+// ── 점프 테이블 디스패처 ──────────────────────────────────────────────
+
+enum class DispatchResult { Handled, Unknown, Malformed };
+
+template <typename Handler, typename List> class Dispatcher;
+
+/**
+ * Handler는 목록의 각 Msg에 대해 handle(const Msg &)를 제공해야 한다.
+ * 테이블은 컴파일 타임에 만들어지며 MsgType 슬롯 충돌은 static_assert로 잡는다.
+ */
+template <typename Handler, typename... Msgs>
+class Dispatcher<Handler, MessageList<Msgs...>>
+{
+    static_assert((detail::MessageCheck<Msgs>::ok && ...), "");
+    static_assert((detail::slotEncodable(quint32(Msgs::kType)) && ...),
+                  "MsgType value does not fit the dispatcher slot scheme");
+    static_assert(detail::slotsUnique<Msgs...>(), "two MsgTypes map to the same dispatcher slot");
+
+    using Thunk = bool (*)(Handler &, const FrameView &);
+    struct Entry {
+        quint32 type = 0;
+        Thunk   fn   = nullptr;
+    };
+    using Table = std::array<Entry, detail::kSlotCount>;
+
+    template <typename Msg>
+    static bool thunk(Handler &handler, const FrameView &frame)
+    {
+        Msg msg;
+        if (!decode(frame, msg))
+            return false;
+        handler.handle(msg);
+        return true;
+    }
+
+    static constexpr Table buildTable()
+    {
+        Table table{};
+        ((table[detail::slotOf(quint32(Msgs::kType))] =
+              Entry{ quint32(Msgs::kType), &thunk<Msgs> }), ...);
+        return table;
+    }
+
+    static constexpr Table kTable = buildTable();
+
+public:
+    static DispatchResult dispatch(Handler &handler, const FrameView &frame)
+    {
+        const quint32 raw = static_cast<quint32>(frame.type);
+        if (!detail::slotEncodable(raw))
+            return DispatchResult::Unknown;
+        const Entry &entry = kTable[detail::slotOf(raw)];
+        if (!entry.fn || entry.type != raw)
+            return DispatchResult::Unknown;
+        return entry.fn(handler, frame) ? DispatchResult::Handled : DispatchResult::Malformed;
+    }
+};
+
+// ── 가변 길이 / 레거시 API ────────────────────────────────────────────
+
+/**
+ * 프레임 하나를 QByteArray로 인코딩 (가변 길이 payload용).
+ * stamp가 있으면 확장 헤더를 붙인다.
+ */
+QByteArray encodeFrame(MsgType type, const QByteArray &payload = {},
+                       const FrameStamp *stamp = nullptr);
+
+/**
+ * 프레임 정확히 하나가 담긴 연속 버퍼(SOCK_SEQPACKET 데이터그램) → FrameView (복사 없음).
+ * length 필드와 size가 맞지 않거나 확장 헤더가 잘렸으면 false.
+ */
+bool parseFrame(const char *data, int size, FrameView &out);
 
 /**
- * 수신 버퍼에서 완성된 프레임 하나를 파싱.
+ * 수신 버퍼에서 완성된 프레임 하나를 파싱 (확장 헤더는 건너뛴다).
  * @return 완성 프레임이 있으면 true; bytesConsumed에 소비한 바이트 수 반환
  */
 bool decodeFrame(const QByteArray &buf,
@@ -0,0 +1,129 @@
+/**
+ * @file TimerWheel.h
+ * @brief 고정 용량 hashed timer wheel — id(0..Capacity-1)마다 deadline 하나, 할당 없음
+ *
+ * 타이머를 id마다 따로 두지 않고 주기 tick 하나로 모든 deadline을 검사한다.
+ *   schedule(id, deadlineNs) : deadline이 속한 tick의 slot 리스트에 넣는다 (기존 deadline은 대체)
+ *   advance(nowNs, fn)       : 마지막 advance 이후 지난 tick의 slot만 훑어 만료된 id마다 fn(id)
+ * slot은 tick % Slots — horizon(tick × Slots)보다 먼 deadline은 같은 slot에 남아 있다가 해당 round에 만료된다.
+ * deadline은 ns 단위 아무 시계나 되지만 schedule / advance가 같은 시계를 써야 한다.
+ * 스레드 안전하지 않다 — 한 스레드(GUI 타이머 또는 RT 리더 루프)에서만 쓴다.
+ */
+
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <QtGlobal>
+
+#include <array>
+
+namespace HuProtocol {
+
+template <int Capacity, int Slots>
+class TimerWheel
+{
+    static_assert(Capacity > 0 && Slots > 0, "TimerWheel needs at least one id and one slot");
+
+public:
+    explicit TimerWheel(quint64 tickNs) : m_tickNs(tickNs ? tickNs : 1) { clear(); }
+
+    void clear()
+    {
+        m_heads.fill(-1);
+        for (Entry &e : m_entries)
+            e = Entry();
+        m_currentTick = 0;   // 첫 advance는 모든 slot을 본다
+        m_scheduled = 0;
+    }
+
+    void schedule(int id, quint64 deadlineNs)
+    {
+        if (id < 0 || id >= Capacity)
+            return;
+        unlink(id);
+
+        const quint64 tick = deadlineNs / m_tickNs;
+        // 이미 지난 tick이면 현재 tick에 — 다음 advance에서 바로 만료
+        const int slot = static_cast<int>((tick < m_currentTick ? m_currentTick : tick) % Slots);
+        Entry &e = m_entries[id];
+        e.deadlineNs = deadlineNs;
+        e.slot = slot;
+        e.prev = -1;
+        e.next = m_heads[slot];
+        if (e.next >= 0)
+            m_entries[e.next].prev = id;
+        m_heads[slot] = id;
+        ++m_scheduled;
+    }
+
+    void cancel(int id)
+    {
+        if (id >= 0 && id < Capacity)
+            unlink(id);
+    }
+
+    bool isScheduled(int id) const { return id >= 0 && id < Capacity && m_entries[id].slot >= 0; }
+    quint64 deadlineNs(int id) const { return isScheduled(id) ? m_entries[id].deadlineNs : 0; }
+    int scheduledCount() const { return m_scheduled; }
+
+    /** nowNs까지 만료된 id마다 fn(id) — fn 안에서는 그 id만 다시 schedule할 수 있다. 만료 개수 반환 */
+    template <typename Fn>
+    int advance(quint64 nowNs, Fn &&fn)
+    {
+        const quint64 nowTick = nowNs / m_tickNs;
+        // 한 바퀴 이상 지났거나 시계가 뒤로 갔으면 모든 slot을 한 번씩만 본다
+        // (만료 판정은 deadline <= nowNs 비교라 어느 쪽이든 안전)
+        const quint64 span = nowTick < m_currentTick ? quint64(Slots) : nowTick - m_currentTick + 1;
+        const int slots = span >= quint64(Slots) ? Slots : static_cast<int>(span);
+        int fired = 0;
+        for (int i = 0; i < slots; ++i) {
+            const int slot = static_cast<int>((m_currentTick + quint64(i)) % Slots);
+            int id = m_heads[slot];
+            while (id >= 0) {
+                const int next = m_entries[id].next;
+                if (m_entries[id].deadlineNs <= nowNs) {
+                    unlink(id);
+                    ++fired;
+                    fn(id);
+                }
+                id = next;
+            }
+        }
+        // 현재 tick은 다음 advance에서 다시 본다 (같은 tick 안의 더 늦은 deadline)
+        m_currentTick = nowTick;
+        return fired;
+    }
+
+private:
+    struct Entry {
+        quint64 deadlineNs = 0;
+        int prev = -1;
+        int next = -1;
+        int slot = -1;            // -1 = 예약 없음
+    };
+
+    void unlink(int id)
+    {
+        Entry &e = m_entries[id];
+        if (e.slot < 0)
+            return;
+        if (e.prev >= 0)
+            m_entries[e.prev].next = e.next;
+        else
+            m_heads[e.slot] = e.next;
+        if (e.next >= 0)
+            m_entries[e.next].prev = e.prev;
+        e = Entry();
+        --m_scheduled;
+    }
+
+    quint64 m_tickNs;
+    quint64 m_currentTick = 0;
+    int m_scheduled = 0;
+    std::array<int, Slots> m_heads{};
+    std::array<Entry, Capacity> m_entries{};
+};
+
+} // namespace HuProtocol
+
+#endif // TIMERWHEEL_H
@@ -0,0 +1,277 @@
+/**
+ * @file VehicleStateBlock.cpp
+ */
+
+#include "VehicleStateBlock.h"
+
+#include <QByteArray>
+#include <QDebug>
+
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace HuProtocol {
+
+/**
+ * shm 세그먼트 레이아웃. 모든 필드는 프로세스 간 공유되므로 lock-free atomic만 사용한다.
+ * 값 필드는 seqlock(seq) 안에서 relaxed로 읽고/쓴다.
+ */
+struct VehicleStateBlock::Layout {
+    std::atomic<quint32> magic;
+    std::atomic<quint32> version;
+    std::atomic<quint32> seq;          // seqlock — 홀수면 기록 중
+    std::atomic<quint32> change;       // futex word — 기록마다 +1
+    std::atomic<quint32> speedBits;    // float km/h
+    std::atomic<quint32> voltageBits;  // float V
+    std::atomic<quint32> percentBits;  // float %
+    std::atomic<quint32> flags;        // [7:0] gear, [8] ipc connected
+};
+
+namespace {
+constexpr quint32 kMagic   = 0x48555653; // 'HUVS'
+constexpr quint32 kVersion = 1;
+constexpr quint32 kIpcConnectedBit = 1u << 8;
+constexpr int     kMaxReadRetries  = 1024;
+
+static_assert(std::atomic<quint32>::is_always_lock_free,
+              "shared-memory seqlock requires lock-free 32-bit atomics");
+
+quint32 floatBits(float value)
+{
+    quint32 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+float bitsFloat(quint32 bits)
+{
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+quint32 *futexWord(const std::atomic<quint32> &word)
+{
+    return reinterpret_cast<quint32 *>(const_cast<std::atomic<quint32> *>(&word));
+}
+} // namespace
+
+VehicleStateBlock::~VehicleStateBlock()
+{
+    close();
+}
+
+// ── Shell (writer) ────────────────────────────────────────────────────
+
+bool VehicleStateBlock::create(const QString &name)
+{
+    close();
+    const QByteArray shmName = name.toLocal8Bit();
+
+    // 이전 shell이 남긴 세그먼트는 버리고 새로 만든다 — 기존 reader는 재연결 시 다시 open()
+    ::shm_unlink(shmName.constData());
+    m_fd = ::shm_open(shmName.constData(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (m_fd < 0) {
+        qWarning() << "[VehicleState] shm_open(create) failed for" << name << ":" << std::strerror(errno);
+        return false;
+    }
+    if (::ftruncate(m_fd, sizeof(Layout)) < 0) {
+        qWarning() << "[VehicleState] ftruncate failed:" << std::strerror(errno);
+        ::close(m_fd);
+        m_fd = -1;
+        ::shm_unlink(shmName.constData());
+        return false;
+    }
+
+    void *mem = ::mmap(nullptr, sizeof(Layout), PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (mem == MAP_FAILED) {
+        qWarning() << "[VehicleState] mmap failed:" << std::strerror(errno);
+        ::close(m_fd);
+        m_fd = -1;
+        ::shm_unlink(shmName.constData());
+        return false;
+    }
+
+    m_layout = new (mem) Layout{};
+    m_layout->version.store(kVersion, std::memory_order_relaxed);
+    m_layout->magic.store(kMagic, std::memory_order_release);
+    m_owner = true;
+    m_name  = name;
+    qDebug() << "[VehicleState] shared state block created:" << name;
+    return true;
+}
+
+template <typename Fn>
+void VehicleStateBlock::write(Fn &&fn)
+{
+    Layout &l = *m_layout;
+    const quint32 s = l.seq.load(std::memory_order_relaxed);
+    l.seq.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    fn(l);
+
+    l.seq.store(s + 2, std::memory_order_release);
+    l.change.fetch_add(1, std::memory_order_release);
+    ::syscall(SYS_futex, futexWord(l.change), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+void VehicleStateBlock::setSpeed(float kmh)
+{
+    if (!m_owner) return;
+    const quint32 bits = floatBits(kmh);
+    if (m_layout->speedBits.load(std::memory_order_relaxed) == bits) return;
+    write([bits](Layout &l) {
+        l.speedBits.store(bits, std::memory_order_relaxed);
+    });
+}
+
+void VehicleStateBlock::setBattery(float voltage, float percent)
+{
+    if (!m_owner) return;
+    const quint32 v = floatBits(voltage);
+    const quint32 p = floatBits(percent);
+    if (m_layout->voltageBits.load(std::memory_order_relaxed) == v &&
+        m_layout->percentBits.load(std::memory_order_relaxed) == p) return;
+    write([v, p](Layout &l) {
+        l.voltageBits.store(v, std::memory_order_relaxed);
+        l.percentBits.store(p, std::memory_order_relaxed);
+    });
+}
+
+void VehicleStateBlock::setGear(quint8 gear)
+{
+    if (!m_owner) return;
+    const quint32 old   = m_layout->flags.load(std::memory_order_relaxed);
+    const quint32 flags = (old & ~0xFFu) | gear;
+    if (flags == old) return;
+    write([flags](Layout &l) {
+        l.flags.store(flags, std::memory_order_relaxed);
+    });
+}
+
+void VehicleStateBlock::setIpcStatus(bool connected)
+{
+    if (!m_owner) return;
+    const quint32 old   = m_layout->flags.load(std::memory_order_relaxed);
+    const quint32 flags = connected ? (old | kIpcConnectedBit) : (old & ~kIpcConnectedBit);
+    if (flags == old) return;
+    write([flags](Layout &l) {
+        l.flags.store(flags, std::memory_order_relaxed);
+    });
+}
+
+// ── Module (reader) ───────────────────────────────────────────────────
+
+bool VehicleStateBlock::open(const QString &name)
+{
+    close();
+    const QByteArray shmName = name.toLocal8Bit();
+
+    m_fd = ::shm_open(shmName.constData(), O_RDONLY, 0);
+    if (m_fd < 0)
+        return false;
+
+    struct stat st;
+    if (::fstat(m_fd, &st) < 0 || st.st_size < static_cast<off_t>(sizeof(Layout))) {
+        close();
+        return false;
+    }
+
+    void *mem = ::mmap(nullptr, sizeof(Layout), PROT_READ, MAP_SHARED, m_fd, 0);
+    if (mem == MAP_FAILED) {
+        close();
+        return false;
+    }
+    m_layout = static_cast<Layout *>(mem);
+
+    if (m_layout->magic.load(std::memory_order_acquire) != kMagic ||
+        m_layout->version.load(std::memory_order_relaxed) != kVersion) {
+        qWarning() << "[VehicleState] incompatible shared state block:" << name;
+        close();
+        return false;
+    }
+    m_name = name;
+    return true;
+}
+
+bool VehicleStateBlock::snapshot(VehicleStateSnapshot &out) const
+{
+    if (!m_layout) return false;
+
+    const Layout &l = *m_layout;
+    for (int attempt = 0; attempt < kMaxReadRetries; ++attempt) {
+        const quint32 s1 = l.seq.load(std::memory_order_acquire);
+        if (s1 & 1u) {
+            std::this_thread::yield();
+            continue;
+        }
+        const quint32 speed   = l.speedBits.load(std::memory_order_relaxed);
+        const quint32 voltage = l.voltageBits.load(std::memory_order_relaxed);
+        const quint32 percent = l.percentBits.load(std::memory_order_relaxed);
+        const quint32 flags   = l.flags.load(std::memory_order_relaxed);
+        const quint32 change  = l.change.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (l.seq.load(std::memory_order_relaxed) != s1)
+            continue;
+
+        out.speedKmh       = bitsFloat(speed);
+        out.batteryVoltage = bitsFloat(voltage);
+        out.batteryPercent = bitsFloat(percent);
+        out.gear           = static_cast<quint8>(flags & 0xFFu);
+        out.ipcConnected   = (flags & kIpcConnectedBit) != 0;
+        out.changeCount    = change;
+        return true;
+    }
+    qWarning() << "[VehicleState] no consistent snapshot after" << kMaxReadRetries << "reads; skipping";
+    return false;
+}
+
+quint32 VehicleStateBlock::changeCount() const
+{
+    return m_layout ? m_layout->change.load(std::memory_order_acquire) : 0;
+}
+
+bool VehicleStateBlock::waitForChange(quint32 lastSeen, int timeoutMs) const
+{
+    if (!m_layout) return false;
+    if (m_layout->change.load(std::memory_order_acquire) != lastSeen)
+        return true;
+
+    struct timespec timeout;
+    timeout.tv_sec  = timeoutMs / 1000;
+    timeout.tv_nsec = static_cast<long>(timeoutMs % 1000) * 1000000L;
+    // 공유 매핑이므로 FUTEX_PRIVATE_FLAG 없이 대기
+    ::syscall(SYS_futex, futexWord(m_layout->change), FUTEX_WAIT, lastSeen, &timeout, nullptr, 0);
+    return m_layout->change.load(std::memory_order_acquire) != lastSeen;
+}
+
+void VehicleStateBlock::close()
+{
+    if (m_layout) {
+        ::munmap(m_layout, sizeof(Layout));
+        m_layout = nullptr;
+    }
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+    if (m_owner && !m_name.isEmpty())
+        ::shm_unlink(m_name.toLocal8Bit().constData());
+    m_owner = false;
+    m_name.clear();
+}
+
+} // namespace HuProtocol
@@ -0,0 +1,86 @@
+/**
+ * @file VehicleStateBlock.h
+ * @brief Shell ↔ Module 공유 메모리 차량 상태 블록 (seqlock + futex)
+ *
+ * 속도/배터리/IPC 상태/기어처럼 연속적으로 갱신되는 값은 프레임으로 6개 소켓에
+ * 매번 쓰지 않고, shell이 소유한 POSIX shm 세그먼트 하나에 기록한다.
+ *
+ *   Shell  : create() 후 setSpeed()/setBattery()/... — 값이 바뀔 때만 기록 + FUTEX_WAKE
+ *   Module : open() 후 snapshot(out) — 시스템콜 없는 seqlock 읽기 (일관된 값을 못 읽으면 false)
+ *            waitForChange() — 변경 시에만 깨어나는 futex 대기 (워커 스레드용)
+ *
+ * 쓰기는 shell GUI 스레드 하나에서만 한다 (single writer).
+ */
+
+#ifndef VEHICLESTATEBLOCK_H
+#define VEHICLESTATEBLOCK_H
+
+#include <QtGlobal>
+#include <QString>
+
+namespace HuProtocol {
+
+/** 모듈이 읽는 최신 차량 상태 (POD 스냅샷) */
+struct VehicleStateSnapshot {
+    float   speedKmh       = 0.0f;
+    float   batteryVoltage = 0.0f;
+    float   batteryPercent = 0.0f;
+    quint8  gear           = 0;      // GearState enum 값
+    bool    ipcConnected   = false;
+    quint32 changeCount    = 0;      // 기록될 때마다 증가
+};
+
+class VehicleStateBlock
+{
+public:
+    VehicleStateBlock() = default;
+    ~VehicleStateBlock();
+
+    VehicleStateBlock(const VehicleStateBlock &) = delete;
+    VehicleStateBlock &operator=(const VehicleStateBlock &) = delete;
+
+    static QString defaultName() { return QStringLiteral("/hu_vehicle_state"); }
+
+    // ── Shell (writer) ───────────────────────────────
+    bool create(const QString &name = defaultName());
+    void setSpeed(float kmh);
+    void setBattery(float voltage, float percent);
+    void setGear(quint8 gear);
+    void setIpcStatus(bool connected);
+
+    // ── Module (reader) ──────────────────────────────
+    bool open(const QString &name = defaultName());
+    /**
+     * 일관된 스냅샷을 out에 읽는다. 재시도 한도 안에 읽지 못하면(기록이 계속되거나 writer가 기록 중 죽음)
+     * out은 건드리지 않고 false — 호출자는 이번 갱신을 건너뛴다 (0으로 채운 값을 내보내지 않는다)
+     */
+    bool snapshot(VehicleStateSnapshot &out) const;
+
+    /** 현재 changeCount 값 (waitForChange 기준값) */
+    quint32 changeCount() const;
+
+    /**
+     * changeCount가 lastSeen과 달라질 때까지 최대 timeoutMs 동안 잠든다.
+     * @return 변경이 있으면 true, 타임아웃/블록 없음이면 false
+     */
+    bool waitForChange(quint32 lastSeen, int timeoutMs) const;
+
+    bool isValid() const { return m_layout != nullptr; }
+    bool isOwner() const { return m_owner; }
+    void close();
+
+private:
+    struct Layout;
+
+    template <typename Fn>
+    void write(Fn &&fn);
+
+    Layout  *m_layout = nullptr;
+    int      m_fd     = -1;
+    bool     m_owner  = false;
+    QString  m_name;
+};
+
+} // namespace HuProtocol
+
+#endif // VEHICLESTATEBLOCK_H
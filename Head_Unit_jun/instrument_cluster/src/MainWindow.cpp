@@ -545,6 +545,7 @@ void MainWindow::animateCenterMode(const QString &newMode)
 void MainWindow::onVSomeIPGearReceived(const QString &gear)
 {
     setGearFromIPC(gear);
+    m_vsomeipGear->setGearEcho(gear);
 }
 #endif
 
@@ -632,10 +633,12 @@ void MainWindow::onSpeedDataReceived(float pulsePerSec)
     m_rpmGauge->setRPM(rpm);
     updateDirectionIndicators();
 
-    // Forward speed to Head Unit via vsomeip
+#ifdef IC_HAS_VSOMEIP
+    // Forward speed to Head Unit via vsomeip (0x8004 cycle)
     if (m_vsomeipGear) {
-        m_vsomeipGear->sendSpeed(speedKmh);
+        m_vsomeipGear->setSpeed(speedKmh);
     }
+#endif
     
     // Update max speed
     if (speedKmh > m_maxSpeed) {
@@ -689,6 +692,11 @@ void MainWindow::onPythonDataReceived()
         float voltage = battery["voltage"].toDouble();
         float percent = battery["percent"].toDouble();
         m_batteryWidget->setBattery(percent, voltage);
+#ifdef IC_HAS_VSOMEIP
+        if (m_vsomeipGear && battery.contains("voltage")) {
+            m_vsomeipGear->setBattery(voltage, percent);
+        }
+#endif
 
         // Direction is controlled by the local drive-mode snapshot (X/B/Y).
         // Ignore bridge direction to avoid parking flicker during driving.
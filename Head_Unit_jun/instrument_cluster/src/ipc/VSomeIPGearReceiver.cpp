@@ -6,12 +6,14 @@
  */
 
 #include "VSomeIPGearReceiver.h"
+#include "GearRequest.h"
 #include <QDebug>
+#include <QMetaObject>
 
-#ifdef IC_HAS_VSOMEIP
 #include <cstring>
+
+#ifdef IC_HAS_VSOMEIP
 #include <set>
-#include <vector>
 
 namespace {
 constexpr vsomeip::service_t kServiceId = 0x1234;
@@ -23,11 +25,17 @@ constexpr vsomeip::method_t kGearMethodId = 0x8002;
 VSomeIPGearReceiver::VSomeIPGearReceiver(QObject *parent)
     : QObject(parent)
 {
+    m_cycle.setTimerType(Qt::PreciseTimer);
+    m_cycle.setInterval(VehicleStateEvent::kCycleMs);
+    connect(&m_cycle, &QTimer::timeout, this, &VSomeIPGearReceiver::publishState);
+
 #ifdef IC_HAS_VSOMEIP
     m_app = vsomeip::runtime::get()->create_application("InstrumentCluster");
     if (!m_app) {
         return;
     }
+    m_statePayload = vsomeip::runtime::get()->create_payload();
+    m_speedPayload = vsomeip::runtime::get()->create_payload();
     m_app->register_state_handler([this](vsomeip::state_type_e state) {
         onState(state);
     });
@@ -43,6 +51,7 @@ VSomeIPGearReceiver::VSomeIPGearReceiver(QObject *parent)
         }
         m_app->start();
     });
+    m_cycle.start();
 #endif
 }
 
@@ -59,6 +68,66 @@ VSomeIPGearReceiver::~VSomeIPGearReceiver()
 #endif
 }
 
+// ── Vehicle state publish (0x8004) ────────────────────────────────────
+
+void VSomeIPGearReceiver::setSpeed(float kmh)
+{
+    m_state.speedKmh = kmh;
+    m_state.flags |= VehicleStateEvent::FlagSpeedValid;
+    m_speedAt = Clock::now();
+}
+
+void VSomeIPGearReceiver::setBattery(float voltage, float percent)
+{
+    m_state.batteryVoltage = voltage;
+    m_state.batteryPercent = percent;
+    m_state.flags |= VehicleStateEvent::FlagBatteryValid;
+    m_batteryAt = Clock::now();
+}
+
+void VSomeIPGearReceiver::setGearEcho(const QString &gear)
+{
+    static const char kGears[] = "PRND";
+    const char *p = gear.isEmpty() ? nullptr : std::strchr(kGears, gear.at(0).toUpper().toLatin1());
+    m_state.gearEcho = (p && *p) ? static_cast<std::uint8_t>(p - kGears)
+                                 : VehicleStateEvent::kGearUnknown;
+}
+
+void VSomeIPGearReceiver::publishState()
+{
+#ifdef IC_HAS_VSOMEIP
+    if (!m_app || !m_registered.load()) {
+        return;
+    }
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    const Clock::time_point now = Clock::now();
+
+    ++m_state.sequence;
+    m_state.publishTimeUs = static_cast<std::uint64_t>(
+        duration_cast<microseconds>(now.time_since_epoch()).count());
+    m_state.speedAgeMs = m_state.hasSpeed()
+        ? VehicleStateEvent::ageField(duration_cast<microseconds>(now - m_speedAt).count())
+        : 0xFFFF;
+    m_state.batteryAgeMs = m_state.hasBattery()
+        ? VehicleStateEvent::ageField(duration_cast<microseconds>(now - m_batteryAt).count())
+        : 0xFFFF;
+
+    // 고정 버퍼에 인코딩 → 재사용 payload에 복사 (용량이 같으므로 재할당 없음)
+    VehicleStateEvent::encode(m_state, m_stateBuf);
+    m_statePayload->set_data(m_stateBuf, VehicleStateEvent::kWireSize);
+    m_app->notify(kServiceId, kInstanceId, kStateEventId, m_statePayload);
+
+    // legacy 0x8001 — 0x8004를 모르는 Head Unit용
+    if (m_state.hasSpeed()) {
+        vsomeip::byte_t speed[4];
+        std::memcpy(speed, &m_state.speedKmh, sizeof(speed));
+        m_speedPayload->set_data(speed, sizeof(speed));
+        m_app->notify(kServiceId, kInstanceId, kSpeedEventId, m_speedPayload);
+    }
+#endif
+}
+
 #ifdef IC_HAS_VSOMEIP
 void VSomeIPGearReceiver::onState(vsomeip::state_type_e state)
 {
@@ -67,8 +136,10 @@ void VSomeIPGearReceiver::onState(vsomeip::state_type_e state)
     }
     if (state == vsomeip::state_type_e::ST_REGISTERED) {
         m_registered = true;
-        // Offer speed event so HU can subscribe
+        // Offer vehicle state + legacy speed events so HU can subscribe
         std::set<vsomeip::eventgroup_t> groups = {kSpeedEventGroupId};
+        m_app->offer_event(kServiceId, kInstanceId, kStateEventId, groups,
+                           vsomeip::event_type_e::ET_FIELD);
         m_app->offer_event(kServiceId, kInstanceId, kSpeedEventId, groups,
                            vsomeip::event_type_e::ET_FIELD);
         m_app->offer_service(kServiceId, kInstanceId);
@@ -77,38 +148,19 @@ void VSomeIPGearReceiver::onState(vsomeip::state_type_e state)
     m_registered = false;
 }
 
-void VSomeIPGearReceiver::sendSpeed(float kmh)
-{
-#ifdef IC_HAS_VSOMEIP
-    if (!m_app || !m_registered.load()) {
-        return;
-    }
-    auto payload = vsomeip::runtime::get()->create_payload();
-    std::vector<vsomeip::byte_t> data(4);
-    std::memcpy(data.data(), &kmh, 4);
-    payload->set_data(data);
-    m_app->notify(kServiceId, kInstanceId, kSpeedEventId, payload);
-#else
-    (void)kmh;
-#endif
-}
-
 void VSomeIPGearReceiver::onMessage(const std::shared_ptr<vsomeip::message> &msg)
 {
     if (!msg) {
         return;
     }
     const auto payload = msg->get_payload();
-    if (!payload || payload->get_length() < 1) {
-        return;
-    }
-    const unsigned char *data = payload->get_data();
-    if (!data) {
+    GearRequest::Payload req;
+    if (!payload || !GearRequest::decode(payload->get_data(), payload->get_length(), req)) {
         return;
     }
 
     QString gear = "P";
-    switch (data[0]) {
+    switch (req.gear) {
     case 0:
         gear = "P";
         break;
@@ -125,7 +177,28 @@ void VSomeIPGearReceiver::onMessage(const std::shared_ptr<vsomeip::message> &msg
         gear = "P";
         break;
     }
-    qDebug() << "[VSomeIP] gearReceived:" << gear;
-    emit gearReceived(gear);
+    qDebug() << "[VSomeIP] gearReceived:" << gear << "seq" << req.seq;
+
+    // GUI 스레드에서 반영(gearReceived → setGearEcho)한 뒤, 실제 반영된 기어로 응답
+    QMetaObject::invokeMethod(this, [this, msg, gear, seq = req.seq]() {
+        emit gearReceived(gear);
+        sendGearResponse(msg, seq);
+    }, Qt::QueuedConnection);
+}
+
+void VSomeIPGearReceiver::sendGearResponse(const std::shared_ptr<vsomeip::message> &request,
+                                           std::uint32_t seq)
+{
+    if (!m_app || request->get_message_type() != vsomeip::message_type_e::MT_REQUEST) {
+        return;
+    }
+    vsomeip::byte_t data[GearRequest::kWireSize];
+    GearRequest::encode({ m_state.gearEcho, seq }, data);
+    auto payload = vsomeip::runtime::get()->create_payload();
+    payload->set_data(data, sizeof(data));
+
+    auto response = vsomeip::runtime::get()->create_response(request);
+    response->set_payload(payload);
+    m_app->send(response);
 }
 #endif
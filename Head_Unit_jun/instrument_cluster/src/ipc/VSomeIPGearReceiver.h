@@ -2,6 +2,9 @@
  * @file VSomeIPGearReceiver.h
  * @brief VSOMEIP gear receiver for Instrument Cluster
  * Receives gear (P/R/N/D) from Head Unit via IPC
+ *   → 반영 후 applied gear + seq로 응답 (GearRequest.h, HU가 재전송/RTT 측정)
+ * Publishes 0x8004 vehicle state (speed/battery/gear echo) every kCycleMs
+ *   + legacy 0x8001 speed — 고정 주기, 미리 만든 payload 재사용 (notify당 할당 없음)
  * @author Ahn Hyunjun
  * @date 2026-02-26
  */
@@ -10,6 +13,11 @@
 #define VSOMEIPGEARRECEIVER_H
 
 #include <QObject>
+#include <QTimer>
+
+#include "VehicleStateEvent.h"
+
+#include <chrono>
 
 #ifdef IC_HAS_VSOMEIP
 #include <vsomeip/vsomeip.hpp>
@@ -27,22 +35,39 @@ public:
     explicit VSomeIPGearReceiver(QObject *parent = nullptr);
     ~VSomeIPGearReceiver() override;
 
-    void sendSpeed(float kmh);
+    // 최신 값만 기록 — 실제 전송은 kCycleMs 타이머에서 (GUI 스레드에서 호출)
+    void setSpeed(float kmh);
+    void setBattery(float voltage, float percent);
+    void setGearEcho(const QString &gear);
 
 signals:
     void gearReceived(const QString &gear);
 
 private:
+    using Clock = std::chrono::steady_clock;
+
+    void publishState();
+
+    QTimer                   m_cycle;
+    VehicleStateEvent::State m_state;
+    Clock::time_point        m_speedAt;
+    Clock::time_point        m_batteryAt;
+    std::uint8_t             m_stateBuf[VehicleStateEvent::kWireSize] = {};
+
 #ifdef IC_HAS_VSOMEIP
     void onState(vsomeip::state_type_e state);
     void onMessage(const std::shared_ptr<vsomeip::message> &msg);
+    void sendGearResponse(const std::shared_ptr<vsomeip::message> &request, std::uint32_t seq);
 
     std::shared_ptr<vsomeip::application> m_app;
     std::thread m_worker;
     std::atomic<bool> m_running{false};
     std::atomic<bool> m_registered{false};
+    std::shared_ptr<vsomeip::payload> m_statePayload;   // 생성자에서 한 번 만들고 재사용
+    std::shared_ptr<vsomeip::payload> m_speedPayload;
 
     static constexpr vsomeip::event_t       kSpeedEventId      = 0x8001;
+    static constexpr vsomeip::event_t       kStateEventId      = VehicleStateEvent::kEventId;
     static constexpr vsomeip::eventgroup_t  kSpeedEventGroupId = 0x0001;
 #endif
 };
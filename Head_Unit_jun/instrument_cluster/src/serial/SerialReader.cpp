@@ -7,18 +7,9 @@
 
 #include "SerialReader.h"
 #include <QDebug>
-#include <cstring>
-
-#include <sys/socket.h>
-#include <sys/ioctl.h>
-#include <unistd.h>
-#include <net/if.h>
-#include <linux/can.h>
-#include <linux/can/raw.h>
 
 SerialReader::SerialReader(QObject *parent)
     : QObject(parent)
-    , m_canSocket(-1)
     , m_canNotifier(nullptr)
     , m_reconnectTimer(nullptr)
     , m_isConnected(false)
@@ -54,32 +45,14 @@ bool SerialReader::connectToCan()
 {
     closeCan();
 
-    m_canSocket = ::socket(PF_CAN, SOCK_RAW, CAN_RAW);
-    if (m_canSocket < 0) {
-        qWarning() << "Failed to create CAN socket";
-        return false;
-    }
-
-    struct ifreq ifr;
-    std::memset(&ifr, 0, sizeof(ifr));
-    std::strncpy(ifr.ifr_name, "can0", IFNAMSIZ - 1);
-    if (::ioctl(m_canSocket, SIOCGIFINDEX, &ifr) < 0) {
-        qWarning() << "Failed to resolve can0 interface index";
-        closeCan();
+    QString error;
+    // 속도 프레임만 커널에서 통과시킨다 (PDC 0x350/0x351 등으로 깨지 않음)
+    if (!m_can.open(QStringLiteral("can0"), { SPEED_CAN_ID }, CanBatchReader::kDefaultErrorMask, &error)) {
+        qWarning() << error;
         return false;
     }
 
-    struct sockaddr_can addr;
-    std::memset(&addr, 0, sizeof(addr));
-    addr.can_family = AF_CAN;
-    addr.can_ifindex = ifr.ifr_ifindex;
-    if (::bind(m_canSocket, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0) {
-        qWarning() << "Failed to bind CAN socket to can0";
-        closeCan();
-        return false;
-    }
-
-    m_canNotifier = new QSocketNotifier(m_canSocket, QSocketNotifier::Read, this);
+    m_canNotifier = new QSocketNotifier(m_can.fd(), QSocketNotifier::Read, this);
     connect(m_canNotifier, &QSocketNotifier::activated, this, &SerialReader::onCanReadyRead);
 
     m_isConnected = true;
@@ -91,38 +64,53 @@ bool SerialReader::connectToCan()
 
 void SerialReader::closeCan()
 {
+    if (m_can.isOpen()) {
+        const CanBatchReader::Stats &st = m_can.stats();
+        qDebug() << "CAN frames received" << st.frames << "used" << st.used
+                 << "errors" << st.errorFrames;
+    }
     if (m_canNotifier) {
         m_canNotifier->setEnabled(false);
         m_canNotifier->deleteLater();
         m_canNotifier = nullptr;
     }
-    if (m_canSocket >= 0) {
-        ::close(m_canSocket);
-        m_canSocket = -1;
-    }
+    m_can.close();
     m_isConnected = false;
 }
 
 void SerialReader::onCanReadyRead()
 {
-    if (m_canSocket < 0) {
+    if (!m_can.isOpen()) {
         return;
     }
 
-    struct can_frame frame;
-    const ssize_t n = ::read(m_canSocket, &frame, sizeof(frame));
-    if (n < static_cast<ssize_t>(sizeof(struct can_frame))) {
+    // 밀린 프레임을 한 번에 읽고 마지막 속도 프레임만 emit
+    float speedKmh = -1.0f;
+    const int n = m_can.drain([&](const CanBatchReader::Frame &rx) {
+        const quint32 canId = static_cast<quint32>(rx.frame.can_id & CAN_EFF_MASK);
+        if (canId != SPEED_CAN_ID || rx.frame.can_dlc < CanSignals::requiredDlc(CanSignals::kSpeedKmh)) {
+            return false;
+        }
+        speedKmh = CanSignals::decode<CanSignals::kSpeedKmh>(rx.frame.data);
+        m_lastSpeedRxNs = rx.rxRealtimeNs;
+        return true;
+    });
+    if (n < 0) {
+        // 인터페이스가 내려갔다 — 재연결 루프로
+        qWarning() << "CAN read error on can0, reconnecting...";
+        closeCan();
+        emit connectionStatusChanged(false);
+        m_reconnectTimer->start(2000);
         return;
     }
-
-    const quint32 canId = static_cast<quint32>(frame.can_id & CAN_EFF_MASK);
-    if (canId != SPEED_CAN_ID || frame.can_dlc < 1) {
+    if (const can_err_mask_t errors = m_can.takeErrors()) {
+        qWarning() << "CAN error frame on can0, class" << QStringLiteral("0x%1").arg(errors, 0, 16);
+    }
+    if (speedKmh < 0.0f) {
         return;
     }
 
-    // candump 기준: can0 123 [8] 11 00 00 ...
-    // 첫 바이트를 km/h 속도로 사용
-    const float speedKmh = static_cast<float>(frame.data[0]);
+    // candump 기준: can0 123 [8] 11 00 00 ... — 첫 바이트가 km/h (CanSignals::kSpeedKmh)
     emit speedDataReceived(speedKmh);
 }
 
@@ -12,13 +12,16 @@
 #include <QTimer>
 #include <QSocketNotifier>
 
+#include "CanBatchReader.h"
+#include "CanSignals.h"
+
 /**
  * @class SerialReader
  * @brief Reads speed data from can0 (SocketCAN)
  * 
  * Features:
- * - Read raw CAN frames from can0
- * - Parse speed data from CAN ID 0x123
+ * - Read raw CAN frames from can0 (CanBatchReader: recvmmsg batch + kernel timestamps)
+ * - Parse speed data from CAN ID 0x123 (latest frame per wakeup)
  * - Auto-reconnection on disconnect
  */
 class SerialReader : public QObject
@@ -31,6 +34,10 @@ public:
     
     bool isConnected() const;
     QString currentPort() const;  // kept for compatibility, returns "can0" when connected
+
+    /** 마지막 속도 프레임의 커널 수신 시각 (CLOCK_REALTIME ns), 0 = 아직 없음 */
+    quint64 lastSpeedRxNs() const { return m_lastSpeedRxNs; }
+    const CanBatchReader::Stats &canStats() const { return m_can.stats(); }
     
 signals:
     void speedDataReceived(float pulsePerSec);
@@ -44,12 +51,13 @@ private:
     bool connectToCan();
     void closeCan();
     
-    static constexpr quint32 SPEED_CAN_ID = 0x123;
+    static constexpr quint32 SPEED_CAN_ID = CanSignals::kSpeedKmh.canId;
 
-    int m_canSocket;
+    CanBatchReader m_can;
     QSocketNotifier *m_canNotifier;
     QTimer *m_reconnectTimer;
     bool m_isConnected;
+    quint64 m_lastSpeedRxNs = 0;
 };
 
 #endif // SERIALREADER_H
@@ -27,17 +27,19 @@ int main(int argc, char *argv[])
     window->setWindowFlags(Qt::FramelessWindowHint | Qt::Window);
     window->setWindowTitle("settings"); // HUCompositor 식별자
 
+    QObject::connect(window, &SettingsScreen::speedUnitChanged, service, [service](bool metric) {
+        service->setSpeedUnit(metric ? HuProtocol::SpeedUnit::Kmh : HuProtocol::SpeedUnit::Mph);
+    });
+
     if (standalone) {
         window->showFullScreen();
         qDebug() << "[hu_module_settings] standalone mode";
     } else {
         auto *bridge = new ShellClient(socketPath, &app);
 
-        // 설정 변경 → shell 전달
-        QObject::connect(service, &SettingsService::settingChanged,
-                         bridge, [bridge](const QString &key, const QVariant &val) {
-            bridge->sendSettingsChanged({{key, val}});
-        });
+        // 설정 변경 → shell 전달 (이벤트 루프 1회당 SettingsDelta 프레임 1개로 묶임)
+        QObject::connect(service, &SettingsService::settingsChanged,
+                         bridge, &ShellClient::sendSettings);
         QObject::connect(bridge, &ShellClient::gearStateUpdated,
                          gearManager, [gearManager](GearState g) {
             gearManager->setGear(g, "shell");
@@ -3,17 +3,14 @@
 SettingsService::SettingsService(QObject *parent)
     : QObject(parent)
 {
-    m_settings["speedUnit"] = "km/h";
 }
 
-QString SettingsService::speedUnit() const
+void SettingsService::setSpeedUnit(HuProtocol::SpeedUnit unit)
 {
-    return m_settings.value("speedUnit", "km/h").toString();
-}
+    if (m_speedUnit == unit) return;
+    m_speedUnit = unit;
 
-void SettingsService::setSpeedUnit(const QString &unit)
-{
-    if (m_settings.value("speedUnit") == unit) return;
-    m_settings["speedUnit"] = unit;
-    emit settingChanged("speedUnit", unit);
+    HuProtocol::SettingsDelta delta;
+    delta.setSpeedUnit(unit);
+    emit settingsChanged(delta);
 }
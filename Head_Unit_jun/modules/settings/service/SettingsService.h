@@ -1,12 +1,13 @@
 /**
  * @file SettingsService.h
- * @brief Settings 모듈 서비스 레이어 — QSettings 기반 설정 관리
+ * @brief Settings 모듈 서비스 레이어 — 타입이 정해진 설정 값 관리 (SettingsRegistry 키)
  */
 #ifndef SETTINGSSERVICE_H
 #define SETTINGSSERVICE_H
 
+#include "SettingsRegistry.h"
+
 #include <QObject>
-#include <QVariantMap>
 
 class SettingsService : public QObject
 {
@@ -14,13 +15,14 @@ class SettingsService : public QObject
 public:
     explicit SettingsService(QObject *parent = nullptr);
 
-    QString speedUnit() const;
-    void setSpeedUnit(const QString &unit);
+    HuProtocol::SpeedUnit speedUnit() const { return m_speedUnit; }
+    void setSpeedUnit(HuProtocol::SpeedUnit unit);
 
 signals:
-    void settingChanged(const QString &key, const QVariant &value);
+    /** 바뀐 설정만 담은 delta — ShellClient::sendSettings()로 그대로 전달 */
+    void settingsChanged(const HuProtocol::SettingsDelta &delta);
 
 private:
-    QVariantMap m_settings;
+    HuProtocol::SpeedUnit m_speedUnit = HuProtocol::SpeedUnit::Kmh;
 };
 #endif // SETTINGSSERVICE_H
@@ -11,14 +11,22 @@ ModuleBridge::ModuleBridge(const QString &socketPath, QObject *parent)
     , m_socketPath(socketPath)
     , m_server(new QLocalServer(this))
 {
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(HIDDEN_FLUSH_MS);
+    connect(&m_flushTimer, &QTimer::timeout, this, &ModuleBridge::flushPending);
+
+    m_slowTimer.setSingleShot(true);
+    m_slowTimer.setInterval(SLOW_CONSUMER_MS);
+    connect(&m_slowTimer, &QTimer::timeout, this, &ModuleBridge::onSlowConsumerTimeout);
 }
 
 ModuleBridge::~ModuleBridge()
 {
+    logStats("shutdown");
     QLocalServer::removeServer(m_socketPath);
 }
 
-bool ModuleBridge::listen()
+bool ModuleBridge::listen(HuProtocol::Transport transport)
 {
     QLocalServer::removeServer(m_socketPath); // 이전 소켓 파일 정리
     if (!m_server->listen(m_socketPath)) {
@@ -28,148 +36,507 @@ bool ModuleBridge::listen()
     }
     connect(m_server, &QLocalServer::newConnection, this, &ModuleBridge::onNewConnection);
     qDebug() << "[ModuleBridge] listening on" << m_socketPath;
+
+    if (transport == HuProtocol::Transport::SeqPacket) {
+        m_packetServer = new HuProtocol::SeqPacketServer(this);
+        const QString packetPath = HuProtocol::SeqPacketSocket::pathFor(m_socketPath);
+        if (m_packetServer->listen(packetPath)) {
+            connect(m_packetServer, &HuProtocol::SeqPacketServer::newConnection,
+                    this, &ModuleBridge::onNewPacketConnection);
+            qDebug() << "[ModuleBridge] seqpacket transport on" << packetPath;
+        } else {
+            qWarning() << "[ModuleBridge] seqpacket transport unavailable; stream only on"
+                       << m_socketPath;
+        }
+    }
+
+    // 사이드 채널은 선택 사항 — 실패해도 스트림 소켓만으로 동작한다
+    if (!m_blobs.listen(HuProtocol::BlobChannel::pathFor(m_socketPath)))
+        qWarning() << "[ModuleBridge] blob channel unavailable on" << m_socketPath;
     return true;
 }
 
 void ModuleBridge::onNewConnection()
+{
+    QLocalSocket *socket = m_server->nextPendingConnection();
+    attachSocket(socket);
+    m_stream = socket;
+    connect(socket, &QLocalSocket::disconnected, this, &ModuleBridge::onSocketDisconnected);
+    qDebug() << "[ModuleBridge] module connected on" << m_socketPath;
+    sendCapabilities();
+}
+
+void ModuleBridge::onNewPacketConnection()
+{
+    HuProtocol::SeqPacketSocket *socket = m_packetServer->nextPendingConnection();
+    if (!socket) return;
+    attachSocket(socket);
+    m_packet = socket;
+    connect(socket, &HuProtocol::SeqPacketSocket::disconnected,
+            this, &ModuleBridge::onSocketDisconnected);
+    qDebug() << "[ModuleBridge] module connected on" << m_socketPath << "(seqpacket)";
+    sendCapabilities();
+}
+
+void ModuleBridge::attachSocket(QIODevice *socket)
 {
     if (m_socket) {
-        // 기존 연결 교체 (모듈 재시작 시)
-        m_socket->disconnectFromServer();
+        // 기존 연결 교체 (모듈 재시작 시) — 이전 소켓의 시그널은 더 이상 받지 않는다
+        m_socket->disconnect(this);
+        m_socket->close();
         m_socket->deleteLater();
     }
-    m_socket = m_server->nextPendingConnection();
-    connect(m_socket, &QLocalSocket::readyRead,    this, &ModuleBridge::onReadyRead);
-    connect(m_socket, &QLocalSocket::disconnected, this, &ModuleBridge::onSocketDisconnected);
-    qDebug() << "[ModuleBridge] module connected on" << m_socketPath;
+    m_socket = socket;
+    m_stream = nullptr;
+    m_packet = nullptr;
+    m_reader.clear();
+    resetQueue();
+    m_peerStamps = false;
+    m_txSeq      = 0;
+    m_latency.clear();
+    m_peerBlobs  = false;
+    m_peerSharedState = false;
+    m_blobs.dropPeer();
+    connect(m_socket, &QIODevice::readyRead,    this, &ModuleBridge::onReadyRead);
+    connect(m_socket, &QIODevice::bytesWritten, this, &ModuleBridge::onBytesWritten);
+}
+
+void ModuleBridge::sendCapabilities()
+{
+    // 구버전 모듈은 모르는 타입으로 무시한다 → 확장 헤더 없이 계속 동작
+    quint32 caps = HuProtocol::CapTimestampedHeader;
+    if (m_blobs.isListening())
+        caps |= HuProtocol::CapBlobChannel;
+    sendControl(HuProtocol::ShellCapabilitiesMsg{ caps });
+}
+
+void ModuleBridge::abortSocket()
+{
+    if (m_packet)
+        m_packet->abort();
+    else if (m_stream)
+        m_stream->abort();
 }
 
 void ModuleBridge::onSocketDisconnected()
 {
     qDebug() << "[ModuleBridge] module disconnected on" << m_socketPath;
+    logStats("disconnect");
+    m_socket->disconnect(this);
     m_socket->deleteLater();
     m_socket = nullptr;
+    m_stream = nullptr;
+    m_packet = nullptr;
+    resetQueue();
+    m_peerBlobs = false;
+    m_peerSharedState = false;
+    m_blobs.dropPeer();
 }
 
 void ModuleBridge::onReadyRead()
 {
-    m_readBuf.append(m_socket->readAll());
-    processBuffer();
+    if (m_packet) {
+        readPackets();
+        return;
+    }
+
+    // 소켓 → 링버퍼 직접 읽기, 프레임은 제자리에서 파싱 (프레임당 복사/할당 없음)
+    while (m_reader.readFrom(m_stream) > 0) {
+        HuProtocol::FrameView frame;
+        while (m_reader.next(frame))
+            dispatchFrame(frame);
+        if (!m_socket) return; // dispatch 중 연결이 끊긴 경우
+    }
+    if (m_reader.hasError() && m_socket) {
+        qWarning() << "[ModuleBridge] corrupt frame stream on" << m_socketPath
+                   << "; dropping connection";
+        m_reader.clear();
+        abortSocket();
+    }
 }
 
-void ModuleBridge::processBuffer()
+void ModuleBridge::readPackets()
 {
-    while (true) {
-        HuProtocol::MsgType type;
-        QByteArray payload;
-        int consumed = 0;
-        if (!HuProtocol::decodeFrame(m_readBuf, type, payload, consumed))
+    // 커널이 경계를 유지 — recvmmsg 한 번에 여러 프레임, 재조립 없음
+    HuProtocol::SeqPacketSocket *packet = m_packet;
+    while (packet->readBatch() > 0) {
+        HuProtocol::FrameView frame;
+        while (packet->next(frame)) {
+            dispatchFrame(frame);
+            if (m_packet != packet) return; // dispatch 중 연결이 끊긴 경우
+        }
+        if (packet->hasError())
             break;
-        m_readBuf.remove(0, consumed);
-        dispatchFrame(type, payload);
+    }
+    // 잘린 데이터그램은 readBatch()가 -1로 끝난다 — 그대로 두면 notifier가 계속 깨운다
+    if (packet->hasError()) {
+        qWarning() << "[ModuleBridge] malformed datagram on" << m_socketPath
+                   << "; dropping connection";
+        packet->abort();
     }
 }
 
-void ModuleBridge::dispatchFrame(HuProtocol::MsgType type, const QByteArray &payload)
+void ModuleBridge::dispatchFrame(const HuProtocol::FrameView &frame)
 {
-    using MT = HuProtocol::MsgType;
-    QDataStream ds(payload);
-    ds.setByteOrder(QDataStream::BigEndian);
-
-    switch (type) {
-    case MT::ModuleReady: {
-        quint64 winId;
-        ds >> winId;
-        emit moduleReady(winId);
+    m_latency.record(frame);
+    switch (Dispatcher::dispatch(*this, frame)) {
+    case HuProtocol::DispatchResult::Handled:
         break;
-    }
-    case MT::GearChangeRequest: {
-        quint8 g, src;
-        ds >> g >> src;
-        const QString source = (src == 1) ? "button" : "touch";
-        emit gearChangeRequested(static_cast<GearState>(g), source);
+    case HuProtocol::DispatchResult::Malformed:
+        qWarning() << "[ModuleBridge] truncated payload for msg type"
+                   << static_cast<quint32>(frame.type) << "size" << frame.size;
         break;
-    }
-    case MT::AmbientColorSet: {
-        quint8 r, gr, b, br;
-        ds >> r >> gr >> b >> br;
-        emit ambientColorChanged(r, gr, b, br);
+    case HuProtocol::DispatchResult::Unknown:
+        qWarning() << "[ModuleBridge] unknown msg type" << static_cast<quint32>(frame.type);
         break;
     }
-    case MT::AmbientOff:
-        emit ambientOff();
+}
+
+void ModuleBridge::handle(const HuProtocol::ModuleReadyMsg &msg)
+{
+    emit moduleReady(msg.winId);
+}
+
+void ModuleBridge::handle(const HuProtocol::GearChangeRequestMsg &msg)
+{
+    const QString source = (msg.source == 1) ? "button" : "touch";
+    emit gearChangeRequested(static_cast<GearState>(msg.gear), source);
+}
+
+void ModuleBridge::handle(const HuProtocol::AmbientColorSetMsg &msg)
+{
+    emit ambientColorChanged(msg.r, msg.g, msg.b, msg.brightness);
+}
+
+void ModuleBridge::handle(const HuProtocol::AmbientOffMsg &)
+{
+    emit ambientOff();
+}
+
+void ModuleBridge::handle(const HuProtocol::SettingsChangedMsg &msg)
+{
+    // 구버전 / 확장 키 — 레지스트리에 있는 키는 타입 변환해서 settingsChanged로 보낸다
+    QDataStream vs(QByteArray::fromRawData(msg.data, msg.size));
+    vs.setByteOrder(QDataStream::BigEndian);
+    QVariantMap changes;
+    vs >> changes;
+
+    HuProtocol::SettingsDelta delta;
+    for (auto it = changes.begin(); it != changes.end();) {
+        const HuProtocol::SettingDescriptor *desc = HuProtocol::findSetting(it.key());
+        if (desc && delta.setVariant(*desc, it.value()))
+            it = changes.erase(it);
+        else
+            ++it;
+    }
+    if (!delta.isEmpty())
+        emit settingsChanged(delta);
+    if (!changes.isEmpty())
+        emit extensionSettingsChanged(changes);
+}
+
+void ModuleBridge::handle(const HuProtocol::SettingsDeltaMsg &msg)
+{
+    HuProtocol::SettingsDelta delta;
+    int skipped = 0;
+    if (!HuProtocol::SettingsDelta::decode(msg.data, msg.size, delta, &skipped)) {
+        qWarning() << "[ModuleBridge]" << m_socketPath << "malformed settings delta";
+        return;
+    }
+    if (skipped)
+        qDebug() << "[ModuleBridge]" << m_socketPath << "ignored" << skipped << "unknown setting keys";
+    if (!delta.isEmpty())
+        emit settingsChanged(delta);
+}
+
+void ModuleBridge::handle(const HuProtocol::ModuleBlobMsg &msg)
+{
+    HuProtocol::SharedBlob blob = m_blobs.take(msg.blobId);
+    if (!blob.isValid() || static_cast<quint64>(blob.size()) != msg.size) {
+        qWarning() << "[ModuleBridge]" << m_socketPath << "blob" << msg.blobId
+                   << "missing or size mismatch";
+        return;
+    }
+    emit blobReceived(msg.kind,
+                      HuProtocol::SharedBlobPtr(new HuProtocol::SharedBlob(std::move(blob))));
+}
+
+void ModuleBridge::handle(const HuProtocol::ModuleCapabilitiesMsg &msg)
+{
+    m_peerStamps = (msg.flags & HuProtocol::CapTimestampedHeader) != 0;
+    // 모듈은 사이드 채널 connect가 끝난 뒤에만 이 비트를 보낸다 → 여기서 바로 accept된다
+    m_peerBlobs  = (msg.flags & HuProtocol::CapBlobChannel) != 0 && m_blobs.hasPeer();
+    // 공유 블록을 못 연 모듈(또는 구버전 모듈)은 이 비트가 없다 → 소켓 전송 유지
+    m_peerSharedState = (msg.flags & HuProtocol::CapSharedVehicleState) != 0;
+    qDebug() << "[ModuleBridge]" << m_socketPath << "module capabilities" << msg.flags
+             << (m_peerStamps ? "- timestamped frames enabled" : "")
+             << (m_peerBlobs ? "- blob channel enabled" : "")
+             << (m_peerSharedState ? "- reads shared vehicle state" : "");
+}
+
+// ── 송신 ─────────────────────────────────────────────────────────────
+
+void ModuleBridge::setHiddenPolicy(DeliveryPolicy policy)
+{
+    m_hiddenPolicy = policy;
+    if (policy == DeliveryPolicy::Immediate)
+        flushPending();
+}
+
+void ModuleBridge::deliver(TelemetrySlot slot)
+{
+    const bool congested = isCongested();
+    if ((m_shown || m_hiddenPolicy == DeliveryPolicy::Immediate) && !congested) {
+        writeTelemetry(slot);
+        return;
+    }
+
+    // 숨김 상태 또는 소켓 혼잡: 같은 슬롯의 이전 값은 버리고 최신값만 남긴다
+    const quint8 bit = static_cast<quint8>(1u << slot);
+    if (m_dirtySlots & bit)
+        ++m_stats.framesCoalesced;
+    else if (congested)
+        ++m_stats.framesDeferred;
+    m_dirtySlots |= bit;
+
+    if (congested) {
+        noteCongestion();   // bytesWritten에서 비운다
+        return;
+    }
+    if (m_hiddenPolicy == DeliveryPolicy::Coalesce && !m_flushTimer.isActive())
+        m_flushTimer.start();
+}
+
+void ModuleBridge::flushPending()
+{
+    m_flushTimer.stop();
+    if (!m_dirtySlots || isCongested()) return;
+    writePending(false);
+}
+
+void ModuleBridge::writePending(bool ordered)
+{
+    // 보관된 슬롯을 한 번에 기록 — QLocalSocket 쓰기 버퍼(또는 제어 큐)에서 한 번의 write로 나간다
+    for (quint8 slot = 0; slot < SlotCount; ++slot) {
+        if (m_dirtySlots & (1u << slot))
+            writeTelemetry(static_cast<TelemetrySlot>(slot), ordered);
+    }
+    m_dirtySlots = 0;
+    ++m_stats.snapshotFlushes;
+}
+
+void ModuleBridge::writeTelemetry(TelemetrySlot slot, bool ordered)
+{
+    switch (slot) {
+    case SlotGear:
+        send(HuProtocol::GearStateUpdateMsg{ static_cast<quint8>(m_values.gear) },
+             m_slotOriginNs[SlotGear], ordered);
         break;
-    case MT::SettingsChanged: {
-        QVariantMap changes;
-        ds >> changes;
-        emit settingsChanged(changes);
+    case SlotSpeed:
+        send(HuProtocol::VehicleSpeedUpdateMsg{ m_values.speedKmh },
+             m_slotOriginNs[SlotSpeed], ordered);
         break;
-    }
-    default:
-        qWarning() << "[ModuleBridge] unknown msg type" << static_cast<quint32>(type);
+    case SlotBattery:
+        send(HuProtocol::BatteryUpdateMsg{ m_values.batteryVoltage, m_values.batteryPercent },
+             m_slotOriginNs[SlotBattery], ordered);
+        break;
+    case SlotIpcStatus:
+        send(HuProtocol::IpcStatusUpdateMsg{ quint8(m_values.ipcConnected ? 1 : 0) },
+             m_slotOriginNs[SlotIpcStatus], ordered);
+        break;
+    case SlotCount:
         break;
     }
 }
 
-// ── 송신 ─────────────────────────────────────────────────────────────
+void ModuleBridge::logStats(const char *reason) const
+{
+    qDebug() << "[ModuleBridge]" << m_socketPath << reason
+             << "- frames sent:" << m_stats.framesSent
+             << "saved by coalescing:" << m_stats.framesCoalesced
+             << "snapshot flushes:" << m_stats.snapshotFlushes
+             << "deferred:" << m_stats.framesDeferred
+             << "queue high-water:" << m_stats.queueHighWater
+             << "backlog high-water:" << m_stats.backlogHighWater << "B";
+    m_latency.log(QStringLiteral("[ModuleBridge] %1").arg(m_socketPath));
+}
+
+// ── 역압 (bounded outbound queue) ─────────────────────────────────────
 
-void ModuleBridge::sendFrame(HuProtocol::MsgType type, const QByteArray &payload)
+void ModuleBridge::writeFrame(const char *data, int size)
 {
     if (!m_socket) return;
-    m_socket->write(HuProtocol::encodeFrame(type, payload));
+    if (m_socket->write(data, size) < 0) {
+        qWarning() << "[ModuleBridge]" << m_socketPath << "frame not sent:" << m_socket->errorString();
+        return;
+    }
+    ++m_stats.framesSent;
+    m_stats.backlogHighWater = qMax(m_stats.backlogHighWater, m_socket->bytesToWrite());
+}
+
+bool ModuleBridge::isCongested() const
+{
+    // 제어 큐가 남아 있으면 순서 보장을 위해 새 프레임도 큐로 보낸다
+    return m_socket && (m_controlQueuedFrames > 0 || m_socket->bytesToWrite() >= SOCKET_HIGH_WATER);
 }
 
+int ModuleBridge::queuedFrames() const
+{
+    const int congestedSlots = isCongested() ? qPopulationCount(m_dirtySlots) : 0;
+    return m_controlQueuedFrames + congestedSlots;
+}
+
+void ModuleBridge::enqueueControl(const char *data, int size)
+{
+    // 큐는 한 번의 write로 나간다 — seqpacket에 담을 수 없는 프레임이 섞이면 묶음 전체가 거부된다
+    if (m_packet && size > HuProtocol::MAX_PACKET_SIZE) {
+        qWarning() << "[ModuleBridge]" << m_socketPath << "frame not sent:" << size
+                   << "bytes exceeds the seqpacket limit";
+        return;
+    }
+    m_controlQueue.append(data, size);
+    ++m_controlQueuedFrames;
+    ++m_stats.framesDeferred;
+    noteCongestion();
+
+    if (m_controlQueuedFrames > CONTROL_QUEUE_LIMIT && !m_slowConsumer) {
+        // 제어 메시지는 버릴 수 없으므로 한계를 넘으면 즉시 shell에 알린다
+        m_slowConsumer = true;
+        qWarning() << "[ModuleBridge]" << m_socketPath << "control queue over limit:"
+                   << m_controlQueuedFrames << "frames";
+        emit slowConsumer(true);
+    }
+}
+
+void ModuleBridge::noteCongestion()
+{
+    m_stats.queueHighWater = qMax(m_stats.queueHighWater, queuedFrames());
+    if (!m_slowConsumer && !m_slowTimer.isActive())
+        m_slowTimer.start();
+}
+
+void ModuleBridge::onBytesWritten()
+{
+    if (!m_socket || m_socket->bytesToWrite() > SOCKET_LOW_WATER)
+        return;
+    if (m_controlQueuedFrames > 0 || m_dirtySlots)
+        drainQueue();
+}
+
+void ModuleBridge::drainQueue()
+{
+    // 1) 제어 메시지 — 순서대로 한 번에 (작은 프레임들이라 묶어서 write)
+    if (m_controlQueuedFrames > 0) {
+        m_socket->write(m_controlQueue);
+        m_stats.framesSent += static_cast<quint64>(m_controlQueuedFrames);
+        m_controlQueue.clear();
+        m_controlQueuedFrames = 0;
+    }
+
+    // 2) 보관된 텔레메트리 — 표시 중이거나 Immediate면 바로, 아니면 숨김 정책으로 복귀
+    if (m_dirtySlots) {
+        if (m_shown || m_hiddenPolicy == DeliveryPolicy::Immediate)
+            flushPending();
+        else if (m_hiddenPolicy == DeliveryPolicy::Coalesce && !m_flushTimer.isActive())
+            m_flushTimer.start();
+    }
+    m_stats.backlogHighWater = qMax(m_stats.backlogHighWater, m_socket->bytesToWrite());
+
+    if (!isCongested()) {
+        m_slowTimer.stop();
+        if (m_slowConsumer) {
+            m_slowConsumer = false;
+            qDebug() << "[ModuleBridge]" << m_socketPath << "consumer recovered";
+            emit slowConsumer(false);
+        }
+    }
+}
+
+void ModuleBridge::onSlowConsumerTimeout()
+{
+    if (!isCongested() || m_slowConsumer) return;
+    m_slowConsumer = true;
+    qWarning() << "[ModuleBridge]" << m_socketPath << "slow consumer: backlog"
+               << socketBacklog() << "B, queued" << queuedFrames() << "frames";
+    emit slowConsumer(true);
+}
+
+void ModuleBridge::resetQueue()
+{
+    m_controlQueue.clear();
+    m_controlQueuedFrames = 0;
+    m_slowTimer.stop();
+    if (m_slowConsumer) {
+        m_slowConsumer = false;
+        emit slowConsumer(false);
+    }
+}
+
+// ── 순서 보장 레인 (coalescing 대상 아님) ─────────────────────────────
+
 void ModuleBridge::sendShow(const QRect &geo)
 {
-    QByteArray p;
-    QDataStream ds(&p, QIODevice::WriteOnly);
-    ds.setByteOrder(QDataStream::BigEndian);
-    ds << qint32(geo.x()) << qint32(geo.y()) << qint32(geo.width()) << qint32(geo.height());
-    sendFrame(HuProtocol::MsgType::ShowModule, p);
+    m_shown = true;
+    // 숨김 동안 보관된 최신 상태를 먼저 보낸 뒤 Show. 혼잡하면 flushPending()은 아무것도 안 하고,
+    // drainQueue()는 제어 큐(Show)를 먼저 비운다 — 보관된 슬롯을 같은 제어 큐에 Show보다 앞에 넣는다
+    m_flushTimer.stop();
+    if (m_dirtySlots)
+        writePending(isCongested());
+
+    sendControl(HuProtocol::ShowModuleMsg{ geo.x(), geo.y(), geo.width(), geo.height() });
 }
 
 void ModuleBridge::sendHide()
 {
-    sendFrame(HuProtocol::MsgType::HideModule);
+    m_shown = false;
+    sendControl(HuProtocol::HideModuleMsg{});
 }
 
-void ModuleBridge::sendGearState(GearState gear)
+void ModuleBridge::sendShutdown()
 {
-    QByteArray p;
-    QDataStream ds(&p, QIODevice::WriteOnly);
-    ds.setByteOrder(QDataStream::BigEndian);
-    ds << static_cast<quint8>(gear);
-    sendFrame(HuProtocol::MsgType::GearStateUpdate, p);
+    sendControl(HuProtocol::ShellShutdownMsg{});
 }
 
-void ModuleBridge::sendVehicleSpeed(float kmh)
+bool ModuleBridge::sendBlob(quint32 kind, const HuProtocol::SharedBlob &blob)
 {
-    QByteArray p;
-    QDataStream ds(&p, QIODevice::WriteOnly);
-    ds.setByteOrder(QDataStream::BigEndian);
-    ds << kmh;
-    sendFrame(HuProtocol::MsgType::VehicleSpeedUpdate, p);
+    if (!canSendBlobs()) return false;
+    // fd가 제어 프레임보다 먼저 나가야 수신 측 take()가 항상 찾을 수 있다
+    const quint32 id = m_blobs.send(blob);
+    if (id == 0) return false;
+    sendControl(HuProtocol::ShellBlobMsg{ id, kind, static_cast<quint64>(blob.size()) });
+    return true;
 }
 
-void ModuleBridge::sendBattery(float voltage, float percent)
+// ── 텔레메트리 (숨김 상태에서 정책에 따라 합쳐짐) ─────────────────────
+
+void ModuleBridge::sendGearState(GearState gear, quint64 originNs)
 {
-    QByteArray p;
-    QDataStream ds(&p, QIODevice::WriteOnly);
-    ds.setByteOrder(QDataStream::BigEndian);
-    ds << voltage << percent;
-    sendFrame(HuProtocol::MsgType::BatteryUpdate, p);
+    m_values.gear = gear;
+    m_slotOriginNs[SlotGear] = originNs ? originNs : HuProtocol::monotonicNowNs();
+    deliver(SlotGear);
 }
 
-void ModuleBridge::sendIpcStatus(bool connected)
+void ModuleBridge::sendVehicleSpeed(float kmh, quint64 originNs)
 {
-    QByteArray p;
-    QDataStream ds(&p, QIODevice::WriteOnly);
-    ds.setByteOrder(QDataStream::BigEndian);
-    ds << static_cast<quint8>(connected ? 1 : 0);
-    sendFrame(HuProtocol::MsgType::IpcStatusUpdate, p);
+    m_values.speedKmh = kmh;
+    if (m_peerSharedState) return;   // 모듈이 공유 블록에서 직접 읽는다
+    m_slotOriginNs[SlotSpeed] = originNs ? originNs : HuProtocol::monotonicNowNs();
+    deliver(SlotSpeed);
 }
 
-void ModuleBridge::sendShutdown()
+void ModuleBridge::sendBattery(float voltage, float percent, quint64 originNs)
+{
+    m_values.batteryVoltage = voltage;
+    m_values.batteryPercent = percent;
+    if (m_peerSharedState) return;
+    m_slotOriginNs[SlotBattery] = originNs ? originNs : HuProtocol::monotonicNowNs();
+    deliver(SlotBattery);
+}
+
+void ModuleBridge::sendIpcStatus(bool connected, quint64 originNs)
 {
-    sendFrame(HuProtocol::MsgType::ShellShutdown);
+    m_values.ipcConnected = connected;
+    if (m_peerSharedState) return;
+    m_slotOriginNs[SlotIpcStatus] = originNs ? originNs : HuProtocol::monotonicNowNs();
+    deliver(SlotIpcStatus);
 }
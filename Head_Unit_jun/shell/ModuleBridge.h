@@ -1,18 +1,45 @@
 /**
  * @file ModuleBridge.h
  * @brief Shell 측 IPC 서버 — 모듈 1개당 QLocalServer 1개
+ *
+ * 전달 정책: 화면에 보이는 모듈(sendShow 이후)은 모든 갱신을 즉시 받는다.
+ * 숨겨진 모듈의 텔레메트리(기어/속도/배터리/IPC 상태)는 hiddenPolicy에 따라
+ *   - Immediate     : 그대로 즉시 전송
+ *   - Coalesce      : 값마다 최신값만 남기고 HIDDEN_FLUSH_MS 주기로 전송
+ *   - ParkUntilShow : 최신값만 보관했다가 sendShow 시 한 번에 전송
+ * ShowModule / HideModule / ShellShutdown 은 순서 보장 레인으로 항상 즉시 전송한다.
+ *
+ * 역압(back-pressure): 소켓 쓰기 버퍼(bytesToWrite)가 SOCKET_HIGH_WATER를 넘으면
+ * 더 이상 소켓에 쓰지 않고 브리지 큐에 보관한다.
+ *   - 텔레메트리 : 슬롯당 최신값 1개만 유지 (오래된 값은 교체)
+ *   - 제어 메시지: 절대 버리지 않고 순서대로 보관
+ * bytesWritten으로 버퍼가 SOCKET_LOW_WATER 아래로 내려가면 제어 → 텔레메트리 순으로 비운다.
+ * 혼잡이 SLOW_CONSUMER_MS 이상 지속되거나 제어 큐가 CONTROL_QUEUE_LIMIT를 넘으면
+ * slowConsumer(true), 큐가 모두 비워지면 slowConsumer(false)를 emit한다.
+ *
+ * 전송: 기본은 스트림 소켓. listen(Transport::SeqPacket)이면 <socketPath>.pkt(SOCK_SEQPACKET)도
+ * 함께 listen하고, 모듈이 어느 쪽으로 연결하든 같은 프레임 처리 경로를 쓴다.
+ *
+ * 대용량 payload: <socketPath>.fd 사이드 채널로 봉인된 memfd를 주고받는다 (SharedBlob.h).
+ * 모듈이 CapBlobChannel을 알려온 경우에만 sendBlob()이 성공한다.
  */
 
 #ifndef MODULEBRIDGE_H
 #define MODULEBRIDGE_H
 
 #include "ShellProtocol.h"
+#include "FrameReader.h"
+#include "LatencyHistogram.h"
+#include "SettingsRegistry.h"
+#include "SeqPacketSocket.h"
+#include "SharedBlob.h"
 #include "IVehicleDataProvider.h"
 
 #include <QObject>
 #include <QLocalServer>
 #include <QLocalSocket>
 #include <QRect>
+#include <QTimer>
 #include <QVariantMap>
 
 class ModuleBridge : public QObject
@@ -20,21 +47,60 @@ class ModuleBridge : public QObject
     Q_OBJECT
 
 public:
+    enum class DeliveryPolicy { Immediate, Coalesce, ParkUntilShow };
+
+    struct DeliveryStats {
+        quint64 framesSent      = 0;   // 실제로 소켓에 쓴 프레임
+        quint64 framesCoalesced = 0;   // 더 새로운 값으로 대체되어 보내지 않은 프레임
+        quint64 snapshotFlushes = 0;   // 보관된 값을 한꺼번에 내보낸 횟수
+        quint64 framesDeferred  = 0;   // 소켓 혼잡으로 큐에 보관된 프레임
+        int     queueHighWater  = 0;   // 브리지 큐 최대 깊이 (프레임)
+        qint64  backlogHighWater = 0;  // 소켓 쓰기 버퍼 최대 크기 (바이트)
+    };
+
     explicit ModuleBridge(const QString &socketPath, QObject *parent = nullptr);
     ~ModuleBridge();
 
-    bool listen();
+    /** SeqPacket이면 스트림 소켓(구버전 모듈용)과 <socketPath>.pkt를 모두 listen */
+    bool listen(HuProtocol::Transport transport = HuProtocol::Transport::Stream);
+    /** 현재 연결된 모듈의 전송 방식 */
+    HuProtocol::Transport activeTransport() const
+    {
+        return m_packet ? HuProtocol::Transport::SeqPacket : HuProtocol::Transport::Stream;
+    }
+
+    void setHiddenPolicy(DeliveryPolicy policy);
+    DeliveryPolicy hiddenPolicy() const { return m_hiddenPolicy; }
+    bool isShown() const { return m_shown; }
+    const DeliveryStats &deliveryStats() const { return m_stats; }
+
+    /** 브리지 큐에 보관 중인 프레임 수 (제어 + 대기 텔레메트리 슬롯) */
+    int queuedFrames() const;
+    /** 소켓이 아직 커널로 넘기지 못한 바이트 수 */
+    qint64 socketBacklog() const { return m_socket ? m_socket->bytesToWrite() : 0; }
+    bool isSlowConsumer() const { return m_slowConsumer; }
+
+    /** 모듈 → shell 프레임의 MsgType별 지연/간격 (모듈이 확장 헤더를 보낼 때만 채워짐) */
+    const HuProtocol::FrameLatencyStats &latencyStats() const { return m_latency; }
 
     // ── Shell → Module ───────────────────────────────
     void sendShow(const QRect &geometry);
     void sendHide();
-    void sendGearState(GearState gear);
-    void sendVehicleSpeed(float kmh);
-    void sendBattery(float voltage, float percent);
-    void sendIpcStatus(bool connected);
+    // originNs: 값이 생긴 시각 (monotonicNowNs) — hub는 GUI 스레드에서 찍어 넘긴다. 0이면 지금
+    void sendGearState(GearState gear, quint64 originNs = 0);
+    void sendVehicleSpeed(float kmh, quint64 originNs = 0);
+    void sendBattery(float voltage, float percent, quint64 originNs = 0);
+    void sendIpcStatus(bool connected, quint64 originNs = 0);
     void sendShutdown();
 
+    /**
+     * 봉인된 blob을 fd로 전달하고 ShellBlob 제어 프레임을 보낸다 (복사 없음).
+     * @return 모듈이 사이드 채널을 지원하지 않거나 전달에 실패하면 false
+     */
+    bool sendBlob(quint32 kind, const HuProtocol::SharedBlob &blob);
+
     bool isModuleConnected() const { return m_socket != nullptr; }
+    bool canSendBlobs() const { return m_socket && m_peerBlobs; }
 
 signals:
     // ── Module → Shell ───────────────────────────────
@@ -42,22 +108,155 @@ signals:
     void gearChangeRequested(GearState gear, const QString &source);
     void ambientColorChanged(quint8 r, quint8 g, quint8 b, quint8 brightness);
     void ambientOff();
-    void settingsChanged(const QVariantMap &changes);
+    /** 레지스트리 설정 변경 — SettingsDelta의 타입 접근자로 읽는다 (예: delta.speedUnit(u)) */
+    void settingsChanged(const HuProtocol::SettingsDelta &delta);
+    /** 레지스트리에 없는 키 (확장/구버전 모듈) */
+    void extensionSettingsChanged(const QVariantMap &changes);
+    /** 모듈이 보낸 대용량 payload (읽기 전용 매핑, 마지막 참조가 사라지면 해제) */
+    void blobReceived(quint32 kind, const HuProtocol::SharedBlobPtr &blob);
+
+    /** 모듈이 소켓을 제때 비우지 못함(true) / 회복됨(false) */
+    void slowConsumer(bool slow);
 
 private slots:
     void onNewConnection();
+    void onNewPacketConnection();
     void onReadyRead();
     void onSocketDisconnected();
+    void onBytesWritten();
+    void onSlowConsumerTimeout();
+    void flushPending();
 
 private:
-    void sendFrame(HuProtocol::MsgType type, const QByteArray &payload = {});
-    void processBuffer();
-    void dispatchFrame(HuProtocol::MsgType type, const QByteArray &payload);
-
-    QString        m_socketPath;
-    QLocalServer  *m_server;
-    QLocalSocket  *m_socket = nullptr;
-    QByteArray     m_readBuf;
+    // 숨김 상태에서 latest-value-wins로 합쳐지는 텔레메트리 슬롯
+    enum TelemetrySlot : quint8 {
+        SlotGear = 0,
+        SlotSpeed,
+        SlotBattery,
+        SlotIpcStatus,
+        SlotCount
+    };
+
+    struct TelemetryValues {
+        GearState gear           = GearState::P;
+        float     speedKmh       = 0.0f;
+        float     batteryVoltage = 0.0f;
+        float     batteryPercent = 0.0f;
+        bool      ipcConnected   = false;
+    };
+
+    using Dispatcher = HuProtocol::Dispatcher<ModuleBridge, HuProtocol::ModuleToShell>;
+    friend Dispatcher;
+
+    /** 모듈이 CapTimestampedHeader를 알렸으면 확장 헤더(originNs, 순번)를 붙여 인코딩 */
+    template <typename Msg, typename Fn>
+    void withFrame(const Msg &msg, quint64 originNs, Fn &&fn)
+    {
+        if (m_peerStamps) {
+            const auto frame = HuProtocol::encode(msg, HuProtocol::FrameStamp{ originNs, ++m_txSeq });
+            fn(frame.data(), frame.size());
+        } else {
+            const auto frame = HuProtocol::encode(msg);
+            fn(frame.data(), frame.size());
+        }
+    }
+
+    /** 제어 메시지 — 혼잡 시 순서대로 큐에 보관 (버리지 않음) */
+    template <typename Msg>
+    void sendControl(const Msg &msg)
+    {
+        if (!m_socket) return;
+        withFrame(msg, HuProtocol::monotonicNowNs(), [this](const char *data, int size) {
+            if (isCongested())
+                enqueueControl(data, size);
+            else
+                writeFrame(data, size);
+        });
+    }
+
+    /**
+     * 텔레메트리 — originNs는 shell이 값을 넘겨받은 시각 (합쳐진 대기 시간까지 지연에 포함).
+     * ordered면 제어 큐 뒤에 붙인다 (혼잡 중 Show 앞에 보관된 상태를 내보낼 때)
+     */
+    template <typename Msg>
+    void send(const Msg &msg, quint64 originNs, bool ordered = false)
+    {
+        withFrame(msg, originNs, [this, ordered](const char *data, int size) {
+            if (ordered)
+                enqueueControl(data, size);
+            else
+                writeFrame(data, size);
+        });
+    }
+
+    void attachSocket(QIODevice *socket);
+    void sendCapabilities();
+    void abortSocket();
+    void readPackets();
+
+    void writeFrame(const char *data, int size);
+    void enqueueControl(const char *data, int size);
+    bool isCongested() const;
+    void noteCongestion();
+    void drainQueue();
+    void resetQueue();
+
+    void dispatchFrame(const HuProtocol::FrameView &frame);
+
+    // ── Module → Shell 핸들러 (Dispatcher가 호출) ─────
+    void handle(const HuProtocol::ModuleReadyMsg &msg);
+    void handle(const HuProtocol::GearChangeRequestMsg &msg);
+    void handle(const HuProtocol::AmbientColorSetMsg &msg);
+    void handle(const HuProtocol::AmbientOffMsg &msg);
+    void handle(const HuProtocol::SettingsChangedMsg &msg);
+    void handle(const HuProtocol::SettingsDeltaMsg &msg);
+    void handle(const HuProtocol::ModuleBlobMsg &msg);
+    void handle(const HuProtocol::ModuleCapabilitiesMsg &msg);
+
+    void deliver(TelemetrySlot slot);
+    void writePending(bool ordered);
+    void writeTelemetry(TelemetrySlot slot, bool ordered = false);
+    void logStats(const char *reason) const;
+
+    QString                      m_socketPath;
+    QLocalServer                *m_server;
+    HuProtocol::SeqPacketServer *m_packetServer = nullptr;
+    QIODevice                   *m_socket = nullptr;   // 현재 연결 (m_stream 또는 m_packet)
+    QLocalSocket                *m_stream = nullptr;
+    HuProtocol::SeqPacketSocket *m_packet = nullptr;
+    HuProtocol::FrameReader      m_reader;             // 스트림 전송에서만 사용
+
+    DeliveryPolicy   m_hiddenPolicy = DeliveryPolicy::Coalesce;
+    bool             m_shown        = false;
+    quint8           m_dirtySlots   = 0;   // 비트마스크 (1 << TelemetrySlot)
+    TelemetryValues  m_values;
+    quint64          m_slotOriginNs[SlotCount] = {};
+    DeliveryStats    m_stats;
+    QTimer           m_flushTimer;
+
+    // ── 역압 상태 ─────────────────────────────────────
+    QByteArray       m_controlQueue;           // 인코딩된 제어 프레임 (연속 저장)
+    int              m_controlQueuedFrames = 0;
+    bool             m_slowConsumer = false;
+    QTimer           m_slowTimer;
+
+    // ── 확장 헤더 (지연 측정) ─────────────────────────
+    bool                          m_peerStamps = false;
+    quint32                       m_txSeq      = 0;
+    HuProtocol::FrameLatencyStats m_latency;
+
+    // ── memfd 사이드 채널 ─────────────────────────────
+    HuProtocol::BlobChannel       m_blobs;
+    bool                          m_peerBlobs = false;
+
+    // ── 공유 차량 상태 블록 ───────────────────────────
+    bool                          m_peerSharedState = false;  // 속도/배터리/IPC 상태 소켓 전송 생략
+
+    static constexpr int    HIDDEN_FLUSH_MS     = 500;
+    static constexpr qint64 SOCKET_HIGH_WATER   = 64 * 1024;
+    static constexpr qint64 SOCKET_LOW_WATER    = 16 * 1024;
+    static constexpr int    CONTROL_QUEUE_LIMIT = 64;    // 프레임
+    static constexpr int    SLOW_CONSUMER_MS    = 2000;
 };
 
 #endif // MODULEBRIDGE_H
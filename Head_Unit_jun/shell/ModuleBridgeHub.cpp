@@ -0,0 +1,194 @@
+/**
+ * @file ModuleBridgeHub.cpp
+ */
+
+#include "ModuleBridgeHub.h"
+
+#include <QDebug>
+#include <QMutexLocker>
+
+ModuleBridgeHub::ModuleBridgeHub(QObject *parent)
+    : QObject(parent)
+{
+    qRegisterMetaType<GearState>("GearState");
+    qRegisterMetaType<HuProtocol::SettingsDelta>("HuProtocol::SettingsDelta");
+    qRegisterMetaType<HuProtocol::SharedBlobPtr>("HuProtocol::SharedBlobPtr");
+
+    m_thread.setObjectName(QStringLiteral("hu_ipc"));
+    m_context = new QObject;
+    m_context->moveToThread(&m_thread);
+    // 루프 종료 후 IPC 스레드에서 삭제 — 자식 브리지(소켓/서버)도 같은 스레드에서 정리된다
+    connect(&m_thread, &QThread::finished, m_context, &QObject::deleteLater);
+    m_thread.start();
+}
+
+ModuleBridgeHub::~ModuleBridgeHub()
+{
+    m_thread.quit();
+    m_thread.wait();
+}
+
+template <typename Fn>
+void ModuleBridgeHub::post(Fn &&fn)
+{
+    QMetaObject::invokeMethod(m_context, std::forward<Fn>(fn), Qt::QueuedConnection);
+}
+
+int ModuleBridgeHub::addModule(const QString &socketPath, HuProtocol::Transport transport)
+{
+    if (m_count >= MAX_MODULES)
+        return -1;
+
+    const int index = m_count;
+    bool listening  = false;
+    // 시작 시 모듈 수만큼만 호출되므로 생성/listen은 IPC 스레드에서 동기로 끝낸다
+    QMetaObject::invokeMethod(m_context, [this, index, socketPath, transport, &listening] {
+        auto *bridge = new ModuleBridge(socketPath, m_context);
+        bridge->setHiddenPolicy(static_cast<ModuleBridge::DeliveryPolicy>(m_hiddenPolicy.load()));
+        listening = bridge->listen(transport);
+        m_bridges[index] = bridge;
+        wireBridge(index, bridge);
+    }, Qt::BlockingQueuedConnection);
+
+    ++m_count;
+    return listening ? index : -1;
+}
+
+void ModuleBridgeHub::setHiddenPolicy(ModuleBridge::DeliveryPolicy policy)
+{
+    m_hiddenPolicy = static_cast<int>(policy);
+    post([this, policy] {
+        for (ModuleBridge *b : m_bridges)
+            if (b && !b->isSlowConsumer()) b->setHiddenPolicy(policy);
+    });
+}
+
+// ── IPC 스레드: 브리지 시그널 연결 ────────────────────────────────────
+
+void ModuleBridgeHub::wireBridge(int index, ModuleBridge *bridge)
+{
+    // 이산 이벤트 — receiver(this)가 GUI 스레드이므로 자동으로 queued
+    connect(bridge, &ModuleBridge::moduleReady, this, [this, index](quint64 winId) {
+        emit moduleReady(index, winId);
+    });
+    connect(bridge, &ModuleBridge::gearChangeRequested,
+            this, [this, index](GearState gear, const QString &source) {
+        emit gearChangeRequested(index, gear, source);
+    });
+    connect(bridge, &ModuleBridge::settingsChanged,
+            this, [this, index](const HuProtocol::SettingsDelta &delta) {
+        emit settingsChanged(index, delta);
+    });
+    connect(bridge, &ModuleBridge::slowConsumer, this, [this, index](bool slow) {
+        emit slowConsumer(index, slow);
+    });
+    connect(bridge, &ModuleBridge::blobReceived,
+            this, [this, index](quint32 kind, const HuProtocol::SharedBlobPtr &blob) {
+        emit blobReceived(index, kind, blob);
+    });
+
+    // 연속 값 — IPC 스레드에서 최신값만 저장하고 GUI에는 한 번만 알린다
+    connect(bridge, &ModuleBridge::ambientColorChanged,
+            bridge, [this, index](quint8 r, quint8 g, quint8 b, quint8 brightness) {
+        storeAmbient(index, AmbientSlot{ true, r, g, b, brightness });
+    });
+    connect(bridge, &ModuleBridge::ambientOff, bridge, [this, index] {
+        storeAmbient(index, AmbientSlot{});
+    });
+
+    // 느린 모듈: 숨김 텔레메트리는 Show 때까지 보관 (IPC 스레드에서 처리)
+    connect(bridge, &ModuleBridge::slowConsumer, bridge, [this, bridge, index](bool slow) {
+        const ModuleBridge::DeliveryStats &st = bridge->deliveryStats();
+        qWarning() << "[BridgeHub] module" << index
+                   << (slow ? "is not draining its socket" : "recovered")
+                   << "- backlog" << bridge->socketBacklog() << "B"
+                   << "queued" << bridge->queuedFrames()
+                   << "high-water" << st.queueHighWater;
+        bridge->setHiddenPolicy(slow ? ModuleBridge::DeliveryPolicy::ParkUntilShow
+                                     : static_cast<ModuleBridge::DeliveryPolicy>(m_hiddenPolicy.load()));
+    });
+}
+
+void ModuleBridgeHub::storeAmbient(int index, const AmbientSlot &slot)
+{
+    {
+        QMutexLocker lock(&m_ambientLock);
+        m_ambient[index] = slot;
+    }
+    if (!m_ambientPending[index].exchange(true))
+        QMetaObject::invokeMethod(this, [this, index] { deliverAmbient(index); }, Qt::QueuedConnection);
+}
+
+void ModuleBridgeHub::deliverAmbient(int index)
+{
+    AmbientSlot slot;
+    {
+        QMutexLocker lock(&m_ambientLock);
+        m_ambientPending[index] = false;
+        slot = m_ambient[index];
+    }
+    if (slot.on)
+        emit ambientColorChanged(index, slot.r, slot.g, slot.b, slot.brightness);
+    else
+        emit ambientOff(index);
+}
+
+// ── GUI → IPC ─────────────────────────────────────────────────────────
+
+void ModuleBridgeHub::show(int index, const QRect &geometry)
+{
+    if (index < 0 || index >= m_count) return;
+    post([this, index, geometry] { m_bridges[index]->sendShow(geometry); });
+}
+
+void ModuleBridgeHub::hide(int index)
+{
+    if (index < 0 || index >= m_count) return;
+    post([this, index] { m_bridges[index]->sendHide(); });
+}
+
+void ModuleBridgeHub::sendBlob(int index, quint32 kind, const HuProtocol::SharedBlobPtr &blob)
+{
+    if (index < 0 || index >= m_count || !blob) return;
+    post([this, index, kind, blob] {
+        if (!m_bridges[index]->sendBlob(kind, *blob))
+            qWarning() << "[BridgeHub] module" << index << "cannot take blob kind" << kind;
+    });
+}
+
+void ModuleBridgeHub::broadcastGear(GearState gear)
+{
+    // 지연 측정 기준은 GUI 스레드에서 값이 생긴 시각 — IPC 스레드 큐 대기도 포함해야 한다
+    const quint64 originNs = HuProtocol::monotonicNowNs();
+    post([this, gear, originNs] {
+        for (ModuleBridge *b : m_bridges)
+            if (b && b->isModuleConnected()) b->sendGearState(gear, originNs);
+    });
+}
+
+void ModuleBridgeHub::broadcastSpeed(float kmh)
+{
+    const quint64 originNs = HuProtocol::monotonicNowNs();
+    post([this, kmh, originNs] {
+        for (ModuleBridge *b : m_bridges)
+            if (b && b->isModuleConnected()) b->sendVehicleSpeed(kmh, originNs);
+    });
+}
+
+void ModuleBridgeHub::broadcastBattery(float voltage, float percent)
+{
+    const quint64 originNs = HuProtocol::monotonicNowNs();
+    post([this, voltage, percent, originNs] {
+        for (ModuleBridge *b : m_bridges)
+            if (b && b->isModuleConnected()) b->sendBattery(voltage, percent, originNs);
+    });
+}
+
+void ModuleBridgeHub::broadcastIpcStatus(bool connected)
+{
+    const quint64 originNs = HuProtocol::monotonicNowNs();
+    post([this, connected, originNs] {
+        for (ModuleBridge *b : m_bridges)
+            if (b && b->isModuleConnected()) b->sendIpcStatus(connected, originNs);
+    });
+}
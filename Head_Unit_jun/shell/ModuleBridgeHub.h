@@ -0,0 +1,93 @@
+/**
+ * @file ModuleBridgeHub.h
+ * @brief 모든 ModuleBridge를 전용 IPC 스레드에서 돌리는 GUI 측 창구
+ *
+ * 6개 모듈 소켓, QLocalServer, 프레임 파싱은 IPC 스레드(QThread 이벤트 루프)에서만 돈다.
+ * GUI 스레드는 이 허브만 사용한다:
+ *   - GUI → IPC : show/hide/broadcast* — IPC 스레드로 queued 호출 (호출 순서 유지)
+ *   - IPC → GUI : 디코딩된 이벤트만 모듈 index와 함께 queued 시그널로 전달
+ *                 Ambient 색상처럼 연속적인 값은 모듈당 최신값 1개로 합쳐서
+ *                 GUI 이벤트 루프 1회당 최대 1번 post한다.
+ * 그래서 IPC 트래픽이 몰려도 GUI 스레드의 합성/렌더링(paintGL, 클러스터 blit)을 막지 않는다.
+ *
+ * 느린 모듈(ModuleBridge::slowConsumer) 처리도 IPC 스레드에서 한다:
+ * 숨김 텔레메트리를 ParkUntilShow로 돌렸다가 회복 시 원래 정책으로 되돌린다.
+ */
+
+#ifndef MODULEBRIDGEHUB_H
+#define MODULEBRIDGEHUB_H
+
+#include "ModuleBridge.h"
+
+#include <QMutex>
+#include <QObject>
+#include <QRect>
+#include <QThread>
+
+#include <atomic>
+
+class ModuleBridgeHub : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int MAX_MODULES = 8;
+
+    explicit ModuleBridgeHub(QObject *parent = nullptr);
+    ~ModuleBridgeHub() override;
+
+    /** 새 모듈용 브리지를 IPC 스레드에 만들고 listen. 실패 시 -1, 성공 시 module index */
+    int addModule(const QString &socketPath,
+                  HuProtocol::Transport transport = HuProtocol::Transport::Stream);
+    int moduleCount() const { return m_count; }
+
+    /** 이후 추가되는 브리지와 기존 브리지 모두에 적용 */
+    void setHiddenPolicy(ModuleBridge::DeliveryPolicy policy);
+
+    // ── GUI → IPC (queued) ───────────────────────────
+    void show(int index, const QRect &geometry);
+    void hide(int index);
+    void broadcastGear(GearState gear);
+    void broadcastSpeed(float kmh);
+    void broadcastBattery(float voltage, float percent);
+    void broadcastIpcStatus(bool connected);
+    /** 봉인된 blob을 모듈에 fd로 전달 (사이드 채널 미지원 모듈이면 조용히 버린다) */
+    void sendBlob(int index, quint32 kind, const HuProtocol::SharedBlobPtr &blob);
+
+signals:
+    // ── IPC → GUI (GUI 스레드에서 emit) ───────────────
+    void moduleReady(int index, quint64 winId);
+    void gearChangeRequested(int index, GearState gear, const QString &source);
+    void ambientColorChanged(int index, quint8 r, quint8 g, quint8 b, quint8 brightness);
+    void ambientOff(int index);
+    void settingsChanged(int index, const HuProtocol::SettingsDelta &delta);
+    void blobReceived(int index, quint32 kind, const HuProtocol::SharedBlobPtr &blob);
+    void slowConsumer(int index, bool slow);
+
+private:
+    // Ambient는 색상/끄기를 하나의 최신값 슬롯으로 합친다
+    struct AmbientSlot {
+        bool   on = false;
+        quint8 r = 0, g = 0, b = 0, brightness = 0;
+    };
+
+    template <typename Fn>
+    void post(Fn &&fn);
+
+    void wireBridge(int index, ModuleBridge *bridge);   // IPC 스레드에서 호출
+    void storeAmbient(int index, const AmbientSlot &slot);
+    void deliverAmbient(int index);
+
+    QThread       m_thread;
+    QObject      *m_context = nullptr;       // IPC 스레드 소속 — 브리지들의 부모
+    ModuleBridge *m_bridges[MAX_MODULES] = {};  // IPC 스레드에서만 접근
+    int           m_count = 0;
+
+    std::atomic<int> m_hiddenPolicy{ static_cast<int>(ModuleBridge::DeliveryPolicy::Coalesce) };
+
+    QMutex            m_ambientLock;
+    AmbientSlot       m_ambient[MAX_MODULES];
+    std::atomic<bool> m_ambientPending[MAX_MODULES] = {};
+};
+
+#endif // MODULEBRIDGEHUB_H
@@ -1,43 +1,97 @@
 #include "PdcBeepController.h"
 
 #include <QApplication>
+#include <QDebug>
+#include <QThread>
+
+namespace {
+constexpr int kTickMs = 10;          // fallback 간격(120 / 350 / 800 ms) 해상도
+constexpr int kIdleStopMs = 2000;    // 이만큼 무음이면 tick을 멈춘다
+}
 
 PdcBeepController::PdcBeepController(QObject *parent)
     : QObject(parent)
 {
-    connect(&m_timer, &QTimer::timeout, this, &PdcBeepController::beep);
+    m_timer.setInterval(kTickMs);
+    connect(&m_timer, &QTimer::timeout, this, &PdcBeepController::onTick);
+
+    auto tone = std::make_unique<PdcToneEngine>(PdcToneEngine::Config::fromEnvironment());
+    tone->setFailureHandler([this] {
+        QMetaObject::invokeMethod(this, "onToneEngineFailed", Qt::QueuedConnection);
+    });
+    QString error;
+    if (tone->start(&error)) {
+        qInfo() << "[PDC] tone engine on" << tone->sinkName() << "sink";
+        m_tone = std::move(tone);
+        return;
+    }
+    if (!error.isEmpty()) {
+        qWarning() << "[PDC] tone engine unavailable:" << error << "- falling back to QApplication::beep";
+    }
 }
 
+PdcBeepController::~PdcBeepController() = default;
+
 void PdcBeepController::setPdcState(const PdcState &state)
 {
-    const int interval = (!state.active || state.stale)
-        ? 0
-        : intervalForLevel(state.warningLevel);
+    setWarningLevel((!state.active || state.stale) ? PdcWarningLevel::Off : state.warningLevel);
+}
 
-    if (interval <= 0) {
-        m_timer.stop();
+void PdcBeepController::setWarningLevel(PdcWarningLevel level)
+{
+    if (m_tone) {
+        if (!m_tone->hasFailed()) {
+            m_tone->setLevel(level);
+            return;
+        }
+        // 연결이 queued로 바뀌기 전에 리더 스레드에서 들어온 호출 — 타이머는 GUI 스레드 것이다.
+        // ShellWindow가 전환 직후 현재 단계를 다시 넘긴다
+        if (QThread::currentThread() != thread()) {
+            return;
+        }
+    }
+
+    const int interval = PdcToneEngine::intervalMsForLevel(level);
+    if (interval == m_intervalMs) {
         return;
     }
+    m_intervalMs = interval;
+    if (interval <= 0) {
+        return;   // tick은 onTick()이 idle을 세다가 멈춘다
+    }
 
-    if (!m_timer.isActive() || m_timer.interval() != interval) {
-        m_timer.start(interval);
+    // 간격이 바뀌면 그 시점부터 새 간격 (예전 m_timer.start(interval)과 같은 박자)
+    m_sinceBeep.start();
+    m_idleTicks = 0;
+    if (!m_timer.isActive()) {
+        m_timer.start();
     }
 }
 
-void PdcBeepController::beep()
+void PdcBeepController::onToneEngineFailed()
 {
-    QApplication::beep();
+    if (!m_tone || !m_tone->isRunning()) {
+        return;
+    }
+    // 스레드는 이미 끝났다 — join + 통계 로그. 객체는 남겨 둔다: DirectConnection으로
+    // 리더 스레드에서 진행 중인 setWarningLevel()이 아직 m_tone을 읽고 있을 수 있다
+    m_tone->stop();
+    qWarning() << "[PDC] tone engine failed - falling back to QApplication::beep";
+    m_intervalMs = 0;
+    emit toneEngineFailed();
 }
 
-int PdcBeepController::intervalForLevel(PdcWarningLevel level) const
+void PdcBeepController::onTick()
 {
-    switch (level) {
-    case PdcWarningLevel::Near: return 800;
-    case PdcWarningLevel::Caution: return 350;
-    case PdcWarningLevel::Critical: return 120;
-    case PdcWarningLevel::Off:
-    case PdcWarningLevel::Far:
-    default:
-        return 0;
+    if (m_intervalMs <= 0) {
+        if (++m_idleTicks * kTickMs >= kIdleStopMs) {
+            m_timer.stop();
+        }
+        return;
+    }
+
+    if (m_sinceBeep.elapsed() >= m_intervalMs) {
+        m_sinceBeep.start();
+        QApplication::beep();
     }
 }
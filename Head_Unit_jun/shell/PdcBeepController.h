@@ -2,27 +2,55 @@
 #define PDCBEEPCONTROLLER_H
 
 #include "PdcTypes.h"
+#include "PdcToneEngine.h"
 
+#include <QElapsedTimer>
 #include <QObject>
 #include <QTimer>
 
+#include <memory>
+
+/**
+ * PDC 경보음. PdcToneEngine(PCM, 오디오 스레드)이 열리면 그것으로,
+ * 아니면(HU_PDC_TONE_SINK=off, 장치 없음) 예전처럼 QTimer + QApplication::beep().
+ *
+ * fallback 타이머는 단계마다 다시 start()하지 않는다 — 타이머 등록은 힙 할당이고 단계는 50 Hz로 바뀔 수 있다.
+ * 10 ms tick 하나를 계속 돌리며 마지막 beep 이후 경과 시간을 현재 간격과 비교하고,
+ * Off가 2 s 이어지면 tick 스스로 멈춘다 (다시 켤 때만 start()).
+ */
 class PdcBeepController : public QObject
 {
     Q_OBJECT
 
 public:
     explicit PdcBeepController(QObject *parent = nullptr);
+    ~PdcBeepController() override;
+
+    /** tone engine이 돌고 있으면 setWarningLevel()을 아무 스레드에서 불러도 된다 (writer 하나) */
+    bool acceptsLevelFromAnyThread() const { return m_tone && !m_tone->hasFailed(); }
+
+signals:
+    /**
+     * tone engine 오디오 스레드가 sink 오류로 끝났다 — 이제 QApplication::beep() 경로.
+     * 이 시점부터 setWarningLevel()은 GUI 스레드에서만 받는다 (연결을 queued로 바꿀 것).
+     */
+    void toneEngineFailed();
 
 public slots:
     void setPdcState(const PdcState &state);
+    /** provider 리더 스레드가 계산한 단계 (이미 후진/차속/stale 반영) */
+    void setWarningLevel(PdcWarningLevel level);
 
 private slots:
-    void beep();
+    void onTick();
+    void onToneEngineFailed();
 
 private:
-    int intervalForLevel(PdcWarningLevel level) const;
-
+    std::unique_ptr<PdcToneEngine> m_tone;
     QTimer m_timer;
+    QElapsedTimer m_sinceBeep;
+    int m_intervalMs = 0;       // 0 = 무음
+    int m_idleTicks = 0;
 };
 
 #endif // PDCBEEPCONTROLLER_H
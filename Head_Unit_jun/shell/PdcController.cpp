@@ -1,31 +1,52 @@
 #include "PdcController.h"
 
+#include "CanBatchReader.h"
 #include "IPdcSensorProvider.h"
+#include "PdcWarning.h"
 
 #include <QDebug>
-#include <limits>
+
+#include <cstdio>
+#include <cstring>
 
 PdcController::PdcController(IPdcSensorProvider *provider, QObject *parent)
     : QObject(parent)
     , m_provider(provider)
 {
+    qRegisterMetaType<PdcWarningLevel>("PdcWarningLevel");
     qRegisterMetaType<PdcState>("PdcState");
-    qRegisterMetaType<QVector<PdcSensorReading>>("QVector<PdcSensorReading>");
+    qRegisterMetaType<PdcSample>("PdcSample");
 
-    m_staleTimer.setSingleShot(true);
-    m_staleTimer.setInterval(kStaleTimeoutMs);
-    connect(&m_staleTimer, &QTimer::timeout, this, &PdcController::markStale);
+    // 프레임마다 single-shot 타이머를 재시작하면 dispatcher가 매번 타이머를 새로 등록(할당)한다.
+    // 대신 주기 타이머 하나로 마지막 수신 시각을 검사하고, stale이 되면 멈춘다.
+    m_staleTimer.setInterval(kStaleCheckMs);
+    connect(&m_staleTimer, &QTimer::timeout, this, &PdcController::checkStale);
 
     if (m_provider) {
         m_provider->setParent(this);
-        connect(m_provider, &IPdcSensorProvider::readingsChanged,
-                this, &PdcController::onReadingsChanged);
+        connect(m_provider, &IPdcSensorProvider::sampleReady,
+                this, &PdcController::onSampleReady);
         connect(m_provider, &IPdcSensorProvider::faultChanged,
                 this, &PdcController::onProviderFault);
         m_provider->start();
     }
 }
 
+PdcController::~PdcController()
+{
+    for (int i = 0; i < kPdcSensorCount; ++i) {
+        const PdcSensorHealth &h = m_sensors.health(i);
+        if (h.readings == 0) {
+            continue;
+        }
+        qInfo() << "[PDC]" << pdcSensorName(static_cast<PdcSensor>(i))
+                << "readings" << h.readings << "dropouts" << h.dropouts
+                << "out-of-range" << QStringLiteral("%1%").arg(h.outOfRangeRate() * 100.0, 0, 'f', 1)
+                << "reported invalid" << h.reportedInvalid
+                << "interval" << h.meanIntervalMs << "ms jitter" << h.jitterMs << "ms max" << h.maxIntervalMs << "ms";
+    }
+}
+
 void PdcController::setActive(bool active)
 {
     if (m_state.active == active) {
@@ -37,64 +58,163 @@ void PdcController::setActive(bool active)
         m_state.warningLevel = PdcWarningLevel::Off;
         m_state.nearestDistanceCm = -1.0f;
     }
+    if (m_provider) {
+        m_provider->setWarningGate(active, m_vehicleSpeedKmh);
+    }
     publishState();
 }
 
 void PdcController::setVehicleSpeed(float kmh)
 {
     m_vehicleSpeedKmh = kmh;
+    m_filter.setVehicleSpeed(kmh);
+    if (m_provider) {
+        m_provider->setWarningGate(m_state.active, kmh);
+    }
 }
 
-void PdcController::onReadingsChanged(const QVector<PdcSensorReading> &readings)
+void PdcController::onSampleReady(const PdcSample &sample)
 {
-    m_state.rearSensors = readings;
-    m_state.stale = false;
-    m_state.fault.clear();
+    // 센서 시각이 CLOCK_REALTIME이므로 같은 시계로 나이를 잰다
+    const quint64 nowNs = CanBatchReader::realtimeNowNs();
+    m_state.dataAgeUs = -1;
+    if (sample.timestampNs > 0) {
+        const quint64 ageNs = nowNs > sample.timestampNs ? nowNs - sample.timestampNs : 0;
+        m_dataAge.add(ageNs);
+        m_state.dataAgeUs = static_cast<qint64>(ageNs / 1000);
+    }
 
-    float nearest = std::numeric_limits<float>::max();
-    for (const PdcSensorReading &reading : readings) {
-        if (reading.valid && reading.distanceCm < nearest) {
-            nearest = reading.distanceCm;
+    // 센서별 deadline은 측정 시각 기준 — 시각이 없거나(mock 등) 미래면 지금
+    const quint64 readingNs = (sample.timestampNs > 0 && sample.timestampNs <= nowNs)
+        ? sample.timestampNs : nowNs;
+    m_sensors.update(sample, readingNs);
+    m_filter.update(sample, nowNs);
+    expireSensors(nowNs);   // 이미 timeout이 지난 늦은 측정은 여기서 바로 빠진다
+    if (m_sensors.aliveMask() == 0) {
+        // 살아 있는 센서 없음 (전부 invalid 보고 / 너무 늦은 프레임) — 프레임이 왔어도 stale
+        if (!m_state.stale) {
+            markStale();
         }
+        return;
     }
 
-    if (nearest == std::numeric_limits<float>::max()) {
-        m_state.nearestDistanceCm = -1.0f;
-        m_state.warningLevel = PdcWarningLevel::Off;
-    } else {
-        m_state.nearestDistanceCm = nearest;
-        const bool speedAllowsAlert = (m_vehicleSpeedKmh <= kMaxActiveSpeedKmh);
-        m_state.warningLevel = (m_state.active && speedAllowsAlert)
-            ? levelForDistance(nearest)
-            : PdcWarningLevel::Off;
-    }
+    m_state.rear.timestampNs = sample.timestampNs;
+    m_state.rear.outOfRangeMask = sample.outOfRangeMask;
+    m_state.stale = false;
+    m_providerFault = false;
+    refreshSensorState();
+    updateEstimate(nowNs);
 
-    m_staleTimer.start();
+    if (!m_staleTimer.isActive()) {
+        m_staleTimer.start();
+    }
     publishState();
 }
 
 void PdcController::onProviderFault(const QString &message)
 {
     qWarning() << "[PDC]" << message;
-    m_state.fault = message;
+    const QByteArray utf8 = message.toUtf8();
+    const size_t len = qMin(static_cast<size_t>(utf8.size()), m_state.fault.size() - 1);
+    std::memcpy(m_state.fault.data(), utf8.constData(), len);
+    m_state.fault[len] = '\0';
+    m_providerFault = true;
     markStale();
 }
 
+void PdcController::checkStale()
+{
+    const quint64 nowNs = CanBatchReader::realtimeNowNs();
+    const quint8 expired = expireSensors(nowNs);
+    if (m_sensors.aliveMask() == 0) {
+        markStale();
+        return;
+    }
+
+    // 일부 센서만 끊겼으면 나머지로 계속 — 프레임 사이에도 예측 거리가 경계를 넘으면
+    // 다음 프레임을 기다리지 않고 올린다
+    if (expired) {
+        refreshSensorState();
+    }
+    if (updateEstimate(nowNs) || expired) {
+        publishState();
+    }
+}
+
+quint8 PdcController::expireSensors(quint64 nowNs)
+{
+    const quint8 expired = m_sensors.expire(nowNs);
+    if (!expired) {
+        return 0;
+    }
+
+    const quint8 alive = m_sensors.aliveMask();
+    for (int i = 0; i < kPdcSensorCount; ++i) {
+        if (!((expired >> i) & 1u)) {
+            continue;
+        }
+        m_filter.dropSensor(i);
+        if (alive) {
+            qWarning() << "[PDC]" << pdcSensorName(static_cast<PdcSensor>(i))
+                       << "timed out; continuing with sensors" << QStringLiteral("0x%1").arg(alive, 0, 16);
+        }
+    }
+    return expired;
+}
+
+void PdcController::refreshSensorState()
+{
+    const quint8 fresh = m_sensors.freshMask();
+    for (int i = 0; i < kPdcSensorCount; ++i) {
+        m_state.rear.distanceCm[i] = ((fresh >> i) & 1u) ? m_sensors.distanceCm(i) : -1.0f;
+    }
+    m_state.rear.validMask = fresh;
+    m_state.rear.outOfRangeMask &= m_sensors.aliveMask();
+    m_state.staleSensorMask = m_sensors.staleMask();
+
+    if (m_providerFault) {
+        return;
+    }
+    // 일부 센서만 끊겼을 때만 문구 — 전부 끊기면 stale 표시로 충분하다
+    m_state.fault[0] = '\0';
+    const quint8 stale = m_state.staleSensorMask;
+    if (stale == 0 || stale == PdcSensorMonitor::kAllSensors) {
+        return;
+    }
+    int len = std::snprintf(m_state.fault.data(), m_state.fault.size(), "no data:");
+    for (int i = 0; i < kPdcSensorCount && len > 0 && len < static_cast<int>(m_state.fault.size()); ++i) {
+        if ((stale >> i) & 1u) {
+            len += std::snprintf(m_state.fault.data() + len, m_state.fault.size() - static_cast<size_t>(len),
+                                 " %s", pdcSensorName(static_cast<PdcSensor>(i)));
+        }
+    }
+}
+
 void PdcController::markStale()
 {
+    m_staleTimer.stop();
+    m_sensors.expireAll();
+    refreshSensorState();
     m_state.stale = true;
     m_state.nearestDistanceCm = -1.0f;
+    m_state.closingSpeedCmS = 0.0f;
+    m_state.timeToCollisionS = -1.0f;
     m_state.warningLevel = PdcWarningLevel::Off;
+    m_filter.reset();
     publishState();
 }
 
-PdcWarningLevel PdcController::levelForDistance(float distanceCm) const
+bool PdcController::updateEstimate(quint64 nowNs)
 {
-    if (distanceCm < 0.0f) return PdcWarningLevel::Off;
-    if (distanceCm < 30.0f) return PdcWarningLevel::Critical;
-    if (distanceCm < 60.0f) return PdcWarningLevel::Caution;
-    if (distanceCm < 120.0f) return PdcWarningLevel::Near;
-    return PdcWarningLevel::Far;
+    // RT 리더 스레드(SocketCanPdcProvider)와 같은 필터 / 경고 함수로 계산한다
+    const PdcFilter::Estimate estimate = m_filter.estimate(nowNs);
+    const PdcWarningLevel previous = m_state.warningLevel;
+    m_state.nearestDistanceCm = estimate.nearestCm;
+    m_state.closingSpeedCmS = estimate.closingCmS;
+    m_state.timeToCollisionS = estimate.timeToCollisionS;
+    m_state.warningLevel = PdcWarning::gatedLevel(
+        PdcWarning::levelForDistance(estimate.warningCm), m_state.active, m_vehicleSpeedKmh);
+    return m_state.warningLevel != previous;
 }
 
 void PdcController::publishState()
@@ -2,6 +2,9 @@
 #define PDCCONTROLLER_H
 
 #include "PdcTypes.h"
+#include "PdcFilter.h"
+#include "PdcSensorMonitor.h"
+#include "LatencyHistogram.h"
 
 #include <QObject>
 #include <QTimer>
@@ -14,8 +17,14 @@ class PdcController : public QObject
 
 public:
     explicit PdcController(IPdcSensorProvider *provider, QObject *parent = nullptr);
+    ~PdcController() override;
 
     const PdcState &state() const { return m_state; }
+    IPdcSensorProvider *provider() const { return m_provider; }
+    /** 센서 데이터 나이 (센서 수신 → onSampleReady) 분포 */
+    const HuProtocol::LatencyHistogram &dataAge() const { return m_dataAge; }
+    /** 센서별 신선도 / 건강 카운터 (dropout, 범위 밖 비율, 간격 jitter) */
+    const PdcSensorMonitor &sensors() const { return m_sensors; }
     void setActive(bool active);
     void setVehicleSpeed(float kmh);
 
@@ -23,21 +32,30 @@ signals:
     void stateChanged(const PdcState &state);
 
 private slots:
-    void onReadingsChanged(const QVector<PdcSensorReading> &readings);
+    void onSampleReady(const PdcSample &sample);
     void onProviderFault(const QString &message);
-    void markStale();
+    void checkStale();
 
 private:
-    PdcWarningLevel levelForDistance(float distanceCm) const;
+    void markStale();
+    /** 센서 timeout 처리 — 끊긴 센서의 필터 트랙을 비운다. 이번에 끊긴 센서 mask 반환 */
+    quint8 expireSensors(quint64 nowNs);
+    /** m_sensors → m_state.rear (Fresh 센서만 유효) / staleSensorMask / fault 문구 */
+    void refreshSensorState();
+    /** 필터 추정으로 nearest / TTC / warning level 갱신 — level이 바뀌면 true */
+    bool updateEstimate(quint64 nowNs);
     void publishState();
 
     IPdcSensorProvider *m_provider = nullptr;
     PdcState m_state;
     QTimer m_staleTimer;
+    HuProtocol::LatencyHistogram m_dataAge;
+    PdcFilter m_filter;
+    PdcSensorMonitor m_sensors;
     float m_vehicleSpeedKmh = 0.0f;
+    bool m_providerFault = false;   // fault 문구가 provider 것이면 센서 문구로 덮지 않는다
 
-    static constexpr float kMaxActiveSpeedKmh = 10.0f;
-    static constexpr int kStaleTimeoutMs = 450;
+    static constexpr int kStaleCheckMs = static_cast<int>(PdcSensorMonitor::kTickNs / 1000000);
 };
 
 #endif // PDCCONTROLLER_H
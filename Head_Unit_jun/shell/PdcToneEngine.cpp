@@ -0,0 +1,458 @@
+/**
+ * @file PdcToneEngine.cpp
+ * @brief PdcToneEngine 구현 — 미리 렌더링한 chirp를 오디오 스레드에서 sink에 쓴다
+ *
+ * Sink: ALSA (HU_PCM_ALSA_AVAILABLE), WAV 파일, null — file/null은 장치처럼 실시간 속도로 쓴다.
+ */
+
+#include "PdcToneEngine.h"
+
+#include <QDebug>
+
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+#ifdef HU_PCM_ALSA_AVAILABLE
+#include <alsa/asoundlib.h>
+#endif
+
+namespace {
+constexpr int kChirpMs = 50;
+constexpr int kFadeMs = 5;                  // 앞뒤 raised-cosine — 클릭 방지
+constexpr int kMinGapMs = 20;               // chirp 사이 최소 무음 (단계가 올라갈 때)
+constexpr double kChirpHz = 2000.0;
+constexpr double kAmplitude = 0.5;
+
+quint64 framesToNs(qint64 frames, int rate)
+{
+    return frames > 0 ? quint64(frames) * 1000000000ull / quint64(rate) : 0;
+}
+} // namespace
+
+// ── Sink ────────────────────────────────────────────────────────────────
+
+class PcmSink
+{
+public:
+    virtual ~PcmSink() = default;
+    virtual bool open(const QString &target, int rate, int periodFrames, QString *error) = 0;
+    virtual void close() = 0;
+    /** frames 전부 쓸 때까지 막는다 (device 속도). 실패하면 false */
+    virtual bool write(const qint16 *samples, int frames) = 0;
+    /** 써 놓고 아직 재생되지 않은 frame 수 — 방금 쓴 period 포함 */
+    virtual qint64 delayFrames() = 0;
+    virtual const char *name() const = 0;
+
+    int periodFrames() const { return m_periodFrames; }
+    quint64 underruns() const { return m_underruns; }
+
+protected:
+    int m_periodFrames = 0;
+    quint64 m_underruns = 0;
+};
+
+namespace {
+
+#ifdef HU_PCM_ALSA_AVAILABLE
+class AlsaSink : public PcmSink
+{
+public:
+    ~AlsaSink() override { close(); }
+
+    bool open(const QString &device, int rate, int periodFrames, QString *error) override
+    {
+        int rc = snd_pcm_open(&m_pcm, device.toLocal8Bit().constData(), SND_PCM_STREAM_PLAYBACK, 0);
+        if (rc == 0) {
+            // 버퍼 = 2 period — 깨어나는 지터만 흡수하고 지연은 최소로
+            const unsigned int latencyUs = unsigned(2ull * periodFrames * 1000000ull / unsigned(rate));
+            rc = snd_pcm_set_params(m_pcm, SND_PCM_FORMAT_S16_LE, SND_PCM_ACCESS_RW_INTERLEAVED,
+                                    1, unsigned(rate), 1, latencyUs);
+        }
+        snd_pcm_uframes_t buffer = 0;
+        snd_pcm_uframes_t period = 0;
+        if (rc == 0) {
+            rc = snd_pcm_get_params(m_pcm, &buffer, &period);
+        }
+        if (rc < 0) {
+            if (error) *error = QStringLiteral("ALSA %1: %2").arg(device, QString::fromLocal8Bit(snd_strerror(rc)));
+            close();
+            return false;
+        }
+        m_periodFrames = int(period);
+        qInfo() << "[PDC] tone sink ALSA" << device << "period" << period << "buffer" << buffer << "frames";
+        return true;
+    }
+
+    void close() override
+    {
+        if (m_pcm) {
+            snd_pcm_drop(m_pcm);
+            snd_pcm_close(m_pcm);
+            m_pcm = nullptr;
+        }
+    }
+
+    bool write(const qint16 *samples, int frames) override
+    {
+        while (frames > 0) {
+            snd_pcm_sframes_t n = snd_pcm_writei(m_pcm, samples, snd_pcm_uframes_t(frames));
+            if (n < 0) {
+                ++m_underruns;
+                n = snd_pcm_recover(m_pcm, int(n), 1);
+                if (n < 0) {
+                    return false;
+                }
+                continue;
+            }
+            samples += n;
+            frames -= int(n);
+        }
+        return true;
+    }
+
+    qint64 delayFrames() override
+    {
+        snd_pcm_sframes_t delay = 0;
+        return snd_pcm_delay(m_pcm, &delay) == 0 ? qint64(delay) : 0;
+    }
+
+    const char *name() const override { return "alsa"; }
+
+private:
+    snd_pcm_t *m_pcm = nullptr;
+};
+#endif
+
+/**
+ * 실제 장치처럼 2 period 버퍼를 흉내 낸다: 재생은 first write부터 rate 속도로 진행되고,
+ * write는 버퍼에 한 period 자리가 날 때까지 잔다. 늦으면 underrun으로 세고 다시 시작.
+ */
+class PacedSink : public PcmSink
+{
+public:
+    bool open(const QString &, int rate, int periodFrames, QString *) override
+    {
+        m_rate = rate;
+        m_periodFrames = periodFrames;
+        m_written = 0;
+        m_startNs = 0;
+        return true;
+    }
+
+    void close() override {}
+
+    bool write(const qint16 *samples, int frames) override
+    {
+        const quint64 now = HuProtocol::monotonicNowNs();
+        if (m_startNs == 0 || playedFrames(now) > m_written) {
+            if (m_startNs != 0) ++m_underruns;
+            m_startNs = now;
+            m_written = 0;
+        }
+        // 버퍼(2 period)에 frames 자리가 날 때까지
+        const qint64 mustPlay = m_written + frames - 2 * m_periodFrames;
+        if (mustPlay > 0) {
+            const quint64 wakeNs = m_startNs + framesToNs(mustPlay, m_rate);
+            timespec ts;
+            ts.tv_sec = time_t(wakeNs / 1000000000ull);
+            ts.tv_nsec = long(wakeNs % 1000000000ull);
+            while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {}
+        }
+        m_written += frames;
+        return consume(samples, frames);
+    }
+
+    qint64 delayFrames() override
+    {
+        return qMax<qint64>(0, m_written - playedFrames(HuProtocol::monotonicNowNs()));
+    }
+
+    const char *name() const override { return "null"; }
+
+protected:
+    virtual bool consume(const qint16 *, int) { return true; }
+
+private:
+    qint64 playedFrames(quint64 nowNs) const
+    {
+        return qint64((nowNs - m_startNs) * quint64(m_rate) / 1000000000ull);
+    }
+
+    int m_rate = 48000;
+    qint64 m_written = 0;
+    quint64 m_startNs = 0;
+};
+
+/** 16-bit mono WAV — 크기 필드는 close()에서 채운다 */
+class WavFileSink : public PacedSink
+{
+public:
+    ~WavFileSink() override { close(); }
+
+    bool open(const QString &path, int rate, int periodFrames, QString *error) override
+    {
+        m_file = std::fopen(path.toLocal8Bit().constData(), "wb");
+        if (!m_file) {
+            if (error) *error = QStringLiteral("%1: %2").arg(path, QString::fromLocal8Bit(std::strerror(errno)));
+            return false;
+        }
+        m_dataBytes = 0;
+        writeHeader(rate);
+        qInfo() << "[PDC] tone sink WAV" << path;
+        return PacedSink::open(path, rate, periodFrames, error);
+    }
+
+    void close() override
+    {
+        if (!m_file) {
+            return;
+        }
+        std::fseek(m_file, 0, SEEK_SET);
+        writeHeader(m_sampleRate);
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+
+    const char *name() const override { return "file"; }
+
+protected:
+    bool consume(const qint16 *samples, int frames) override
+    {
+        const size_t n = std::fwrite(samples, sizeof(qint16), size_t(frames), m_file);
+        m_dataBytes += quint32(n * sizeof(qint16));
+        return n == size_t(frames);
+    }
+
+private:
+    void writeHeader(int rate)
+    {
+        m_sampleRate = rate;
+        auto put32 = [this](quint32 v) {
+            const quint8 b[4] = { quint8(v), quint8(v >> 8), quint8(v >> 16), quint8(v >> 24) };
+            std::fwrite(b, 1, 4, m_file);
+        };
+        auto put16 = [this](quint16 v) {
+            const quint8 b[2] = { quint8(v), quint8(v >> 8) };
+            std::fwrite(b, 1, 2, m_file);
+        };
+        std::fwrite("RIFF", 1, 4, m_file);
+        put32(36 + m_dataBytes);
+        std::fwrite("WAVEfmt ", 1, 8, m_file);
+        put32(16);
+        put16(1);                           // PCM
+        put16(1);                           // mono
+        put32(quint32(rate));
+        put32(quint32(rate) * 2);
+        put16(2);
+        put16(16);
+        std::fwrite("data", 1, 4, m_file);
+        put32(m_dataBytes);
+    }
+
+    std::FILE *m_file = nullptr;
+    quint32 m_dataBytes = 0;
+    int m_sampleRate = 48000;
+};
+
+} // namespace
+
+// ── PdcToneEngine ───────────────────────────────────────────────────────
+
+PdcToneEngine::Config PdcToneEngine::Config::fromEnvironment()
+{
+    Config cfg;
+    cfg.sink = qEnvironmentVariable("HU_PDC_TONE_SINK").trimmed();
+    const QString device = qEnvironmentVariable("HU_PDC_TONE_DEVICE").trimmed();
+    if (!device.isEmpty())
+        cfg.device = device;
+    cfg.realtime = RealtimeThreadConfig::fromEnvironment("HU_PDC_TONE_RT");
+    return cfg;
+}
+
+PdcToneEngine::PdcToneEngine(const Config &config)
+    : m_config(config)
+{
+}
+
+PdcToneEngine::~PdcToneEngine()
+{
+    stop();
+}
+
+QString PdcToneEngine::sinkName() const
+{
+    return m_sink ? QString::fromLatin1(m_sink->name()) : QString();
+}
+
+bool PdcToneEngine::start(QString *error)
+{
+    if (isRunning()) {
+        return true;
+    }
+
+    QString kind = m_config.sink.toLower();
+    QString target = m_config.device;
+    if (kind == QStringLiteral("off")) {
+        return false;
+    }
+    if (kind.startsWith(QStringLiteral("file:"))) {
+        target = m_config.sink.mid(5);
+        m_sink.reset(new WavFileSink);
+    } else if (kind == QStringLiteral("null")) {
+        m_sink.reset(new PacedSink);
+#ifdef HU_PCM_ALSA_AVAILABLE
+    } else if (kind.isEmpty() || kind == QStringLiteral("alsa")) {
+        m_sink.reset(new AlsaSink);
+#endif
+    } else {
+        if (error) *error = QStringLiteral("tone sink '%1' not available in this build").arg(m_config.sink);
+        return false;
+    }
+
+    const int periodFrames = qMax(32, m_config.sampleRate / 1000 * m_config.periodUs / 1000);
+    if (!m_sink->open(target, m_config.sampleRate, periodFrames, error)) {
+        m_sink.reset();
+        return false;
+    }
+
+    // chirp: kChirpHz 사인파, 앞뒤 kFadeMs raised-cosine
+    const int rate = m_config.sampleRate;
+    const int frames = rate * kChirpMs / 1000;
+    const int fade = rate * kFadeMs / 1000;
+    m_chirp.resize(size_t(frames));
+    for (int i = 0; i < frames; ++i) {
+        double gain = 1.0;
+        const int edge = qMin(i, frames - 1 - i);
+        if (edge < fade) {
+            gain = 0.5 - 0.5 * std::cos(M_PI * edge / fade);
+        }
+        m_chirp[size_t(i)] = qint16(std::lround(32767.0 * kAmplitude * gain
+                                                * std::sin(2.0 * M_PI * kChirpHz * i / rate)));
+    }
+
+    m_onset.clear();
+    m_stats = Stats();
+    m_failed.store(false, std::memory_order_release);
+    m_running.store(true, std::memory_order_release);
+    m_thread = std::thread(&PdcToneEngine::run, this);
+    return true;
+}
+
+void PdcToneEngine::stop()
+{
+    if (!m_thread.joinable()) {
+        return;
+    }
+
+    m_running.store(false, std::memory_order_release);
+    m_thread.join();
+    m_stats.underruns = m_sink->underruns();
+    m_sink->close();
+
+    qInfo() << "[PDC] tone engine stopped:" << m_stats.chirps << "chirps," << m_stats.underruns
+            << "underruns, onset latency p50" << m_onset.percentileUs(0.5) << "us p99"
+            << m_onset.percentileUs(0.99) << "us (" << m_onset.count() << "samples)";
+}
+
+void PdcToneEngine::setLevel(PdcWarningLevel level)
+{
+    if (level == m_lastLevel) {
+        return;
+    }
+    m_lastLevel = level;
+
+    LevelRequest request;
+    request.serial = ++m_serial;
+    request.level = level;
+    request.requestedNs = HuProtocol::monotonicNowNs();
+    m_request.store(request);
+}
+
+int PdcToneEngine::intervalMsForLevel(PdcWarningLevel level)
+{
+    switch (level) {
+    case PdcWarningLevel::Near: return 800;
+    case PdcWarningLevel::Caution: return 350;
+    case PdcWarningLevel::Critical: return 120;
+    case PdcWarningLevel::Off:
+    case PdcWarningLevel::Far:
+    default:
+        return 0;
+    }
+}
+
+void PdcToneEngine::run()
+{
+    m_config.realtime.applyToCurrentThread("[PDC tone]");
+
+    const int rate = m_config.sampleRate;
+    const int period = m_sink->periodFrames();
+    const qint64 chirpFrames = qint64(m_chirp.size());
+    const qint64 minGapFrames = qint64(kMinGapMs) * rate / 1000;
+    std::vector<qint16> buffer(size_t(period), 0);   // 루프 안에서는 할당 없음
+
+    quint32 seenSerial = 0;
+    qint64 intervalFrames = 0;     // 0 = 무음
+    qint64 nextStart = 0;          // cyclePos가 여기 닿으면 다음 chirp
+    qint64 cyclePos = chirpFrames; // 현재 chirp 시작부터의 frame (chirp 끝 = 무음)
+    quint64 pendingOnsetNs = 0;    // 첫 chirp를 기다리는 요청 시각
+
+    while (m_running.load(std::memory_order_acquire)) {
+        const LevelRequest request = m_request.load();
+        if (request.serial != seenSerial) {
+            seenSerial = request.serial;
+            const qint64 next = qint64(intervalMsForLevel(request.level)) * rate / 1000;
+            const bool escalate = next > 0 && (intervalFrames == 0 || next < intervalFrames);
+            if (escalate) {
+                // 무음 중이면 이 period 첫 frame에서, chirp 재생 중이면 끝난 뒤 최소 간격 후에
+                pendingOnsetNs = request.requestedNs;
+                nextStart = cyclePos >= chirpFrames ? cyclePos : chirpFrames + minGapFrames;
+            } else if (next == 0) {
+                pendingOnsetNs = 0;
+            } else {
+                nextStart = next;      // 느려짐 — 현재 chirp 기준 새 간격
+            }
+            intervalFrames = next;
+        }
+
+        int onsetOffset = -1;
+        for (int i = 0; i < period; ++i) {
+            if (intervalFrames > 0 && cyclePos >= nextStart) {
+                cyclePos = 0;
+                nextStart = intervalFrames;
+                ++m_stats.chirps;
+                if (pendingOnsetNs && onsetOffset < 0) {
+                    onsetOffset = i;
+                }
+            }
+            buffer[size_t(i)] = cyclePos < chirpFrames ? m_chirp[size_t(cyclePos)] : 0;
+            if (intervalFrames > 0 || cyclePos < chirpFrames) {
+                ++cyclePos;    // Off여도 재생 중인 chirp는 끝까지 (클릭 방지)
+            }
+        }
+
+        if (!m_sink->write(buffer.data(), period)) {
+            qWarning() << "[PDC] tone sink write failed; audio thread stopping";
+            m_failed.store(true, std::memory_order_release);
+            if (m_onFailure) {
+                m_onFailure();
+            }
+            break;
+        }
+        ++m_stats.periods;
+
+        if (onsetOffset >= 0) {
+            // 방금 쓴 period의 첫 frame은 (delay - period) frame 뒤에 재생된다
+            const quint64 nowNs = HuProtocol::monotonicNowNs();
+            const qint64 ahead = qMax<qint64>(0, m_sink->delayFrames() - period) + onsetOffset;
+            const quint64 onsetNs = nowNs + framesToNs(ahead, rate);
+            if (onsetNs > pendingOnsetNs) {
+                m_onset.add(onsetNs - pendingOnsetNs);
+            }
+            pendingOnsetNs = 0;
+        }
+    }
+}
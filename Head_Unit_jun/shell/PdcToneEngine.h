@@ -0,0 +1,103 @@
+/**
+ * @file PdcToneEngine.h
+ * @brief PDC 경보음 엔진 — 미리 렌더링한 PCM chirp를 오디오 스레드에서 sample 단위 간격으로 출력
+ *
+ * QApplication::beep()는 대부분 no-op이거나 윈도 시스템을 거쳐 지연을 알 수 없다.
+ * 이 엔진은:
+ *   - 전용 스레드가 period(기본 5 ms)마다 PCM을 렌더링해 sink에 쓴다 — 간격은 frame 수로 센다
+ *   - setLevel()은 아무 스레드에서나 (writer는 하나) — SeqLockSlot으로 넘기고, 오디오 스레드는
+ *     period 시작마다 읽는다. 단계가 올라가면 다음 period에 chirp를 시작하고(재생 중인 chirp가
+ *     있으면 끝난 뒤 20 ms), 내려가면 현재 chirp 기준으로 새 간격을 적용한다 (어느 쪽이든 한 간격 안)
+ *   - 요청 시각 → 그 요청의 첫 chirp가 DAC에 닿는 시각을 onsetLatency()에 기록
+ *
+ * Sink (HU_PDC_TONE_SINK):
+ *   alsa (기본, ALSA로 빌드됐을 때) — HU_PDC_TONE_DEVICE (기본 "default")
+ *   file:<path>                      — 16-bit mono WAV, 실시간 속도로 기록 (테스트용)
+ *   null                             — 실시간 속도로 버림 (지연 측정 / 벤치마크)
+ *   off                              — 엔진 끔 → PdcBeepController가 QApplication::beep()으로 대체
+ * 오디오 스레드 스케줄링: HU_PDC_TONE_RT_PRIORITY / _CPU / _MLOCK (RealtimeThread.h)
+ */
+
+#ifndef PDCTONEENGINE_H
+#define PDCTONEENGINE_H
+
+#include "PdcTypes.h"
+#include "LatencyHistogram.h"
+#include "RealtimeThread.h"
+#include "SeqLockSlot.h"
+
+#include <QString>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+class PcmSink;
+
+class PdcToneEngine
+{
+public:
+    struct Config {
+        QString sink;                 // 비어 있으면 alsa (없으면 null)
+        QString device = QStringLiteral("default");
+        int sampleRate = 48000;
+        int periodUs = 5000;
+        RealtimeThreadConfig realtime;
+
+        static Config fromEnvironment();
+    };
+
+    struct Stats {
+        quint64 periods = 0;
+        quint64 chirps = 0;
+        quint64 underruns = 0;        // ALSA xrun 복구 횟수
+    };
+
+    explicit PdcToneEngine(const Config &config);
+    ~PdcToneEngine();
+
+    /** sink를 열고 오디오 스레드 시작. "off"면 false (error 비움) */
+    bool start(QString *error = nullptr);
+    void stop();
+    bool isRunning() const { return m_thread.joinable(); }
+    /** sink 쓰기 실패로 오디오 스레드가 끝났다 — 이후 setLevel()은 아무 소리도 내지 않는다 */
+    bool hasFailed() const { return m_failed.load(std::memory_order_acquire); }
+    /** start() 전에 설정 — 오디오 스레드가 실패로 끝날 때 그 스레드에서 한 번 호출된다 */
+    void setFailureHandler(std::function<void()> handler) { m_onFailure = std::move(handler); }
+    QString sinkName() const;
+
+    /** 아무 스레드에서나 호출 (동시에 부르는 writer는 하나) — 할당/락 없음, 같은 단계는 무시 */
+    void setLevel(PdcWarningLevel level);
+
+    static int intervalMsForLevel(PdcWarningLevel level);
+
+    /** 아래 두 값은 오디오 스레드가 쓴다 — stop() 후에 읽는다 */
+    const HuProtocol::LatencyHistogram &onsetLatency() const { return m_onset; }
+    const Stats &stats() const { return m_stats; }
+
+private:
+    struct LevelRequest {
+        quint32 serial = 0;
+        PdcWarningLevel level = PdcWarningLevel::Off;
+        quint64 requestedNs = 0;      // CLOCK_MONOTONIC
+    };
+
+    void run();   // 오디오 스레드
+
+    Config m_config;
+    std::unique_ptr<PcmSink> m_sink;
+    std::vector<qint16> m_chirp;      // 미리 렌더링 (start 전에)
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+    std::atomic<bool> m_failed{false};
+    std::function<void()> m_onFailure;
+    HuProtocol::SeqLockSlot<LevelRequest> m_request;
+    quint32 m_serial = 0;             // writer 전용
+    PdcWarningLevel m_lastLevel = PdcWarningLevel::Off;   // writer 전용
+    HuProtocol::LatencyHistogram m_onset;
+    Stats m_stats;
+};
+
+#endif // PDCTONEENGINE_H
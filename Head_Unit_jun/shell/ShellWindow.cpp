@@ -4,7 +4,7 @@
  *
  * hu_shell = Wayland Compositor (HUCompositor)
  * 6개 모듈 = 독립 Wayland 클라이언트 프로세스 (ModuleController 감시)
- * IPC = ModuleBridge Unix 소켓 (gear/speed/battery/settings)
+ * IPC = ModuleBridge Unix 소켓 (gear/speed/battery/settings), ModuleBridgeHub의 IPC 스레드에서 처리
  * HU↔IC = VSomeIP (VSomeIPClient)
  */
 
@@ -31,7 +31,7 @@
 #include <QGuiApplication>
 #endif
 #include "ModuleController.h"
-#include "ModuleBridge.h"
+#include "ModuleBridgeHub.h"
 
 #include <QVBoxLayout>
 #include <QWidget>
@@ -62,6 +62,26 @@ constexpr ModuleInfo kModules[] = {
     { "settings",   "hu_module_settings",  "settings"   },
 };
 
+ModuleBridge::DeliveryPolicy hiddenDeliveryPolicy()
+{
+    const QString policy = qEnvironmentVariable("HU_HIDDEN_DELIVERY").trimmed().toLower();
+    if (policy == QStringLiteral("immediate")) return ModuleBridge::DeliveryPolicy::Immediate;
+    if (policy == QStringLiteral("park"))      return ModuleBridge::DeliveryPolicy::ParkUntilShow;
+    return ModuleBridge::DeliveryPolicy::Coalesce;
+}
+
+/** HU_IPC_SEQPACKET=all 또는 "media,navigation"처럼 SOCK_SEQPACKET을 켤 모듈 목록 */
+HuProtocol::Transport moduleTransport(const char *socketSuffix)
+{
+    const QString list = qEnvironmentVariable("HU_IPC_SEQPACKET").trimmed().toLower();
+    if (list == QStringLiteral("all"))
+        return HuProtocol::Transport::SeqPacket;
+    for (const QString &name : list.split(','))
+        if (name.trimmed() == QLatin1String(socketSuffix))
+            return HuProtocol::Transport::SeqPacket;
+    return HuProtocol::Transport::Stream;
+}
+
 IPdcSensorProvider *createPdcProvider()
 {
     const QString provider = qEnvironmentVariable("HU_PDC_PROVIDER").trimmed().toLower();
@@ -70,8 +90,16 @@ IPdcSensorProvider *createPdcProvider()
         return new MockPdcSensorProvider;
     }
 
-    qInfo() << "[PDC] Using SocketCAN sensor provider on can0";
-    return new SocketCanPdcProvider(QStringLiteral("can0"));
+    // HU_PDC_CAN_IF=vcan0 — 녹화된 세션(hu_cluster_standin --replay --can-out vcan0) 재생용
+    QString canIf = qEnvironmentVariable("HU_PDC_CAN_IF").trimmed();
+    if (canIf.isEmpty())
+        canIf = QStringLiteral("can0");
+    qInfo() << "[PDC] Using SocketCAN sensor provider on" << canIf;
+    auto *provider = new SocketCanPdcProvider(canIf);
+
+    // HU_PDC_RT_THREAD / _PRIORITY / _CPU / _MLOCK — 전용 CAN 리더 스레드 (RealtimeThread.h)
+    provider->setRealtime(RealtimeThreadConfig::fromEnvironment("HU_PDC_RT"));
+    return provider;
 }
 } // namespace
 
@@ -98,6 +126,10 @@ ShellWindow::ShellWindow(QWidget *parent)
     m_pdcController    = new PdcController(createPdcProvider(), this);
     m_pdcBeep          = new PdcBeepController(this);
 
+    // 연속 신호는 공유 메모리 블록으로 — 실패 시 기존 소켓 브로드캐스트로 대체
+    if (!m_vehicleState.create())
+        qWarning() << "[Shell] shared vehicle state unavailable; broadcasting over sockets";
+
     setupUI();
     setupModules();
     setupConnections();
@@ -201,13 +233,14 @@ void ShellWindow::setupModules()
             this, &ShellWindow::onClusterSurfaceCreated);
 #endif
 
-    // ── 2. 각 모듈: ModuleBridge(IPC 서버) + ModuleController(프로세스 감시) ──
+    // ── 2. 각 모듈: ModuleBridge(IPC 스레드) + ModuleController(프로세스 감시) ──
+    m_bridgeHub = new ModuleBridgeHub(this);
+    m_bridgeHub->setHiddenPolicy(hiddenDeliveryPolicy());
     for (int i = 0; i < MODULE_COUNT; ++i) {
         const QString socketPath =
             QString("/tmp/hu_shell_%1.sock").arg(kModules[i].socketSuffix);
 
-        m_bridges[i] = new ModuleBridge(socketPath, this);
-        if (!m_bridges[i]->listen()) {
+        if (m_bridgeHub->addModule(socketPath, moduleTransport(kModules[i].socketSuffix)) < 0) {
             qWarning() << "[Shell] ModuleBridge failed to listen on" << socketPath;
         }
 
@@ -219,6 +252,8 @@ void ShellWindow::setupModules()
         );
         m_controllers[i]->launch();
     }
+    // 활성 탭 모듈만 즉시 전달 대상 (나머지는 숨김 정책 적용)
+    m_bridgeHub->show(m_activeIndex, moduleGeometry());
 }
 
 void ShellWindow::setupClusterWindow()
@@ -252,33 +287,94 @@ void ShellWindow::setupConnections()
     connect(m_tabBar, &TabBar::tabSelected, this, &ShellWindow::onTabChanged);
     connect(m_gearStateManager, &GearStateManager::gearChanged,
             this, &ShellWindow::onGearChanged);
-    connect(m_pdcController, &PdcController::stateChanged,
-            m_pdcBeep, &PdcBeepController::setPdcState);
+    // 리더 스레드가 경고 단계를 계산하면 경보음은 그것만 따른다 (PdcController 경로는 화면용).
+    // tone engine이 돌면 리더 스레드에서 바로 넘긴다 — CAN → 소리 경로가 GUI 스레드를 거치지 않는다
+    IPdcSensorProvider *pdcProvider = m_pdcController->provider();
+    if (pdcProvider && pdcProvider->publishesWarningLevel()) {
+        connect(pdcProvider, &IPdcSensorProvider::warningLevelChanged,
+                m_pdcBeep, &PdcBeepController::setWarningLevel,
+                m_pdcBeep->acceptsLevelFromAnyThread() ? Qt::DirectConnection : Qt::AutoConnection);
+        // 리더 스레드가 오류로 끝나면 경보음은 PdcController 경로로 돌아간다
+        connect(pdcProvider, &IPdcSensorProvider::warningLevelPublishingChanged,
+                this, [this, pdcProvider](bool publishes) {
+            if (publishes) {
+                return;
+            }
+            disconnect(pdcProvider, &IPdcSensorProvider::warningLevelChanged,
+                       m_pdcBeep, &PdcBeepController::setWarningLevel);
+            connect(m_pdcController, &PdcController::stateChanged,
+                    m_pdcBeep, &PdcBeepController::setPdcState, Qt::UniqueConnection);
+            m_pdcBeep->setPdcState(m_pdcController->state());
+        });
+    } else {
+        connect(m_pdcController, &PdcController::stateChanged,
+                m_pdcBeep, &PdcBeepController::setPdcState);
+    }
+    // tone engine이 죽으면 beep fallback은 GUI 스레드 타이머다 — 리더 스레드 직접 호출을 queued로 되돌린다
+    connect(m_pdcBeep, &PdcBeepController::toneEngineFailed, this, [this, pdcProvider] {
+        if (pdcProvider && disconnect(pdcProvider, &IPdcSensorProvider::warningLevelChanged,
+                                      m_pdcBeep, &PdcBeepController::setWarningLevel)) {
+            connect(pdcProvider, &IPdcSensorProvider::warningLevelChanged,
+                    m_pdcBeep, &PdcBeepController::setWarningLevel, Qt::QueuedConnection);
+        }
+        m_pdcBeep->setPdcState(m_pdcController->state());
+    });
 
-    // ── 차량 속도 → 모든 모듈에 브로드캐스트 ──────────────────────────
+    // ── 차량 속도/배터리 → 공유 상태 블록 + 소켓 브로드캐스트 ──
+    // 블록을 연 모듈(CapSharedVehicleState)은 ModuleBridge가 소켓 전송을 생략한다
     connect(m_vehicleData, &IVehicleDataProvider::speedChanged,
             this, [this](float speed) {
-        broadcastToAllModules([speed](ModuleBridge *b) {
-            b->sendVehicleSpeed(speed);
-        });
+        m_vehicleState.setSpeed(speed);
+        m_bridgeHub->broadcastSpeed(speed);
         if (m_pdcController) {
             m_pdcController->setVehicleSpeed(speed);
         }
     });
 
-    // ── Ambient 모듈 신호 → GlowOverlay ──────────────────────────────
-    connect(m_bridges[IDX_AMBIENT], &ModuleBridge::ambientColorChanged,
-            this, [this](quint8 r, quint8 g, quint8 b, quint8 brightness) {
-        onAmbientColorChanged(r, g, b, brightness);
+    connect(m_vehicleData, &IVehicleDataProvider::batteryChanged,
+            this, [this](float voltage, float percent) {
+        m_vehicleState.setBattery(voltage, percent);
+        m_bridgeHub->broadcastBattery(voltage, percent);
+    });
+    m_vehicleState.setBattery(m_vehicleData->batteryVoltage(), m_vehicleData->batteryPercent());
+    m_vehicleState.setGear(static_cast<quint8>(m_gearStateManager->gear()));
+
+    // ── Ambient 모듈 신호 → GlowOverlay (IPC 스레드에서 최신값으로 합쳐서 전달) ──
+    connect(m_bridgeHub, &ModuleBridgeHub::ambientColorChanged,
+            this, [this](int index, quint8 r, quint8 g, quint8 b, quint8 brightness) {
+        if (index == IDX_AMBIENT)
+            onAmbientColorChanged(r, g, b, brightness);
+    });
+    connect(m_bridgeHub, &ModuleBridgeHub::ambientOff, this, [this](int index) {
+        if (index == IDX_AMBIENT)
+            onAmbientOff();
+    });
+
+    // ── Settings 모듈 설정 변경 → StatusBar 속도 단위 ────────────────
+    connect(m_bridgeHub, &ModuleBridgeHub::settingsChanged,
+            this, [this](int index, const HuProtocol::SettingsDelta &delta) {
+        HuProtocol::SpeedUnit unit;
+        if (index == IDX_SETTINGS && delta.speedUnit(unit))
+            m_statusBar->setMetricUnits(unit == HuProtocol::SpeedUnit::Kmh);
     });
-    connect(m_bridges[IDX_AMBIENT], &ModuleBridge::ambientOff,
-            this, &ShellWindow::onAmbientOff);
 
     // ── 각 모듈의 기어 변경 요청 → GearStateManager ──────────────────
-    for (int i = 0; i < MODULE_COUNT; ++i) {
-        connect(m_bridges[i], &ModuleBridge::gearChangeRequested,
-                this, [this](GearState gear, const QString &source) {
-            m_gearStateManager->setGear(gear, source);
+    connect(m_bridgeHub, &ModuleBridgeHub::gearChangeRequested,
+            this, [this](int, GearState gear, const QString &source) {
+        m_gearStateManager->setGear(gear, source);
+    });
+
+    // 느린 모듈의 숨김 정책 전환은 허브가 IPC 스레드에서 처리한다
+    connect(m_bridgeHub, &ModuleBridgeHub::slowConsumer, this, [](int index, bool slow) {
+        qWarning() << "[Shell] module" << kModules[index].socketSuffix
+                   << (slow ? "is a slow consumer" : "recovered");
+    });
+
+    // ── 클러스터 기어 응답 → 상태바 (응답 전에는 반영을 가정하지 않음) ──
+    if (m_vsomeipClient) {
+        connect(m_vsomeipClient, &VSomeIPClient::gearAckStateChanged,
+                this, [this](GearAckState state, GearState) {
+            m_statusBar->setGearAckState(state);
         });
     }
 
@@ -289,9 +385,8 @@ void ShellWindow::setupConnections()
         const bool connected = m_vsomeipClient && m_vsomeipClient->isConnected();
         if (connected != m_lastIpcStatus) {
             m_lastIpcStatus = connected;
-            broadcastToAllModules([connected](ModuleBridge *b) {
-                b->sendIpcStatus(connected);
-            });
+            m_vehicleState.setIpcStatus(connected);
+            m_bridgeHub->broadcastIpcStatus(connected);
         }
     });
     m_ipcPollTimer->start();
@@ -316,9 +411,15 @@ void ShellWindow::onTabChanged(int index)
 void ShellWindow::switchToModule(int index)
 {
     if (index < 0 || index >= MODULE_COUNT) return;
+    const int previous = m_activeIndex;
     m_activeIndex = index;
     m_tabBar->setCurrentIndex(index);
 
+    // 숨겨지는 모듈은 텔레메트리 합치기 시작, 보이는 모듈은 보관된 최신 상태를 받음
+    if (previous != index)
+        m_bridgeHub->hide(previous);
+    m_bridgeHub->show(index, moduleGeometry());
+
 #ifdef HU_WAYLAND_COMPOSITOR
     // 현재 탭에 해당하는 Wayland surface를 렌더 위젯에 설정
     const QString name = kModules[index].waylandName;
@@ -366,9 +467,9 @@ void ShellWindow::onGearChanged(GearState gear, const QString &source)
         m_vsomeipClient->publishGear(gear);
 
     // 모든 모듈에 기어 상태 브로드캐스트 (GearPanel 업데이트용)
-    broadcastToAllModules([gear](ModuleBridge *b) {
-        b->sendGearState(gear);
-    });
+    // 공유 블록에는 스냅샷용으로만 기록하고, 이벤트는 순서 보장을 위해 소켓으로 보낸다
+    m_vehicleState.setGear(static_cast<quint8>(gear));
+    m_bridgeHub->broadcastGear(gear);
 
     // 후진 기어 → 카메라 창 표시
     const bool isReverse = (static_cast<quint8>(gear) == 1); // GearState::R
@@ -457,10 +558,8 @@ void ShellWindow::pollGamepadGear()
 
 // ── 유틸리티 ─────────────────────────────────────────────────────────────
 
-void ShellWindow::broadcastToAllModules(std::function<void(ModuleBridge *)> fn)
+QRect ShellWindow::moduleGeometry() const
 {
-    for (int i = 0; i < MODULE_COUNT; ++i) {
-        if (m_bridges[i] && m_bridges[i]->isModuleConnected())
-            fn(m_bridges[i]);
-    }
+    // TabBar와 StatusBar 사이의 모듈 콘텐츠 영역
+    return QRect(0, TAB_H, m_screenW, m_screenH - TAB_H - STATUS_H);
 }
@@ -13,11 +13,12 @@
 #ifndef SHELLWINDOW_H
 #define SHELLWINDOW_H
 
+#include "VehicleStateBlock.h"
+
 #include <QMainWindow>
 #include <QTimer>
 #include <QEvent>
 #include <QMouseEvent>
-#include <functional>
 
 class TabBar;
 class StatusBar;
@@ -32,7 +33,7 @@ class HUCompositor;
 class ModuleSurfaceWidget;
 class ClusterOutputWindow;
 class ModuleController;
-class ModuleBridge;
+class ModuleBridgeHub;
 class PdcController;
 class PdcBeepController;
 
@@ -70,7 +71,7 @@ private:
     void setupConnections();
     void setupClusterWindow();
     void switchToModule(int index);
-    void broadcastToAllModules(std::function<void(ModuleBridge *)> fn);
+    QRect moduleGeometry() const;
 
     // ── UI 컴포넌트 ───────────────────────────────────────────────────
     TabBar               *m_tabBar        = nullptr;
@@ -87,13 +88,16 @@ private:
     PdcController        *m_pdcController    = nullptr;
     PdcBeepController    *m_pdcBeep          = nullptr;
 
+    // ── 모듈 공유 차량 상태 (speed/battery/IPC/gear, seqlock shm) ────
+    HuProtocol::VehicleStateBlock m_vehicleState;
+
     // ── Wayland 컴포지터 ──────────────────────────────────────────────
 #ifdef HU_WAYLAND_COMPOSITOR
     HUCompositor         *m_compositor     = nullptr;
     ClusterOutputWindow  *m_clusterWindow  = nullptr;
 #endif
 
-    // ── 멀티프로세스 모듈 관리 (ModuleController + ModuleBridge 쌍) ──
+    // ── 멀티프로세스 모듈 관리 (ModuleController + IPC 스레드의 ModuleBridge) ──
     static constexpr int MODULE_COUNT  = 6;
     static constexpr int IDX_MEDIA     = 0;
     static constexpr int IDX_YOUTUBE   = 1;
@@ -103,7 +107,7 @@ private:
     static constexpr int IDX_SETTINGS  = 5;
 
     ModuleController *m_controllers[MODULE_COUNT] = {};
-    ModuleBridge     *m_bridges[MODULE_COUNT]     = {};
+    ModuleBridgeHub  *m_bridgeHub = nullptr;   // 소켓 I/O는 IPC 스레드에서
 
     int     m_activeIndex    = 0;
     bool    m_lastIpcStatus  = false;
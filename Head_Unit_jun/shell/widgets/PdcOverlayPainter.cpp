@@ -1,11 +1,38 @@
 #include "PdcOverlayPainter.h"
 
-#include <QFont>
+#include "PdcWarning.h"
+
+#include <QPaintDevice>
 #include <QPainter>
 #include <QPainterPath>
 #include <QtMath>
 
+#include <cstring>
+#include <iterator>
+
 namespace {
+struct GuideLine {
+    float yNorm;
+    float topWidthNorm;
+    float bottomWidthNorm;
+    int lineWidth;
+};
+
+// far → critical 순서 (UI_OVERLAY_SPEC §6)
+constexpr GuideLine kGuideLines[] = {
+    { 0.38f, 0.26f, 0.50f, 3 },
+    { 0.54f, 0.38f, 0.68f, 4 },
+    { 0.68f, 0.50f, 0.84f, 5 },
+    { 0.80f, 0.64f, 0.96f, 6 },
+};
+constexpr float kGuideDepthNorm = 0.11f;   // 각 라인의 가로선까지 높이
+constexpr int kMaxLineWidth = 6;
+
+constexpr int kBarBottomOffset = 44;
+constexpr int kBarHeight = 20;
+constexpr int kBarMargin = 18;
+constexpr int kBarGap = 8;
+
 QColor colorForLevel(PdcWarningLevel level, int alpha)
 {
     switch (level) {
@@ -19,23 +46,30 @@ QColor colorForLevel(PdcWarningLevel level, int alpha)
     }
 }
 
-PdcWarningLevel levelForDistance(float distanceCm)
+/** 가이드 라인 색은 tint(= stale이면 Off, 아니면 경고 단계)만으로 정해진다 — layer 캐시의 키 */
+PdcWarningLevel tintFor(const PdcState &state)
+{
+    return state.stale ? PdcWarningLevel::Off : state.warningLevel;
+}
+
+QColor guideColor(int index, PdcWarningLevel tint)
 {
-    if (distanceCm < 0.0f) return PdcWarningLevel::Off;
-    if (distanceCm < 30.0f) return PdcWarningLevel::Critical;
-    if (distanceCm < 60.0f) return PdcWarningLevel::Caution;
-    if (distanceCm < 120.0f) return PdcWarningLevel::Near;
-    return PdcWarningLevel::Far;
+    const bool alertVisible = tint != PdcWarningLevel::Off;
+    switch (index) {
+    case 0: return QColor(45, 220, 120, alertVisible ? 130 : 70);
+    case 1: return QColor(45, 220, 120, alertVisible ? 170 : 80);
+    case 2: return QColor(255, 210, 64, tint >= PdcWarningLevel::Caution ? 220 : 100);
+    default: return QColor(255, 64, 64, tint == PdcWarningLevel::Critical ? 240 : 100);
+    }
 }
 
-void drawGuideLine(QPainter *p, const QRect &r, float yNorm, float topWidthNorm,
-                   float bottomWidthNorm, const QColor &color, int lineWidth)
+void drawGuideLine(QPainter *p, const QRect &r, const GuideLine &line, const QColor &color)
 {
     const float cx = r.center().x();
-    const float y = r.top() + r.height() * yNorm;
-    const float lowerY = y + r.height() * 0.11f;
-    const float topHalf = r.width() * topWidthNorm * 0.5f;
-    const float bottomHalf = r.width() * bottomWidthNorm * 0.5f;
+    const float y = r.top() + r.height() * line.yNorm;
+    const float lowerY = y + r.height() * kGuideDepthNorm;
+    const float topHalf = r.width() * line.topWidthNorm * 0.5f;
+    const float bottomHalf = r.width() * line.bottomWidthNorm * 0.5f;
 
     QPainterPath path;
     path.moveTo(cx - topHalf, y);
@@ -49,7 +83,8 @@ void drawGuideLine(QPainter *p, const QRect &r, float yNorm, float topWidthNorm,
     path.moveTo(cx - bottomHalf, lowerY);
     path.lineTo(cx + bottomHalf, lowerY);
 
-    p->setPen(QPen(color, lineWidth, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
+    p->setPen(QPen(color, line.lineWidth, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
+    p->setBrush(Qt::NoBrush);
     p->drawPath(path);
 }
 
@@ -58,75 +93,207 @@ float intensityForDistance(float distanceCm)
     if (distanceCm < 0.0f) return 0.0f;
     return qBound(0.0f, (150.0f - distanceCm) / 120.0f, 1.0f);
 }
+
+// ── 레이아웃 (rect 기준) ──────────────────────────────────
+
+QRect pillRect(const QRect &rect)
+{
+    return QRect(rect.center().x() - 76, rect.bottom() - 82, 152, 28);
+}
+
+QRect faultRect(const QRect &rect)
+{
+    return QRect(rect.left() + 12, rect.top() + 10, rect.width() - 24, 20);
 }
 
-void PdcOverlayPainter::paint(QPainter *painter, const QRect &rect, const PdcState &state)
+QRect barRect(const QRect &rect, int index)
+{
+    const int barW = (rect.width() - kBarMargin * 2 - kBarGap * (kPdcSensorCount - 1)) / kPdcSensorCount;
+    return QRect(rect.left() + kBarMargin + index * (barW + kBarGap),
+                 rect.bottom() - kBarBottomOffset, barW, kBarHeight);
+}
+
+/** 가이드 라인 4개 + pill 배경을 모두 덮는 영역 (round cap / antialias 여유 포함) */
+QRect guideBounds(const QRect &rect)
+{
+    const GuideLine &first = kGuideLines[0];
+    const GuideLine &last = kGuideLines[std::size(kGuideLines) - 1];
+    const float halfWidth = rect.width() * last.bottomWidthNorm * 0.5f;
+    const QRectF lines(rect.center().x() - halfWidth,
+                       rect.top() + rect.height() * first.yNorm,
+                       halfWidth * 2.0f,
+                       rect.height() * (last.yNorm + kGuideDepthNorm - first.yNorm));
+    const qreal pad = kMaxLineWidth * 0.5 + 1.0;
+    return (lines.adjusted(-pad, -pad, pad, pad).toAlignedRect() | pillRect(rect)) & rect;
+}
+
+/** 센서 bar 색 — changedRects와 paint가 같은 식을 쓴다 */
+QColor barFill(const PdcState &state, int index)
+{
+    if (!state.rear.isValid(index) || state.stale)
+        return QColor(120, 120, 120, 80);
+    const float distance = state.rear.distanceCm[index];
+    const int alpha = 70 + static_cast<int>(intensityForDistance(distance) * 165.0f);
+    return colorForLevel(PdcWarning::levelForDistance(distance), alpha);
+}
+
+int pillDistanceKey(const PdcState &state)
+{
+    if (state.stale)
+        return -2;
+    return state.nearestDistanceCm >= 0.0f ? qRound(state.nearestDistanceCm) : -1;
+}
+
+void drawPillBackground(QPainter *p, const QRect &rect)
+{
+    p->setPen(Qt::NoPen);
+    p->setBrush(QColor(0, 0, 0, 145));
+    p->drawRoundedRect(pillRect(rect), 6, 6);
+}
+
+/** bar의 1 px 테두리 + antialias가 번지는 만큼 */
+QRect barDirtyRect(const QRect &rect, int index)
+{
+    return barRect(rect, index).adjusted(-2, -2, 2, 2);
+}
+}
+
+void PdcOverlayPainter::invalidateLayers()
+{
+    for (QPixmap &layer : m_layers)
+        layer = QPixmap();
+    m_layerSize = QSize();
+    m_layerDpr = 0.0;
+}
+
+const QPixmap &PdcOverlayPainter::guideLayer(PdcWarningLevel tint, const QRect &rect, qreal dpr)
+{
+    if (rect.size() != m_layerSize || !qFuzzyCompare(dpr, m_layerDpr)) {
+        invalidateLayers();
+        m_layerSize = rect.size();
+        m_layerDpr = dpr;
+    }
+
+    QPixmap &layer = m_layers[static_cast<size_t>(tint)];
+    if (!layer.isNull())
+        return layer;
+
+    // rect 원점 기준으로 그리고 bounds만큼만 잘라 보관 — 그릴 때는 bounds 위치에 1:1 blit
+    const QRect local(QPoint(0, 0), rect.size());
+    const QRect bounds = guideBounds(local);
+    layer = QPixmap(bounds.size() * dpr);
+    layer.setDevicePixelRatio(dpr);
+    layer.fill(Qt::transparent);
+
+    QPainter p(&layer);
+    p.setRenderHint(QPainter::Antialiasing, true);
+    p.translate(-bounds.topLeft());
+    for (int i = 0; i < static_cast<int>(std::size(kGuideLines)); ++i)
+        drawGuideLine(&p, local, kGuideLines[i], guideColor(i, tint));
+    drawPillBackground(&p, local);
+    return layer;
+}
+
+void PdcOverlayPainter::paint(QPainter *painter, const QRect &rect, const PdcState &state,
+                              const QRect &exposed)
 {
     if (!painter || !state.active) {
         return;
     }
 
+    const auto visible = [&exposed](const QRect &r) {
+        return exposed.isEmpty() || exposed.intersects(r);
+    };
+
     painter->save();
     painter->setRenderHint(QPainter::Antialiasing, true);
 
-    const bool alertVisible = !state.stale && state.warningLevel != PdcWarningLevel::Off;
-    drawGuideLine(painter, rect, 0.38f, 0.26f, 0.50f,
-                  QColor(45, 220, 120, alertVisible ? 130 : 70), 3);
-    drawGuideLine(painter, rect, 0.54f, 0.38f, 0.68f,
-                  QColor(45, 220, 120, alertVisible ? 170 : 80), 4);
-    const int level = static_cast<int>(state.warningLevel);
-    drawGuideLine(painter, rect, 0.68f, 0.50f, 0.84f,
-                  QColor(255, 210, 64, level >= static_cast<int>(PdcWarningLevel::Caution) ? 220 : 100), 5);
-    drawGuideLine(painter, rect, 0.80f, 0.64f, 0.96f,
-                  QColor(255, 64, 64, state.warningLevel == PdcWarningLevel::Critical ? 240 : 100), 6);
-
-    const int sectorCount = qMax(4, state.rearSensors.size());
-    const int barY = rect.bottom() - 44;
-    const int margin = 18;
-    const int gap = 8;
-    const int barW = (rect.width() - margin * 2 - gap * (sectorCount - 1)) / sectorCount;
-    for (int i = 0; i < sectorCount; ++i) {
-        QRect bar(rect.left() + margin + i * (barW + gap), barY, barW, 20);
-        QColor fill(120, 120, 120, 80);
-        if (i < state.rearSensors.size() && state.rearSensors.at(i).valid && !state.stale) {
-            const float distance = state.rearSensors.at(i).distanceCm;
-            const int alpha = 70 + static_cast<int>(intensityForDistance(distance) * 165.0f);
-            fill = colorForLevel(levelForDistance(distance), alpha);
+    const QRect bounds = guideBounds(rect);
+    if (visible(bounds)) {
+        const PdcWarningLevel tint = tintFor(state);
+        if (m_cacheEnabled) {
+            const qreal dpr = painter->device() ? painter->device()->devicePixelRatioF() : 1.0;
+            painter->drawPixmap(bounds.topLeft(), guideLayer(tint, rect, dpr));
+        } else {
+            for (int i = 0; i < static_cast<int>(std::size(kGuideLines)); ++i)
+                drawGuideLine(painter, rect, kGuideLines[i], guideColor(i, tint));
+            drawPillBackground(painter, rect);
         }
+    }
 
-        painter->setPen(QPen(QColor(0, 0, 0, 130), 1));
-        painter->setBrush(fill);
+    painter->setPen(QPen(QColor(0, 0, 0, 130), 1));
+    for (int i = 0; i < kPdcSensorCount; ++i) {
+        const QRect bar = barRect(rect, i);
+        if (!visible(barDirtyRect(rect, i)))
+            continue;
+        painter->setBrush(barFill(state, i));
         painter->drawRoundedRect(bar, 4, 4);
     }
 
-    QRect pill(rect.center().x() - 76, rect.bottom() - 82, 152, 28);
-    painter->setPen(Qt::NoPen);
-    painter->setBrush(QColor(0, 0, 0, 145));
-    painter->drawRoundedRect(pill, 6, 6);
-
-    QFont font = painter->font();
-    font.setPointSize(10);
-    font.setBold(true);
-    painter->setFont(font);
-    painter->setPen(colorForLevel(state.warningLevel, state.stale ? 130 : 255));
-
-    QString label = QStringLiteral("PDC --");
-    if (state.stale) {
-        label = QStringLiteral("PDC STALE");
-    } else if (state.nearestDistanceCm >= 0.0f) {
-        label = QStringLiteral("PDC %1 cm").arg(qRound(state.nearestDistanceCm));
+    if (!m_fontsReady) {
+        m_labelFont = painter->font();
+        m_labelFont.setPointSize(10);
+        m_labelFont.setBold(true);
+        m_faultFont = painter->font();
+        m_faultFont.setPointSize(8);
+        m_faultFont.setBold(false);
+        m_fontsReady = true;
     }
-    painter->drawText(pill, Qt::AlignCenter, label);
 
-    if (!state.fault.isEmpty()) {
-        font.setPointSize(8);
-        font.setBold(false);
-        painter->setFont(font);
+    const QRect pill = pillRect(rect);
+    if (visible(pill)) {
+        painter->setFont(m_labelFont);
+        painter->setPen(colorForLevel(state.warningLevel, state.stale ? 130 : 255));
+
+        QString label = QStringLiteral("PDC --");
+        if (state.stale) {
+            label = QStringLiteral("PDC STALE");
+        } else if (state.nearestDistanceCm >= 0.0f) {
+            label = QStringLiteral("PDC %1 cm").arg(qRound(state.nearestDistanceCm));
+        }
+        painter->drawText(pill, Qt::AlignCenter, label);
+    }
+
+    const QRect fault = faultRect(rect);
+    if (state.hasFault() && visible(fault)) {
+        painter->setFont(m_faultFont);
         painter->setPen(QColor(255, 210, 64, 210));
-        painter->drawText(QRect(rect.left() + 12, rect.top() + 10, rect.width() - 24, 20),
-                          Qt::AlignLeft | Qt::AlignVCenter,
-                          state.fault);
+        painter->drawText(fault, Qt::AlignLeft | Qt::AlignVCenter, QString::fromUtf8(state.fault.data()));
     }
 
     painter->restore();
 }
+
+int PdcOverlayPainter::changedRects(const QRect &rect, const PdcState &before, const PdcState &after,
+                                    ChangedRects *out)
+{
+    int count = 0;
+    if (!before.active && !after.active)
+        return count;
+    if (before.active != after.active) {
+        (*out)[count++] = rect;
+        return count;
+    }
+
+    // guideBounds는 pill을 포함한다 — tint가 바뀌면 pill은 따로 넣지 않는다
+    const bool tintChanged = tintFor(before) != tintFor(after);
+    if (tintChanged)
+        (*out)[count++] = guideBounds(rect);
+
+    for (int i = 0; i < kPdcSensorCount; ++i) {
+        if (barFill(before, i) != barFill(after, i))
+            (*out)[count++] = barDirtyRect(rect, i);
+    }
+
+    if (!tintChanged
+        && (pillDistanceKey(before) != pillDistanceKey(after)
+            || colorForLevel(before.warningLevel, before.stale ? 130 : 255)
+                   != colorForLevel(after.warningLevel, after.stale ? 130 : 255))) {
+        (*out)[count++] = pillRect(rect);
+    }
+
+    if (std::strcmp(before.fault.data(), after.fault.data()) != 0)
+        (*out)[count++] = faultRect(rect);
+
+    return count;
+}
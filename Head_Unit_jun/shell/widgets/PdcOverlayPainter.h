@@ -3,14 +3,53 @@
 
 #include "PdcTypes.h"
 
+#include <QFont>
+#include <QPixmap>
 #include <QRect>
 
+#include <array>
+
 class QPainter;
 
+/**
+ * 후방 카메라 위 PDC overlay.
+ *
+ * 정적인 부분(가이드 라인 4개, 거리 pill 배경)은 크기별로 미리 그린 layer를 warning level tint마다
+ * 하나씩 캐시하고, 매 갱신에는 센서 bar 4개와 거리 라벨만 그린다.
+ * changedRects()는 두 상태 사이에 실제로 달라지는 사각형만 고정 배열에 채운다 — ReverseCameraWindow가
+ * 사각형마다 update(QRect)로 부분 갱신에 쓴다 (50 Hz 경로라 QRegion 힙 할당을 피한다).
+ */
 class PdcOverlayPainter
 {
 public:
-    static void paint(QPainter *painter, const QRect &rect, const PdcState &state);
+    /** exposed가 비어 있지 않으면 그 영역과 겹치는 요소만 그린다 (paintEvent의 dirty rect) */
+    void paint(QPainter *painter, const QRect &rect, const PdcState &state,
+               const QRect &exposed = QRect());
+
+    /** 가이드 영역 + 센서 bar + pill + fault */
+    static constexpr int kMaxChangedRects = 1 + kPdcSensorCount + 2;
+    using ChangedRects = std::array<QRect, kMaxChangedRects>;
+
+    /** before → after로 바뀔 때 다시 그려야 하는 사각형을 out에 채운다. @return 채운 개수 (0이면 변화 없음) */
+    static int changedRects(const QRect &rect, const PdcState &before, const PdcState &after,
+                            ChangedRects *out);
+
+    /** false면 가이드 라인을 매번 직접 그린다 — 렌더링 벤치마크 비교용 */
+    void setLayerCacheEnabled(bool enabled) { m_cacheEnabled = enabled; }
+    void invalidateLayers();
+
+private:
+    static constexpr int kTintCount = 5;   // PdcWarningLevel 수
+
+    const QPixmap &guideLayer(PdcWarningLevel tint, const QRect &rect, qreal dpr);
+
+    std::array<QPixmap, kTintCount> m_layers;
+    QSize m_layerSize;
+    qreal m_layerDpr = 0.0;
+    bool m_cacheEnabled = true;
+    QFont m_labelFont;
+    QFont m_faultFont;
+    bool m_fontsReady = false;
 };
 
 #endif // PDCOVERLAYPAINTER_H
@@ -1,185 +1,209 @@
 /* ReverseCameraWindow.cpp
-   FINAL VERSION
-   Distance + OEM Lines + 3 Side Dots + Red Alert Blink/Vibration
+   Rear camera preview (libcamerasrc → appsink) with PDC overlay.
+   No camera / no GStreamer → placeholder background, overlay still drawn.
 */
 
 #include "ReverseCameraWindow.h"
-<<<<<<< HEAD
-#include <QtCore>
-#include <QtGui>
-=======
-#include "PdcOverlayPainter.h"
 
 #include <QDebug>
 #include <QFont>
 #include <QLinearGradient>
->>>>>>> ba084d4c6dd0091142b57ddc316ddcfc82a2794b
 #include <QPainter>
-#include <QFont>
+#include <QTimer>
+
+#include <cstring>
+
+#ifdef HU_CAMERA_PREVIEW_AVAILABLE
+#include <gst/gst.h>
+#include <gst/app/gstappsink.h>
+#endif
+
+namespace {
+constexpr int kFrameWidth = 640;
+constexpr int kFrameHeight = 400;
+constexpr int kFramePollMs = 33;           // ~30 fps
+constexpr int kNoFrameLimit = 30;          // ~1 s 동안 프레임이 없으면 placeholder
+}
 
 ReverseCameraWindow::ReverseCameraWindow(QWidget *parent)
     : QWidget(parent)
 {
-    setWindowFlags(Qt::FramelessWindowHint);
-    setFixedSize(640, 400);
-    setAttribute(Qt::WA_TranslucentBackground);
+    setWindowTitle("Rear View");
+    setWindowFlags(Qt::Window | Qt::FramelessWindowHint);
+    setFixedSize(kFrameWidth, kFrameHeight);
+    buildPlaceholderPixmap();
+
+    m_frameTimer = new QTimer(this);
+    m_frameTimer->setInterval(kFramePollMs);
+    connect(m_frameTimer, &QTimer::timeout, this, [this] { pullFrame(); });
+
+    if (startCameraPreview()) {
+        m_frameTimer->start();
+    }
 }
 
 ReverseCameraWindow::~ReverseCameraWindow()
 {
+    stopCameraPreview();
 }
 
-<<<<<<< HEAD
-void ReverseCameraWindow::setDistance(int cm)
-=======
 void ReverseCameraWindow::setPdcState(const PdcState &state)
 {
+    // 비활성 상태끼리의 변화나 화면에 안 보이는 값(dataAgeUs 등)만 바뀐 경우는 0개
+    PdcOverlayPainter::ChangedRects dirty;
+    const int count = PdcOverlayPainter::changedRects(rect(), m_pdcState, state, &dirty);
     m_pdcState = state;
-    update();
+    for (int i = 0; i < count; ++i) {
+        update(dirty[i]);
+    }
 }
 
 bool ReverseCameraWindow::startCameraPreview()
->>>>>>> ba084d4c6dd0091142b57ddc316ddcfc82a2794b
 {
-    if (cm < 0) cm = 0;
-    if (cm > 999) cm = 999;
+#ifdef HU_CAMERA_PREVIEW_AVAILABLE
+    if (!gst_is_initialized()) {
+        gst_init(nullptr, nullptr);
+    }
+
+    GError *error = nullptr;
+    const QByteArray launch = QStringLiteral(
+        "libcamerasrc ! videoconvert ! videoscale ! "
+        "video/x-raw,format=BGRx,width=%1,height=%2 ! "
+        "appsink name=sink max-buffers=1 drop=true sync=false")
+        .arg(kFrameWidth).arg(kFrameHeight).toLatin1();
+    GstElement *pipeline = gst_parse_launch(launch.constData(), &error);
+    if (!pipeline || error) {
+        qWarning() << "[Camera] pipeline error:" << (error ? error->message : "unknown");
+        if (error) g_error_free(error);
+        if (pipeline) gst_object_unref(pipeline);
+        return false;
+    }
+
+    GstElement *sink = gst_bin_get_by_name(GST_BIN(pipeline), "sink");
+    if (!sink || gst_element_set_state(pipeline, GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
+        qWarning() << "[Camera] libcamerasrc failed to start - placeholder only";
+        if (sink) gst_object_unref(sink);
+        gst_element_set_state(pipeline, GST_STATE_NULL);
+        gst_object_unref(pipeline);
+        return false;
+    }
 
-    m_distance = cm;
-    update();
+    m_pipeline = pipeline;
+    m_appsink = sink;
+    qDebug() << "[Camera] preview started";
+    return true;
+#else
+    return false;
+#endif
 }
 
-void ReverseCameraWindow::paintEvent(QPaintEvent *event)
+void ReverseCameraWindow::stopCameraPreview()
 {
-    Q_UNUSED(event)
+    if (m_frameTimer) {
+        m_frameTimer->stop();
+    }
+#ifdef HU_CAMERA_PREVIEW_AVAILABLE
+    if (m_pipeline) {
+        gst_element_set_state(static_cast<GstElement *>(m_pipeline), GST_STATE_NULL);
+    }
+    if (m_appsink) {
+        gst_object_unref(m_appsink);
+    }
+    if (m_pipeline) {
+        gst_object_unref(m_pipeline);
+    }
+#endif
+    m_pipeline = nullptr;
+    m_appsink = nullptr;
+}
 
-    static bool blink = false;
-    blink = !blink;
+void ReverseCameraWindow::pullFrame()
+{
+#ifdef HU_CAMERA_PREVIEW_AVAILABLE
+    GstSample *sample = m_appsink
+        ? gst_app_sink_try_pull_sample(GST_APP_SINK(m_appsink), 0)
+        : nullptr;
+    if (!sample) {
+        if (++m_noFrameCount == kNoFrameLimit) {
+            m_showPlaceholder = true;
+            update();
+        }
+        return;
+    }
 
+    int width = kFrameWidth;
+    int height = kFrameHeight;
+    if (GstCaps *caps = gst_sample_get_caps(sample)) {
+        const GstStructure *s = gst_caps_get_structure(caps, 0);
+        gst_structure_get_int(s, "width", &width);
+        gst_structure_get_int(s, "height", &height);
+    }
+
+    GstBuffer *buffer = gst_sample_get_buffer(sample);
+    GstMapInfo map;
+    if (buffer && height > 0 && gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+        // 크기가 같으면 기존 QImage 버퍼에 행 단위로 복사 — 프레임마다 새로 할당하지 않는다
+        if (m_frame.width() != width || m_frame.height() != height) {
+            m_frame = QImage(width, height, QImage::Format_RGB32);
+        }
+        const int stride = static_cast<int>(map.size) / height;
+        const int rowBytes = qMin(stride, width * 4);
+        for (int y = 0; y < height; ++y) {
+            std::memcpy(m_frame.scanLine(y), map.data + y * stride, static_cast<size_t>(rowBytes));
+        }
+        gst_buffer_unmap(buffer, &map);
+        m_showPlaceholder = false;
+        m_noFrameCount = 0;
+        update();
+    }
+    gst_sample_unref(sample);
+#endif
+}
+
+void ReverseCameraWindow::paintEvent(QPaintEvent *event)
+{
+    // PDC 갱신은 사각형별 update(rect)로 들어온다 — 배경도 노출된 사각형만 다시 그린다
     QPainter p(this);
-    p.setRenderHint(QPainter::Antialiasing, true);
-
-    const int leftPanel = 95;
-    const int x0 = leftPanel;
-    const int w  = width() - leftPanel;
-    const int cx = x0 + w / 2;
-
-    // ============================================
-    // DISTANCE COLOR
-    // ============================================
-    QColor distColor;
-
-    if (m_distance > 80)
-        distColor = QColor(0,255,120);
-    else if (m_distance > 40)
-        distColor = QColor(255,210,0);
-    else
-<<<<<<< HEAD
-        distColor = blink ? QColor(255,0,0) : QColor(255,80,80);
-
-    // ============================================
-    // DISTANCE BOX
-    // ============================================
-    p.setBrush(QColor(0,0,0,150));
-    p.setPen(QPen(QColor(255,255,255,70),1));
-    p.drawRoundedRect(cx-90,18,180,52,12,12);
+    const bool showFrame = !m_showPlaceholder && !m_frame.isNull();
+    if (showFrame && m_frame.size() != size()) {
+        p.drawImage(rect(), m_frame);
+    } else {
+        for (const QRect &r : event->region()) {
+            if (showFrame)
+                p.drawImage(r, m_frame, r);
+            else
+                p.drawPixmap(r, m_placeholder, r);
+        }
+    }
 
-    QFont font;
-    font.setPointSize(10);
-    p.setFont(font);
-    p.setPen(Qt::white);
-    p.drawText(QRect(cx-90,26,180,14),
-               Qt::AlignCenter,
-               "DISTANCE");
-
-    font.setPointSize(20);
-    font.setBold(true);
-    p.setFont(font);
-    p.setPen(distColor);
-    p.drawText(QRect(cx-90,42,180,22),
-               Qt::AlignCenter,
-               QString::number(m_distance) + " cm");
-=======
-        p.drawPixmap(0, 0, m_placeholder);
-
-    PdcOverlayPainter::paint(&p, rect(), m_pdcState);
+    m_overlay.paint(&p, rect(), m_pdcState, event->rect());
 }
 
 void ReverseCameraWindow::buildPlaceholderPixmap()
 {
-    m_placeholder = QPixmap(640, 400);
+    m_placeholder = QPixmap(kFrameWidth, kFrameHeight);
 
     QPainter p(&m_placeholder);
     p.setRenderHint(QPainter::Antialiasing);
->>>>>>> ba084d4c6dd0091142b57ddc316ddcfc82a2794b
-
-    // ============================================
-    // OEM PARKING LINES
-    // ============================================
-    p.setPen(QPen(QColor(255,0,0),6));
-    p.drawLine(cx-220,305, cx+220,305);
-    p.drawLine(cx-220,305, cx-250,340);
-    p.drawLine(cx+220,305, cx+250,340);
-
-    p.setPen(QPen(QColor(255,230,0),5));
-    p.drawLine(cx-170,240, cx+170,240);
-    p.drawLine(cx-220,305, cx-170,240);
-    p.drawLine(cx+220,305, cx+170,240);
-
-    p.drawLine(cx-110,170, cx+110,170);
-    p.drawLine(cx-170,240, cx-110,170);
-    p.drawLine(cx+170,240, cx+110,170);
-
-    p.setPen(QPen(QColor(255,255,255,180),2,Qt::DashLine));
-    p.drawLine(cx,160,cx,340);
-
-<<<<<<< HEAD
-    // ============================================
-    // 3 SIDE SENSOR DOTS EACH SIDE
-    // ============================================
-    int activeDots = 1;
-=======
-    font.setPointSize(10); font.setBold(false);
-    p.setFont(font); p.setPen(QColor(100, 110, 120));
-    p.drawText(QRect(0, 58, 640, 24), Qt::AlignCenter, "Placeholder - No camera connected");
->>>>>>> ba084d4c6dd0091142b57ddc316ddcfc82a2794b
 
-    if (m_distance > 100) activeDots = 1;
-    else if (m_distance > 60) activeDots = 2;
-    else activeDots = 3;
+    // Dark gradient (night-vision / backup cam style)
+    QLinearGradient grad(0, 0, kFrameWidth, kFrameHeight);
+    grad.setColorAt(0, QColor(15, 18, 22));
+    grad.setColorAt(0.5, QColor(25, 30, 35));
+    grad.setColorAt(1, QColor(12, 15, 18));
+    p.fillRect(m_placeholder.rect(), grad);
 
-    for (int i = 0; i < 3; i++)
-    {
-        QColor dotColor;
-
-        if (i < activeDots)
-            dotColor = distColor;
-        else
-            dotColor = QColor(80,80,80,130);
-
-        p.setBrush(dotColor);
-        p.setPen(Qt::NoPen);
-
-        int y = 185 + i * 36;
-
-        int offset = 0;
-
-        // red danger vibration effect
-        if (m_distance <= 40 && blink)
-            offset = (i % 2 == 0) ? 2 : -2;
+    QFont font;
+    font.setPointSize(18); font.setBold(true);
+    p.setFont(font); p.setPen(QColor(0, 212, 170));
+    p.drawText(QRect(0, 20, kFrameWidth, 40), Qt::AlignCenter, "REAR VIEW");
 
-        p.drawEllipse(x0 + 8 + offset, y, 14, 14);
-        p.drawEllipse(width() - 24 + offset, y, 14, 14);
-    }
+    font.setPointSize(10); font.setBold(false);
+    p.setFont(font); p.setPen(QColor(100, 110, 120));
+    p.drawText(QRect(0, 58, kFrameWidth, 24), Qt::AlignCenter, "Placeholder - No camera connected");
 
-    // ============================================
-    // FOOTER
-    // ============================================
-    font.setPointSize(9);
-    font.setBold(false);
-    p.setFont(font);
-    p.setPen(QColor(255,255,255,220));
-
-    p.drawText(QRect(x0,376,w,18),
-               Qt::AlignCenter,
-               "Check surroundings before reversing");
-}
\ No newline at end of file
+    // Simulated ground / bumper at bottom
+    p.setPen(Qt::NoPen);
+    p.setBrush(QColor(40, 45, 50));
+    p.drawRect(0, 340, kFrameWidth, 60);
+}
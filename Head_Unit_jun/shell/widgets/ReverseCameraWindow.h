@@ -1,17 +1,25 @@
 #ifndef REVERSECAMERAWINDOW_H
 #define REVERSECAMERAWINDOW_H
 
+#include "PdcOverlayPainter.h"
 #include "PdcTypes.h"
 
+#include <QImage>
+#include <QPixmap>
 #include <QWidget>
 #include <QPaintEvent>
 
+class QTimer;
+
 class ReverseCameraWindow : public QWidget
 {
 public:
     explicit ReverseCameraWindow(QWidget *parent = nullptr);
     ~ReverseCameraWindow() override;
 
+    /** PdcController::stateChanged — 값 복사 후 overlay에서 실제로 바뀐 사각형만 update(rect) */
+    void setPdcState(const PdcState &state);
+
 protected:
     void paintEvent(QPaintEvent *event) override;
 
@@ -19,12 +27,15 @@ private:
     void buildPlaceholderPixmap();
     bool startCameraPreview();
     void stopCameraPreview();
+    void pullFrame();
 
     QPixmap m_placeholder;
     bool    m_showPlaceholder = true;
     QImage  m_frame;
     QTimer *m_frameTimer  = nullptr;
     int     m_noFrameCount = 0;
+    PdcState m_pdcState;
+    PdcOverlayPainter m_overlay;
 
     // GstElement* stored as void* to keep GStreamer headers out of .h
     void *m_pipeline = nullptr;
@@ -6,7 +6,6 @@
  */
 
 #include "StatusBar.h"
-#include "IVehicleDataProvider.h"
 #include "GearStateManager.h"
 #include <QTimer>
 
@@ -43,17 +42,48 @@ StatusBar::StatusBar(IVehicleDataProvider *vehicleData, GearStateManager *gearSt
     QTimer::singleShot(0, this, &StatusBar::updateDisplay);
 }
 
+void StatusBar::setMetricUnits(bool metric)
+{
+    if (m_metric == metric) return;
+    m_metric = metric;
+    updateDisplay();
+}
+
+void StatusBar::setGearAckState(GearAckState state)
+{
+    if (m_gearAck == state) return;
+    m_gearAck = state;
+    updateDisplay();
+}
+
 void StatusBar::updateDisplay()
 {
+    const char *unit = m_metric ? "km/h" : "mph";
     if (m_vehicleData->isConnected()) {
-        m_speedLabel->setText(QString("◉ %1 km/h").arg(m_vehicleData->speed(), 0, 'f', 1));
+        const float speed = m_metric ? m_vehicleData->speed() : m_vehicleData->speed() * 0.621371f;
+        m_speedLabel->setText(QString("◉ %1 %2").arg(speed, 0, 'f', 1).arg(unit));
         m_speedLabel->setStyleSheet("color: #34C759;");
     } else {
-        m_speedLabel->setText("✕ --- km/h");
+        m_speedLabel->setText(QString("✕ --- %1").arg(unit));
         m_speedLabel->setStyleSheet("color: #FF4757;");
     }
 
-    m_gearLabel->setText(QString("[Gear: %1]").arg(gearToString(m_gearState->gear())));
+    // 클러스터가 응답하기 전에는 반영됐다고 가정하지 않는다
+    const QString gear = gearToString(m_gearState->gear());
+    switch (m_gearAck) {
+    case GearAckState::Pending:
+        m_gearLabel->setText(QString("[Gear: %1 …]").arg(gear));
+        m_gearLabel->setStyleSheet("color: #8E8E93;");
+        break;
+    case GearAckState::Failed:
+        m_gearLabel->setText(QString("[Gear: %1 ✕ IC]").arg(gear));
+        m_gearLabel->setStyleSheet("color: #FF4757;");
+        break;
+    default:
+        m_gearLabel->setText(QString("[Gear: %1]").arg(gear));
+        m_gearLabel->setStyleSheet(QString());
+        break;
+    }
 
     m_ipcLabel->setText(m_vehicleData->isConnected() ? "◉ IPC Connected" : "✕ IPC Unavailable");
     m_ipcLabel->setStyleSheet(m_vehicleData->isConnected() ? "color: #34C759;" : "color: #FF4757;");
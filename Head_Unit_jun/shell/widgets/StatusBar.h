@@ -12,7 +12,8 @@
 #include <QLabel>
 #include <QHBoxLayout>
 
-class IVehicleDataProvider;
+#include "IVehicleDataProvider.h"
+
 class GearStateManager;
 
 class StatusBar : public QWidget
@@ -24,6 +25,12 @@ public:
                       GearStateManager *gearState,
                       QWidget *parent = nullptr);
 
+public slots:
+    /** Settings 모듈의 속도 단위 (true = km/h, false = mph) */
+    void setMetricUnits(bool metric);
+    /** 클러스터 기어 응답 상태 — Pending/Failed면 기어 옆에 표시 */
+    void setGearAckState(GearAckState state);
+
 private slots:
     void updateDisplay();
 
@@ -34,6 +41,8 @@ private:
     QLabel *m_gearLabel;
     QLabel *m_ipcLabel;
     bool m_pendingUpdate = false;
+    bool m_metric = true;
+    GearAckState m_gearAck = GearAckState::Idle;
 };
 
 #endif // STATUSBAR_H